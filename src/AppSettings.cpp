@@ -0,0 +1,396 @@
+#include "AppSettings.h"
+#include "Logger.h"
+#include "SettingsStore.h"
+#include <QStandardPaths>
+#include <iterator>
+
+namespace
+{
+enum class SettingType
+{
+    Bool,
+    Int,
+    Double,
+    String
+};
+
+// Moves one setting between AppSettings and its stored value. The stored
+// value handed to load() is already validated and of the spec's type.
+struct SettingField
+{
+    void (*load)(AppSettings &settings, const QVariant &value);
+    QVariant (*save)(const AppSettings &settings);
+};
+
+struct SettingSpec
+{
+    const char *key;
+    SettingType type;
+    double defaultNumber; // Bool, Int and Double
+    const char *defaultString;
+    double min;
+    double max;
+    // String settings: accepted values, nullptr-terminated; nullptr accepts anything
+    const char *const *choices;
+    SettingField field;
+};
+
+constexpr SettingSpec boolSetting(const char *key, bool defaultValue, SettingField field)
+{
+    return {key, SettingType::Bool, defaultValue ? 1.0 : 0.0, nullptr, 0, 1, nullptr, field};
+}
+
+constexpr SettingSpec intSetting(const char *key, int defaultValue, int min, int max, SettingField field)
+{
+    return {key, SettingType::Int, double(defaultValue), nullptr, double(min), double(max), nullptr, field};
+}
+
+constexpr SettingSpec doubleSetting(const char *key, double defaultValue, double min, double max, SettingField field)
+{
+    return {key, SettingType::Double, defaultValue, nullptr, min, max, nullptr, field};
+}
+
+constexpr SettingSpec stringSetting(const char *key, const char *defaultValue, SettingField field, const char *const *choices = nullptr)
+{
+    return {key, SettingType::String, 0, defaultValue, 0, 0, choices, field};
+}
+
+void assign(bool &member, const QVariant &value) { member = value.toBool(); }
+void assign(int &member, const QVariant &value) { member = value.toInt(); }
+void assign(double &member, const QVariant &value) { member = value.toDouble(); }
+// Gate thresholds and times are stored as whole dB and ms
+void assign(float &member, const QVariant &value) { member = static_cast<float>(value.toInt()); }
+void assign(QString &member, const QVariant &value) { member = value.toString(); }
+void assign(std::string &member, const QVariant &value) { member = value.toString().toStdString(); }
+
+QVariant stored(bool member) { return member; }
+QVariant stored(int member) { return member; }
+QVariant stored(double member) { return member; }
+QVariant stored(float member) { return qRound(member); }
+QVariant stored(const QString &member) { return member; }
+QVariant stored(const std::string &member) { return QString::fromStdString(member); }
+
+// A member of AppSettings
+template <auto Member>
+constexpr SettingField field()
+{
+    return {[](AppSettings &settings, const QVariant &value)
+            { assign(settings.*Member, value); },
+            [](const AppSettings &settings) -> QVariant
+            { return stored(settings.*Member); }};
+}
+
+// A member of one of its groups, e.g. AppSettings::encoding
+template <auto Group, auto Member>
+constexpr SettingField field()
+{
+    return {[](AppSettings &settings, const QVariant &value)
+            { assign(settings.*Group.*Member, value); },
+            [](const AppSettings &settings) -> QVariant
+            { return stored(settings.*Group.*Member); }};
+}
+
+// A 0..1 volume, stored as a percentage
+template <auto Group, auto Member>
+constexpr SettingField percentField()
+{
+    return {[](AppSettings &settings, const QVariant &value)
+            { settings.*Group.*Member = value.toInt() / 100.0f; },
+            [](const AppSettings &settings) -> QVariant
+            { return qRound(settings.*Group.*Member * 100.0f); }};
+}
+
+// -1 leaves the encoder to be chosen among what's available
+constexpr SettingField kEncoderTypeField = {
+    [](AppSettings &settings, const QVariant &value)
+    {
+        settings.encoderType = value.toInt();
+        if (settings.encoderType >= 0)
+            settings.encoding.encoder = static_cast<EncoderType>(settings.encoderType);
+    },
+    [](const AppSettings &settings) -> QVariant
+    { return settings.encoderType; }};
+
+// "off", or the noise_suppress_filter method
+constexpr SettingField kNoiseSuppressionField = {
+    [](AppSettings &settings, const QVariant &value)
+    {
+        const QString suppression = value.toString();
+        settings.microphone.noiseSuppression = suppression != "off";
+        if (settings.microphone.noiseSuppression)
+            settings.microphone.noiseSuppressionMethod = suppression.toStdString();
+    },
+    [](const AppSettings &settings) -> QVariant
+    {
+        const MicrophoneSettings &microphone = settings.microphone;
+        return microphone.noiseSuppression ? QString::fromStdString(microphone.noiseSuppressionMethod) : QString("off");
+    }};
+
+constexpr const char *kNoiseSuppressionChoices[] = {"off", "auto", "speex", "rnnoise", "nvafx_denoiser", nullptr};
+
+// load() and save() both walk this table. Limits match the widgets that edit
+// them. gameExes is an array and is handled separately.
+constexpr SettingSpec kSchema[] = {
+    // General
+    stringSetting("outputFolder", "", field<&AppSettings::outputFolder>()), // Empty: <Videos>/Clips
+    intSetting("clipLengthSeconds", 60, 5, 600, field<&AppSettings::clipLengthSeconds>()),
+    intSetting("saveBurstWindowSeconds", 0, 0, 30, field<&AppSettings::saveBurstWindowSeconds>()),
+    boolSetting("autoStart", false, field<&AppSettings::autoStart>()),
+    boolSetting("minimizeToTray", true, field<&AppSettings::minimizeToTray>()),
+    boolSetting("startClippingAutomatically", false, field<&AppSettings::startClippingAutomatically>()),
+    boolSetting("unloadWindowInTray", false, field<&AppSettings::unloadWindowInTray>()),
+
+    // Video
+    intSetting("videoWidth", 1920, 320, 7680, field<&AppSettings::capture, &CaptureSettings::width>()),
+    intSetting("videoHeight", 1080, 240, 4320, field<&AppSettings::capture, &CaptureSettings::height>()),
+    intSetting("videoFps", 60, 1, 240, field<&AppSettings::capture, &CaptureSettings::fps>()),
+
+    // Encoding
+    intSetting("encoderType", -1, -1, static_cast<int>(EncoderType::X265), kEncoderTypeField),
+    boolSetting("use_cbr", true, field<&AppSettings::encoding, &EncodingSettings::use_cbr>()),
+    intSetting("bitrate", 8000, 1000, 100000, field<&AppSettings::encoding, &EncodingSettings::bitrate>()),
+    intSetting("crf", 22, 1, 51, field<&AppSettings::encoding, &EncodingSettings::crf>()),
+    intSetting("keyint_sec", 0, 0, 10, field<&AppSettings::encoding, &EncodingSettings::keyint_sec>()),
+    stringSetting("x264Preset", "veryfast", field<&AppSettings::encoding, &EncodingSettings::x264Preset>()),
+    stringSetting("x264Profile", "high", field<&AppSettings::encoding, &EncodingSettings::x264Profile>()),
+    stringSetting("x264Tune", "zerolatency", field<&AppSettings::encoding, &EncodingSettings::x264Tune>()),
+    stringSetting("x264opts", "", field<&AppSettings::encoding, &EncodingSettings::x264opts>()),
+    stringSetting("nvencPreset", "p5", field<&AppSettings::encoding, &EncodingSettings::nvencPreset>()),
+    stringSetting("nvencTuning", "hq", field<&AppSettings::encoding, &EncodingSettings::nvencTuning>()),
+    stringSetting("nvencMultipass", "qres", field<&AppSettings::encoding, &EncodingSettings::nvencMultipass>()),
+    stringSetting("nvencProfile", "high", field<&AppSettings::encoding, &EncodingSettings::nvencProfile>()),
+    boolSetting("nvencLookahead", false, field<&AppSettings::encoding, &EncodingSettings::nvencLookahead>()),
+    boolSetting("nvencPsychoVisualTuning", true, field<&AppSettings::encoding, &EncodingSettings::nvencPsychoVisualTuning>()),
+    intSetting("nvencGpu", 0, 0, 8, field<&AppSettings::encoding, &EncodingSettings::nvencGpu>()),
+    intSetting("nvencMaxBFrames", 2, 0, 4, field<&AppSettings::encoding, &EncodingSettings::nvencMaxBFrames>()),
+    stringSetting("qsvPreset", "balanced", field<&AppSettings::encoding, &EncodingSettings::qsvPreset>()),
+    stringSetting("qsvProfile", "high", field<&AppSettings::encoding, &EncodingSettings::qsvProfile>()),
+    boolSetting("qsvLowPower", false, field<&AppSettings::encoding, &EncodingSettings::qsvLowPower>()),
+    stringSetting("amfUsage", "quality", field<&AppSettings::encoding, &EncodingSettings::amfUsage>()),
+    stringSetting("amfProfile", "high", field<&AppSettings::encoding, &EncodingSettings::amfProfile>()),
+    intSetting("amf_bframes", 2, 0, 16, field<&AppSettings::encoding, &EncodingSettings::amf_bframes>()),
+    stringSetting("amf_opts", "", field<&AppSettings::encoding, &EncodingSettings::amf_opts>()),
+
+    // Desktop audio
+    boolSetting("audioEnabled", true, field<&AppSettings::audio, &AudioSettings::enabled>()),
+    intSetting("audioVolume", 100, 0, 100, percentField<&AppSettings::audio, &AudioSettings::volume>()),
+    stringSetting("audioDeviceID", "default", field<&AppSettings::audio, &AudioSettings::deviceId>()),
+    boolSetting("showAudioLevels", false, field<&AppSettings::showAudioLevels>()),
+    boolSetting("normalizeLoudness", false, field<&AppSettings::normalizeLoudness>()),
+    doubleSetting("targetLoudness", -16.0, -30.0, -10.0, field<&AppSettings::targetLoudness>()),
+    boolSetting("audioReplay", false, field<&AppSettings::audioReplay>()),
+    intSetting("audioReplayMinutes", 60, 1, 120, field<&AppSettings::audioReplayMinutes>()),
+
+    // Microphone
+    boolSetting("micEnabled", false, field<&AppSettings::microphone, &MicrophoneSettings::enabled>()),
+    intSetting("micVolume", 100, 0, 100, percentField<&AppSettings::microphone, &MicrophoneSettings::volume>()),
+    stringSetting("micDeviceID", "default", field<&AppSettings::microphone, &MicrophoneSettings::deviceId>()),
+    boolSetting("showMicLevels", false, field<&AppSettings::showMicLevels>()),
+    stringSetting("noiseSuppression", "auto", kNoiseSuppressionField, kNoiseSuppressionChoices),
+    boolSetting("noiseGate", false, field<&AppSettings::microphone, &MicrophoneSettings::noiseGate>()),
+    intSetting("noiseGateOpen", -30, -96, 0, field<&AppSettings::microphone, &MicrophoneSettings::noiseGateThreshold>()),
+    intSetting("noiseGateClose", -32, -96, 0, field<&AppSettings::microphone, &MicrophoneSettings::noiseGateCloseThreshold>()),
+    intSetting("noiseGateHold", 200, 0, 10000, field<&AppSettings::microphone, &MicrophoneSettings::noiseGateHoldTime>()),
+    intSetting("noiseGateRelease", 150, 0, 10000, field<&AppSettings::microphone, &MicrophoneSettings::noiseGateReleaseTime>()),
+
+    // Notifications and keybinds
+    boolSetting("notificationSoundEnabled", true, field<&AppSettings::notificationSound>()),
+    boolSetting("trayNotificationsEnabled", true, field<&AppSettings::trayNotifications>()),
+    stringSetting("keybind_clip", "F9", field<&AppSettings::clipKeybind>()),
+    stringSetting("keybind_clipping", "F10", field<&AppSettings::clippingKeybind>()),
+};
+
+constexpr bool sameKey(const char *a, const char *b)
+{
+    while (*a && *a == *b)
+    {
+        ++a;
+        ++b;
+    }
+    return *a == *b;
+}
+
+constexpr bool schemaKeysUnique()
+{
+    for (size_t i = 0; i < std::size(kSchema); ++i)
+    {
+        for (size_t j = i + 1; j < std::size(kSchema); ++j)
+        {
+            if (sameKey(kSchema[i].key, kSchema[j].key))
+                return false;
+        }
+    }
+    return true;
+}
+static_assert(schemaKeysUnique(), "Duplicate key in the settings schema");
+
+// For code outside the table that names a schema key (migrations). A key
+// that isn't in kSchema doesn't compile.
+consteval const char *schemaKey(const char *key)
+{
+    for (const SettingSpec &spec : kSchema)
+    {
+        if (sameKey(spec.key, key))
+            return spec.key;
+    }
+    throw "Unknown settings key";
+}
+
+// Typed reads of schema entries. Anything unusable in the store is logged
+// once and replaced by the default.
+class SchemaReader
+{
+public:
+    explicit SchemaReader(const SettingsStore &store) : m_store(store) {}
+
+    // The stored value, or the default, as the spec's type
+    QVariant value(const SettingSpec &spec) const
+    {
+        switch (spec.type)
+        {
+        case SettingType::Bool:
+            return boolean(spec);
+        case SettingType::Int:
+            return static_cast<int>(number(spec));
+        case SettingType::Double:
+            return number(spec);
+        case SettingType::String:
+            return string(spec);
+        }
+        return QVariant();
+    }
+
+private:
+    bool boolean(const SettingSpec &spec) const
+    {
+        const QVariant value = m_store.value(spec.key);
+        if (!value.isValid())
+            return spec.defaultNumber != 0;
+        const QString text = value.toString();
+        if (value.typeId() != QMetaType::Bool && text != "true" && text != "false")
+            return rejected(spec, text).defaultNumber != 0;
+        return value.toBool();
+    }
+
+    double number(const SettingSpec &spec) const
+    {
+        const QVariant value = m_store.value(spec.key);
+        if (!value.isValid())
+            return spec.defaultNumber;
+        bool ok = false;
+        const double number = spec.type == SettingType::Int ? value.toInt(&ok) : value.toDouble(&ok);
+        if (!ok || number < spec.min || number > spec.max)
+            return rejected(spec, value.toString()).defaultNumber;
+        return number;
+    }
+
+    QString string(const SettingSpec &spec) const
+    {
+        const QVariant value = m_store.value(spec.key);
+        if (!value.isValid())
+            return QString::fromUtf8(spec.defaultString);
+        const QString text = value.toString();
+        if (spec.choices)
+        {
+            for (const char *const *choice = spec.choices; *choice; ++choice)
+            {
+                if (text == QLatin1String(*choice))
+                    return text;
+            }
+            return QString::fromUtf8(rejected(spec, text).defaultString);
+        }
+        return text;
+    }
+
+    static const SettingSpec &rejected(const SettingSpec &spec, const QString &value)
+    {
+        LOG_WARN("Ignoring invalid setting %1=\"%2\", using the default", QString::fromUtf8(spec.key), value);
+        return spec;
+    }
+
+    const SettingsStore &m_store;
+};
+
+// Each takes the stored settings from version i to i + 1. Version 0 is
+// anything written before settings were versioned.
+using Migration = void (*)(SettingsStore &store);
+
+// The resolution and clip length used to be stored as their combo box texts
+void migrateDisplayStrings(SettingsStore &store)
+{
+    const QStringList resolution = store.value("videoResolution").toString().split('x');
+    if (resolution.size() == 2)
+    {
+        bool widthOk = false;
+        bool heightOk = false;
+        const int width = resolution[0].toInt(&widthOk);
+        const int height = resolution[1].toInt(&heightOk);
+        if (widthOk && heightOk)
+        {
+            store.setValue(schemaKey("videoWidth"), width);
+            store.setValue(schemaKey("videoHeight"), height);
+        }
+    }
+    store.remove("videoResolution");
+
+    QString clipLength = store.value("clipLength").toString();
+    if (clipLength.endsWith('s'))
+    {
+        clipLength.chop(1);
+        bool ok = false;
+        const int seconds = clipLength.toInt(&ok);
+        if (ok)
+            store.setValue(schemaKey("clipLengthSeconds"), seconds);
+    }
+    store.remove("clipLength");
+}
+
+constexpr Migration kMigrations[] = {
+    migrateDisplayStrings, // 0 -> 1
+};
+static_assert(std::size(kMigrations) == AppSettings::kVersion, "Every version needs a migration from the one before");
+
+void migrate(SettingsStore &store)
+{
+    const int version = store.value("settingsVersion", 0).toInt();
+    if (version > AppSettings::kVersion)
+    {
+        // Written by a newer build; known keys are still read, and validated
+        LOG_WARN("Settings are version %1, newer than this build (%2)", version, AppSettings::kVersion);
+        return;
+    }
+    for (int from = version; from < AppSettings::kVersion; ++from)
+    {
+        LOG_INFO("Migrating settings from version %1 to %2", from, from + 1);
+        kMigrations[from](store);
+    }
+    store.setValue("settingsVersion", AppSettings::kVersion);
+}
+} // namespace
+
+AppSettings AppSettings::load()
+{
+    SettingsStore &store = SettingsStore::instance();
+    migrate(store);
+    const SchemaReader read(store);
+
+    AppSettings settings;
+    for (const SettingSpec &spec : kSchema)
+        spec.field.load(settings, read.value(spec));
+    if (settings.outputFolder.isEmpty())
+        settings.outputFolder = QStandardPaths::writableLocation(QStandardPaths::MoviesLocation) + "/Clips";
+    for (const QString &exe : store.stringArray("gameExes", "exe"))
+    {
+        if (!exe.isEmpty() && !settings.gameExes.contains(exe))
+            settings.gameExes.append(exe);
+    }
+    return settings;
+}
+
+void AppSettings::save() const
+{
+    SettingsStore &store = SettingsStore::instance();
+    for (const SettingSpec &spec : kSchema)
+        store.setValue(spec.key, spec.field.save(*this));
+    store.setStringArray("gameExes", "exe", gameExes);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "GameCapture.h"
+#include <QString>
+#include <QStringList>
+
+// Everything the application persists, as typed values. load() needs no UI,
+// so main() configures GameCapture from it before any window exists; the
+// window only mirrors it in widgets and hands it back to save().
+// Keys, types, defaults, limits and the member each one maps to live in the
+// schema table in AppSettings.cpp; load() and save() both walk it.
+struct AppSettings
+{
+    // Raised by one with every migration added to AppSettings.cpp
+    static constexpr int kVersion = 1;
+
+    CaptureSettings capture;
+    EncodingSettings encoding;
+    // The EncoderType the user picked, or -1 to choose among what's available
+    int encoderType = -1;
+    AudioSettings audio;
+    MicrophoneSettings microphone;
+
+    // Defaults for these come from the schema, not from here
+    QString outputFolder;
+    QStringList gameExes;
+    int clipLengthSeconds = 0;
+    int saveBurstWindowSeconds = 0; // Saves this close together become one clip
+    bool autoStart = false;
+    bool minimizeToTray = false;
+    bool startClippingAutomatically = false;
+    bool unloadWindowInTray = false; // Tray-only mode: the widgets are freed while hidden
+
+    bool showAudioLevels = false;
+    bool showMicLevels = false;
+    bool normalizeLoudness = false;
+    double targetLoudness = 0.0;
+    bool audioReplay = false;
+    int audioReplayMinutes = 0;
+
+    bool notificationSound = false;
+    bool trayNotifications = false;
+    QString clipKeybind;
+    QString clippingKeybind;
+
+    // Brings older stored settings up to kVersion first. Values that are
+    // missing, malformed or out of range come back as their defaults.
+    static AppSettings load();
+    // Only changed values reach the store, which writes them out later
+    void save() const;
+};
@@ -0,0 +1,270 @@
+#include "AudioDeviceWatcher.h"
+#include "Logger.h"
+#include <QTimer>
+#include <atomic>
+#include <functional>
+#include <windows.h>
+#include <mmdeviceapi.h>
+#include <functiondiscoverykeys_devpkey.h>
+
+namespace
+{
+// Device arrival usually comes as several notifications in a row (added,
+// state changed, default changed); they're folded into one enumeration.
+constexpr int kRescanDelayMs = 250;
+
+// Forwards endpoint notifications. Called on COM's own threads, which must
+// not block, so everything is handed over to the worker thread.
+class NotificationClient : public IMMNotificationClient
+{
+public:
+    NotificationClient(std::function<void()> onDevicesChanged,
+                       std::function<void(bool, const QString &)> onDefaultChanged)
+        : m_onDevicesChanged(std::move(onDevicesChanged)),
+          m_onDefaultChanged(std::move(onDefaultChanged))
+    {
+    }
+
+    ULONG STDMETHODCALLTYPE AddRef() override { return ++m_refs; }
+    ULONG STDMETHODCALLTYPE Release() override
+    {
+        const ULONG refs = --m_refs;
+        if (refs == 0)
+            delete this;
+        return refs;
+    }
+    HRESULT STDMETHODCALLTYPE QueryInterface(REFIID iid, void **object) override
+    {
+        if (iid == __uuidof(IUnknown) || iid == __uuidof(IMMNotificationClient))
+        {
+            AddRef();
+            *object = static_cast<IMMNotificationClient *>(this);
+            return S_OK;
+        }
+        *object = nullptr;
+        return E_NOINTERFACE;
+    }
+
+    HRESULT STDMETHODCALLTYPE OnDeviceStateChanged(LPCWSTR, DWORD) override
+    {
+        m_onDevicesChanged();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE OnDeviceAdded(LPCWSTR) override
+    {
+        m_onDevicesChanged();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE OnDeviceRemoved(LPCWSTR) override
+    {
+        m_onDevicesChanged();
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE OnDefaultDeviceChanged(EDataFlow flow, ERole role, LPCWSTR deviceId) override
+    {
+        // Reported once per role; the console role is the one "default" follows
+        if (role == eConsole)
+            m_onDefaultChanged(flow == eCapture, deviceId ? QString::fromWCharArray(deviceId) : QString());
+        return S_OK;
+    }
+    HRESULT STDMETHODCALLTYPE OnPropertyValueChanged(LPCWSTR, const PROPERTYKEY key) override
+    {
+        // A renamed device shows up under its new name
+        if (key == PKEY_Device_FriendlyName)
+            m_onDevicesChanged();
+        return S_OK;
+    }
+
+private:
+    std::atomic<ULONG> m_refs{1};
+    std::function<void()> m_onDevicesChanged;
+    std::function<void(bool, const QString &)> m_onDefaultChanged;
+};
+} // namespace
+
+// Lives on the watcher's thread, which owns the COM apartment, the enumerator
+// and the notification registration for the life of the application.
+class AudioDeviceWatcher::Worker : public QObject
+{
+public:
+    explicit Worker(AudioDeviceWatcher *owner) : m_owner(owner) {}
+
+    ~Worker()
+    {
+        if (m_enumerator)
+        {
+            if (m_client)
+                m_enumerator->UnregisterEndpointNotificationCallback(m_client);
+            m_enumerator->Release();
+        }
+        if (m_client)
+            m_client->Release();
+        if (m_comInitialized)
+            CoUninitialize();
+    }
+
+    void initialize()
+    {
+        m_rescanTimer = new QTimer(this);
+        m_rescanTimer->setSingleShot(true);
+        m_rescanTimer->setInterval(kRescanDelayMs);
+        connect(m_rescanTimer, &QTimer::timeout, this, [this]()
+                { enumerateAll(); });
+
+        HRESULT hr = CoInitializeEx(NULL, COINIT_MULTITHREADED);
+        m_comInitialized = SUCCEEDED(hr);
+        if (FAILED(hr))
+        {
+            LOG_WARN("Audio device watcher: CoInitializeEx failed (0x%1)", QString::number(static_cast<quint32>(hr), 16));
+            return;
+        }
+        hr = CoCreateInstance(__uuidof(MMDeviceEnumerator), NULL, CLSCTX_ALL,
+                              __uuidof(IMMDeviceEnumerator), (void **)&m_enumerator);
+        if (FAILED(hr))
+        {
+            LOG_WARN("Audio device watcher: no device enumerator (0x%1)", QString::number(static_cast<quint32>(hr), 16));
+            m_enumerator = nullptr;
+            return;
+        }
+
+        AudioDeviceWatcher *owner = m_owner;
+        m_client = new NotificationClient(
+            [this]()
+            { scheduleRescan(); },
+            [owner](bool input, const QString &deviceId)
+            {
+                QMetaObject::invokeMethod(owner, [owner, input, deviceId]()
+                                          { emit owner->defaultDeviceChanged(input, deviceId); }, Qt::QueuedConnection);
+            });
+        hr = m_enumerator->RegisterEndpointNotificationCallback(m_client);
+        if (FAILED(hr))
+        {
+            // Still usable: the lists are only refreshed on request then
+            LOG_WARN("Audio device watcher: can't register for notifications (0x%1)", QString::number(static_cast<quint32>(hr), 16));
+            m_client->Release();
+            m_client = nullptr;
+        }
+
+        enumerateAll();
+    }
+
+    // Any thread
+    void scheduleRescan()
+    {
+        QMetaObject::invokeMethod(this, [this]()
+                                  {
+            if (m_rescanTimer)
+                m_rescanTimer->start(); }, Qt::QueuedConnection);
+    }
+
+private:
+    void enumerateAll()
+    {
+        if (!m_enumerator)
+            return;
+
+        const DeviceList outputs = enumerate(eRender);
+        const DeviceList inputs = enumerate(eCapture);
+        AudioDeviceWatcher *owner = m_owner;
+        QMetaObject::invokeMethod(owner, [owner, outputs, inputs]()
+                                  {
+            owner->applyDevices(false, outputs);
+            owner->applyDevices(true, inputs); }, Qt::QueuedConnection);
+    }
+
+    DeviceList enumerate(EDataFlow dataFlow)
+    {
+        DeviceList devices;
+        devices.append(qMakePair(QString("default"), dataFlow == eRender ? QString("Default") : QString("Default Microphone")));
+
+        IMMDeviceCollection *pCollection = NULL;
+        HRESULT hr = m_enumerator->EnumAudioEndpoints(dataFlow, DEVICE_STATE_ACTIVE, &pCollection);
+        if (FAILED(hr))
+        {
+            LOG_WARN("Audio device watcher: EnumAudioEndpoints failed (0x%1)", QString::number(static_cast<quint32>(hr), 16));
+            return devices;
+        }
+
+        UINT count = 0;
+        pCollection->GetCount(&count);
+        for (UINT i = 0; i < count; i++)
+        {
+            IMMDevice *pDevice = NULL;
+            if (FAILED(pCollection->Item(i, &pDevice)))
+                continue;
+
+            LPWSTR pwszID = NULL;
+            if (SUCCEEDED(pDevice->GetId(&pwszID)))
+            {
+                IPropertyStore *pProps = NULL;
+                if (SUCCEEDED(pDevice->OpenPropertyStore(STGM_READ, &pProps)))
+                {
+                    PROPVARIANT varName;
+                    PropVariantInit(&varName);
+                    if (SUCCEEDED(pProps->GetValue(PKEY_Device_FriendlyName, &varName)))
+                        devices.append(qMakePair(QString::fromWCharArray(pwszID), QString::fromWCharArray(varName.pwszVal)));
+                    PropVariantClear(&varName);
+                    pProps->Release();
+                }
+                CoTaskMemFree(pwszID);
+            }
+            pDevice->Release();
+        }
+        pCollection->Release();
+        return devices;
+    }
+
+    AudioDeviceWatcher *m_owner;
+    IMMDeviceEnumerator *m_enumerator = nullptr;
+    NotificationClient *m_client = nullptr;
+    QTimer *m_rescanTimer = nullptr;
+    bool m_comInitialized = false;
+};
+
+AudioDeviceWatcher::AudioDeviceWatcher(QObject *parent)
+    : QObject(parent)
+{
+    m_thread.setObjectName("AudioDeviceWatcher");
+}
+
+AudioDeviceWatcher::~AudioDeviceWatcher()
+{
+    // The worker is deleted on its own thread once the loop has quit, which
+    // unregisters the notifications and uninitializes COM there.
+    m_thread.quit();
+    m_thread.wait();
+}
+
+void AudioDeviceWatcher::start()
+{
+    if (m_worker)
+        return;
+
+    m_worker = new Worker(this);
+    m_worker->moveToThread(&m_thread);
+    Worker *worker = m_worker;
+    connect(&m_thread, &QThread::started, worker, [worker]()
+            { worker->initialize(); });
+    connect(&m_thread, &QThread::finished, worker, &QObject::deleteLater);
+    m_thread.start();
+}
+
+void AudioDeviceWatcher::rescan()
+{
+    if (m_worker)
+        m_worker->scheduleRescan();
+}
+
+void AudioDeviceWatcher::applyDevices(bool input, const DeviceList &devices)
+{
+    DeviceList &cached = input ? m_inputDevices : m_outputDevices;
+    if (cached == devices)
+        return;
+
+    cached = devices;
+    LOG_INFO("%1 audio devices: %2", input ? QString("Input") : QString("Output"), static_cast<int>(devices.size()) - 1);
+    if (input)
+        emit inputDevicesChanged(devices);
+    else
+        emit outputDevicesChanged(devices);
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <QObject>
+#include <QList>
+#include <QPair>
+#include <QString>
+#include <QThread>
+
+// Keeps the lists of active audio endpoints up to date. A WASAPI endpoint
+// notification client on a persistent worker thread reports devices being
+// added, removed, enabled or disabled, and the lists are re-enumerated (once
+// per burst of notifications) only then. The last lists are cached here, so
+// reading them never touches COM.
+class AudioDeviceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    // (device id, friendly name), starting with the "default" pseudo-device
+    using DeviceList = QList<QPair<QString, QString>>;
+
+    explicit AudioDeviceWatcher(QObject *parent = nullptr);
+    ~AudioDeviceWatcher();
+
+    // Enumerates once and then watches for changes
+    void start();
+
+    const DeviceList &outputDevices() const { return m_outputDevices; }
+    const DeviceList &inputDevices() const { return m_inputDevices; }
+
+public slots:
+    // Forces a re-enumeration, for when notifications can't be had
+    void rescan();
+
+signals:
+    // Only emitted when a list actually changed
+    void outputDevicesChanged(const AudioDeviceWatcher::DeviceList &devices);
+    void inputDevicesChanged(const AudioDeviceWatcher::DeviceList &devices);
+    // The system default endpoint for console use changed
+    void defaultDeviceChanged(bool input, const QString &deviceId);
+
+private:
+    class Worker;
+
+    void applyDevices(bool input, const DeviceList &devices);
+
+    QThread m_thread;
+    Worker *m_worker = nullptr;
+    DeviceList m_outputDevices;
+    DeviceList m_inputDevices;
+};
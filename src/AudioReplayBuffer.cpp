@@ -0,0 +1,270 @@
+#include "AudioReplayBuffer.h"
+#include "Logger.h"
+#include "Trace.h"
+#include <obs.h>
+#include <QFutureWatcher>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+constexpr const char *kOutputId = "obsrc_audio_replay";
+constexpr int kAacFrameSamples = 1024;
+
+// The output's private data; owner is filled in right after creation
+struct OutputContext
+{
+    obs_output_t *output;
+    AudioReplayBuffer *owner;
+};
+
+const char *outputName(void *)
+{
+    return "Audio Replay Buffer";
+}
+
+void *outputCreate(obs_data_t *, obs_output_t *output)
+{
+    return new OutputContext{output, nullptr};
+}
+
+void outputDestroy(void *data)
+{
+    delete static_cast<OutputContext *>(data);
+}
+
+bool outputStart(void *data)
+{
+    obs_output_t *output = static_cast<OutputContext *>(data)->output;
+    if (!obs_output_can_begin_data_capture(output, 0))
+        return false;
+    if (!obs_output_initialize_encoders(output, 0))
+        return false;
+    return obs_output_begin_data_capture(output, 0);
+}
+
+void outputStop(void *data, uint64_t)
+{
+    obs_output_end_data_capture(static_cast<OutputContext *>(data)->output);
+}
+
+int adtsSampleRateIndex(uint32_t sampleRate)
+{
+    static const uint32_t rates[] = {96000, 88200, 64000, 48000, 44100, 32000, 24000,
+                                     22050, 16000, 12000, 11025, 8000, 7350};
+    const auto it = std::find(std::begin(rates), std::end(rates), sampleRate);
+    return it == std::end(rates) ? 3 : static_cast<int>(it - std::begin(rates));
+}
+} // namespace
+
+AudioReplayBuffer::AudioReplayBuffer(QObject *parent)
+    : QObject(parent)
+{
+}
+
+AudioReplayBuffer::~AudioReplayBuffer()
+{
+    stop();
+}
+
+bool AudioReplayBuffer::start(obs_encoder_t *encoder)
+{
+    stop();
+    if (!encoder)
+        return false;
+
+    static bool registered = false;
+    if (!registered)
+    {
+        obs_output_info info = {};
+        info.id = kOutputId;
+        info.flags = OBS_OUTPUT_AUDIO | OBS_OUTPUT_ENCODED;
+        info.encoded_audio_codecs = "aac";
+        info.get_name = outputName;
+        info.create = outputCreate;
+        info.destroy = outputDestroy;
+        info.start = outputStart;
+        info.stop = outputStop;
+        info.encoded_packet = &AudioReplayBuffer::packetCallback;
+        obs_register_output(&info);
+        registered = true;
+    }
+
+    m_output = obs_output_create(kOutputId, "audio_replay_buffer", nullptr, nullptr);
+    if (!m_output)
+        return false;
+    static_cast<OutputContext *>(obs_obj_get_data(m_output))->owner = this;
+    obs_output_set_audio_encoder(m_output, encoder, 0);
+
+    // ADTS carries the stream parameters in every frame header. ffmpeg_aac
+    // is AAC-LC; OBS's 7.1 layout is ADTS channel configuration 7.
+    const uint32_t sampleRate = obs_encoder_get_sample_rate(encoder);
+    const size_t channels = obs_get_audio() ? audio_output_get_channels(obs_get_audio()) : 2;
+    {
+        AdtsConfig config;
+        config.sampleRateIndex = adtsSampleRateIndex(sampleRate);
+        config.channelConfig = channels == 8 ? 7 : static_cast<int>(channels);
+        const int64_t frameUsec = sampleRate ? int64_t(kAacFrameSamples) * 1000000 / sampleRate : 0;
+
+        // A save writes one set of headers for every packet, so packets
+        // encoded with other parameters can't be kept
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (!m_packets.empty() && (config.sampleRateIndex != m_config.sampleRateIndex ||
+                                   config.channelConfig != m_config.channelConfig || frameUsec != m_frameUsec))
+        {
+            LOG_INFO("Audio format changed, dropping %1 buffered audio packets", static_cast<int>(m_packets.size()));
+            m_packets.clear();
+            m_bytes = 0;
+        }
+        m_config = config;
+        m_frameUsec = frameUsec;
+    }
+
+    if (!obs_output_start(m_output))
+    {
+        LOG_WARN("Audio replay buffer failed to start: %1", QString::fromUtf8(obs_output_get_last_error(m_output)));
+        obs_output_release(m_output);
+        m_output = nullptr;
+        return false;
+    }
+    m_active = true;
+    LOG_INFO("Audio replay buffer started, keeping %1 s", m_retentionSeconds);
+    return true;
+}
+
+void AudioReplayBuffer::stop()
+{
+    if (!m_output)
+        return;
+
+    // Packets already buffered are kept, so a restart (e.g. for a new
+    // encoder) carries on from where this left off, unless the audio
+    // format changes.
+    m_active = false;
+    obs_output_stop(m_output);
+    obs_output_release(m_output);
+    m_output = nullptr;
+}
+
+void AudioReplayBuffer::setRetention(int seconds)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_retentionSeconds = std::max(1, seconds);
+    trimLocked();
+}
+
+double AudioReplayBuffer::bufferedSeconds() const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_packets.empty())
+        return 0.0;
+    return (m_packets.back().dtsUsec - m_packets.front().dtsUsec + m_frameUsec) / 1e6;
+}
+
+void AudioReplayBuffer::clear()
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_packets.clear();
+    m_bytes = 0;
+}
+
+void AudioReplayBuffer::packetCallback(void *data, encoder_packet *packet)
+{
+    AudioReplayBuffer *owner = static_cast<OutputContext *>(data)->owner;
+    if (!packet)
+    {
+        LOG_WARN_LIMITED(5000, "Audio replay buffer: encoder stopped delivering packets");
+        return;
+    }
+    if (owner && packet->type == OBS_ENCODER_AUDIO)
+        owner->addPacket(packet);
+}
+
+void AudioReplayBuffer::addPacket(encoder_packet *packet)
+{
+    // Encoder thread. Frames are ~600 bytes every 21 ms; copying them into a
+    // QByteArray lets save() snapshot the ring without copying again.
+    Packet copy{QByteArray(reinterpret_cast<const char *>(packet->data), static_cast<int>(packet->size)),
+                packet->sys_dts_usec};
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_bytes += packet->size;
+    m_packets.push_back(std::move(copy));
+    trimLocked();
+}
+
+void AudioReplayBuffer::trimLocked()
+{
+    const int64_t retentionUsec = int64_t(m_retentionSeconds) * 1000000;
+    while (!m_packets.empty() && m_packets.back().dtsUsec - m_packets.front().dtsUsec > retentionUsec)
+    {
+        m_bytes -= static_cast<size_t>(m_packets.front().data.size());
+        m_packets.pop_front();
+    }
+}
+
+bool AudioReplayBuffer::save(const QString &path)
+{
+    std::deque<Packet> packets;
+    AdtsConfig config;
+    size_t bytes = 0;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        packets = m_packets;
+        config = m_config;
+        bytes = m_bytes;
+    }
+    if (packets.empty())
+    {
+        LOG_WARN("Audio replay buffer is empty, nothing to save");
+        return false;
+    }
+
+    LOG_INFO("Saving %1 s of buffered audio (%2 KB) to %3",
+             (packets.back().dtsUsec - packets.front().dtsUsec) / 1e6, static_cast<int>(bytes / 1024), path);
+    auto *watcher = new QFutureWatcher<bool>(this);
+    connect(watcher, &QFutureWatcher<bool>::finished, this, [this, watcher, path]()
+            {
+        emit saved(path, watcher->result());
+        watcher->deleteLater(); });
+    watcher->setFuture(QtConcurrent::run([path, packets = std::move(packets), config]()
+                                         { return writeAdts(path, packets, config); }));
+    return true;
+}
+
+bool AudioReplayBuffer::writeAdts(const QString &path, const std::deque<Packet> &packets, AdtsConfig config)
+{
+    TRACE_SCOPE("AudioReplayBuffer::writeAdts");
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        LOG_WARN("Could not write %1: %2", path, file.errorString());
+        return false;
+    }
+
+    // 7-byte ADTS header (no CRC) in front of each raw AAC-LC frame
+    unsigned char header[7];
+    header[0] = 0xFF;
+    header[1] = 0xF1;
+    header[2] = static_cast<unsigned char>((1 << 6) | (config.sampleRateIndex << 2) | (config.channelConfig >> 2));
+    header[6] = 0xFC;
+    for (const Packet &packet : packets)
+    {
+        const int frameLength = static_cast<int>(packet.data.size()) + 7;
+        header[3] = static_cast<unsigned char>(((config.channelConfig & 3) << 6) | (frameLength >> 11));
+        header[4] = static_cast<unsigned char>((frameLength >> 3) & 0xFF);
+        header[5] = static_cast<unsigned char>(((frameLength & 7) << 5) | 0x1F);
+        file.write(reinterpret_cast<const char *>(header), sizeof(header));
+        file.write(packet.data);
+    }
+
+    if (!file.commit())
+    {
+        LOG_WARN("Could not write %1: %2", path, file.errorString());
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QString>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+
+struct obs_output;
+struct obs_encoder;
+struct encoder_packet;
+typedef struct obs_output obs_output_t;
+typedef struct obs_encoder obs_encoder_t;
+
+// A replay buffer for audio alone. It attaches an audio-only encoded output to
+// an existing AAC encoder (normally the video replay buffer's, so the audio
+// is only encoded once) and keeps the encoded packets in memory for the
+// retention period, which is independent of the video buffer's length. A
+// save writes the buffered packets out as an ADTS .aac file; nothing is
+// decoded or re-encoded, so an hour at 192 kbps is ~85 MB of memory and
+// next to no CPU.
+class AudioReplayBuffer : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit AudioReplayBuffer(QObject *parent = nullptr);
+    ~AudioReplayBuffer();
+
+    // OBS control thread. The encoder must be an AAC encoder with its audio
+    // already set and must outlive the buffer's output: stop() before releasing it.
+    bool start(obs_encoder_t *encoder);
+    void stop();
+    // Any thread
+    bool isActive() const { return m_active.load(); }
+
+    void setRetention(int seconds);
+    int retention() const { return m_retentionSeconds; }
+    double bufferedSeconds() const;
+    // Drops everything buffered so far
+    void clear();
+
+    // Writes everything buffered to path on a worker thread, then emits saved()
+    bool save(const QString &path);
+
+signals:
+    void saved(const QString &path, bool success);
+
+private:
+    struct Packet
+    {
+        QByteArray data; // Shared, so snapshots for a save don't copy
+        int64_t dtsUsec;
+    };
+    struct AdtsConfig
+    {
+        int sampleRateIndex = 3; // 48 kHz
+        int channelConfig = 2;
+    };
+
+    static void packetCallback(void *data, encoder_packet *packet);
+    void addPacket(encoder_packet *packet);
+    void trimLocked();
+    static bool writeAdts(const QString &path, const std::deque<Packet> &packets, AdtsConfig config);
+
+    obs_output_t *m_output = nullptr;
+    std::atomic<bool> m_active{false};
+    AdtsConfig m_config;
+    int m_retentionSeconds = 3600;
+
+    mutable std::mutex m_mutex;
+    std::deque<Packet> m_packets; // Oldest first
+    size_t m_bytes = 0;
+    int64_t m_frameUsec = 0; // Duration of one AAC frame
+};
@@ -1,27 +1,38 @@
 #include "AudioVisualizer.h"
+#include "SpectrumAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "Trace.h"
+#include "FrameClock.h"
 #include <QPainter>
+#include <QPaintEvent>
+#include <QLinearGradient>
 #include <QStyleOption>
 #include <algorithm>
 #include <cmath>
 
+namespace {
+constexpr int kMargin = 2;
+constexpr int kSpacing = 1;
+}
+
+static_assert(SpectrumAnalyzer::kBandCount == 20, "one bar per spectrum band");
+
 AudioVisualizer::AudioVisualizer(QWidget *parent)
     : QWidget(parent),
-      m_updateTimer(new QTimer(this)),
-      m_currentLevel(0.0f),
+      m_spectrum(nullptr),
+      m_loudness(nullptr),
       m_peakLevel(0.0f),
       m_displayLevel(0.0f),
       m_enabled(true),
       m_barLevels(m_barCount, 0.0f),
-      m_barPeaks(m_barCount, 0.0f)
+      m_barPeaks(m_barCount, 0.0f),
+      m_shownFill(m_barCount, 0),
+      m_shownPeak(m_barCount, 0),
+      m_shownText("Level: 0%")
 {
     setFixedHeight(30);
     setMinimumWidth(200);
-    
-    // Update at 60 FPS for smooth animation
-    m_updateTimer->setInterval(16);
-    connect(m_updateTimer, &QTimer::timeout, this, &AudioVisualizer::updateVisualizer);
-    m_updateTimer->start();
-    
+
     // Set background color to match OBS theme
     setAutoFillBackground(true);
     QPalette palette = this->palette();
@@ -31,54 +42,41 @@ AudioVisualizer::AudioVisualizer(QWidget *parent)
 
 AudioVisualizer::~AudioVisualizer()
 {
+    FrameClock::instance().unsubscribe(this);
 }
 
-void AudioVisualizer::updateAudioLevel(float level)
+void AudioVisualizer::setLevelSource(std::function<float()> source)
 {
-    QMutexLocker locker(&m_mutex);
-    
-    // Clamp level to valid range
-    level = std::max(0.0f, std::min(1.0f, level));
-    
-    m_currentLevel = level;
-    
-    // Update peak level
-    if (level > m_peakLevel) {
-        m_peakLevel = level;
-    }
-    
-    // Simulate frequency bands by adding some variation
-    for (int i = 0; i < m_barCount; ++i) {
-        float bandLevel = level;
-        
-        // Add some frequency-based variation
-        if (level > 0.01f) {
-            float variation = 0.3f + 0.7f * std::sin(i * 0.5f + level * 10.0f);
-            bandLevel *= variation;
-        }
-        
-        // Update bar level
-        if (bandLevel > m_barLevels[i]) {
-            m_barLevels[i] = bandLevel;
-        }
-        
-        // Update bar peak
-        if (bandLevel > m_barPeaks[i]) {
-            m_barPeaks[i] = bandLevel;
-        }
-    }
+    m_levelSource = std::move(source);
+}
+
+void AudioVisualizer::setSpectrumSource(const SpectrumAnalyzer *spectrum)
+{
+    m_spectrum = spectrum;
+}
+
+void AudioVisualizer::setLoudnessSource(const LoudnessMeter *loudness)
+{
+    m_loudness = loudness;
+}
+
+void AudioVisualizer::showEvent(QShowEvent *event)
+{
+    // Also fires when the window is restored or the tab becomes current.
+    FrameClock::instance().subscribe(this);
+    QWidget::showEvent(event);
+}
+
+void AudioVisualizer::hideEvent(QHideEvent *event)
+{
+    FrameClock::instance().unsubscribe(this);
+    QWidget::hideEvent(event);
 }
 
 void AudioVisualizer::setEnabled(bool enabled)
 {
     m_enabled = enabled;
-    if (m_updateTimer) {
-        if (enabled && !m_updateTimer->isActive()) m_updateTimer->start();
-        if (!enabled && m_updateTimer->isActive()) m_updateTimer->stop();
-    }
     if (!enabled) {
-        QMutexLocker locker(&m_mutex);
-        m_currentLevel = 0.0f;
         m_peakLevel = 0.0f;
         m_displayLevel = 0.0f;
         std::fill(m_barLevels.begin(), m_barLevels.end(), 0.0f);
@@ -87,102 +85,186 @@ void AudioVisualizer::setEnabled(bool enabled)
     update();
 }
 
-void AudioVisualizer::updateVisualizer()
+bool AudioVisualizer::advanceFrame()
 {
-    QMutexLocker locker(&m_mutex);
-    
+    float level = (m_enabled && m_levelSource) ? m_levelSource() : 0.0f;
+
+    // Clamp level to valid range
+    level = std::max(0.0f, std::min(1.0f, level));
+
     // Smooth level transitions
-    float targetLevel = m_enabled ? m_currentLevel : 0.0f;
-    m_displayLevel = m_displayLevel * 0.8f + targetLevel * 0.2f;
-    
-    // Decay peak level
-    m_peakLevel *= (1.0f - m_peakDecay);
-    
-    // Decay bar levels and peaks
+    m_displayLevel = m_displayLevel * 0.8f + level * 0.2f;
+
+    // Update and decay peak level
+    m_peakLevel = std::max(level, m_peakLevel * (1.0f - m_peakDecay));
+
+    const int barHeight = height() - 2 * kMargin;
+    QRegion dirty;
+    const bool spectrumLive = m_enabled && m_spectrum && m_spectrum->isLive();
+
     for (int i = 0; i < m_barCount; ++i) {
+        // Decay bar levels and peaks
         m_barLevels[i] *= (1.0f - m_levelDecay);
         m_barPeaks[i] *= (1.0f - m_peakDecay);
+
+        const float bandLevel = spectrumLive ? m_spectrum->band(i) : level;
+        m_barLevels[i] = std::max(m_barLevels[i], bandLevel);
+        m_barPeaks[i] = std::max(m_barPeaks[i], bandLevel);
+
+        // Only a change of at least one pixel is worth a repaint
+        const int fill = static_cast<int>(m_barLevels[i] * barHeight);
+        const int peak = static_cast<int>(m_barPeaks[i] * barHeight);
+        if (fill != m_shownFill[i] || peak != m_shownPeak[i]) {
+            m_shownFill[i] = fill;
+            m_shownPeak[i] = peak;
+            dirty += barRect(i);
+        }
     }
-    
-    update();
+
+    QString text;
+    if (m_enabled && m_loudness && m_loudness->isLive()) {
+        text = QString("M %1  S %2 LUFS")
+                   .arg(m_loudness->momentary(), 0, 'f', 1)
+                   .arg(m_loudness->shortTerm(), 0, 'f', 1);
+    } else {
+        text = QString("Level: %1%").arg(static_cast<int>(m_displayLevel * 100));
+    }
+    if (text != m_shownText) {
+        m_shownText = text;
+        dirty += m_textRect;
+    }
+
+    if (dirty.isEmpty()) {
+        return false;
+    }
+    update(dirty);
+    return true;
 }
 
 void AudioVisualizer::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
-    
+    TRACE_SCOPE("AudioVisualizer::paintEvent");
+
     QPainter painter(this);
     painter.setRenderHint(QPainter::Antialiasing, false);
-    
+
     QRect rect = this->rect();
-    
-    // Draw background
-    painter.fillRect(rect, QColor(42, 42, 43));
-    
-    // Draw border
-    painter.setPen(QColor(70, 70, 71));
-    painter.drawRect(rect.adjusted(0, 0, -1, -1));
-    
+
     if (!m_enabled) {
         // Draw disabled state
+        painter.fillRect(rect, QColor(42, 42, 43));
+        painter.setPen(QColor(70, 70, 71));
+        painter.drawRect(rect.adjusted(0, 0, -1, -1));
         painter.setPen(QColor(128, 128, 128));
         painter.drawText(rect, Qt::AlignCenter, "Audio Disabled");
         return;
     }
-    
-    QMutexLocker locker(&m_mutex);
-    
-    // Calculate bar dimensions
-    int margin = 2;
-    int availableWidth = rect.width() - 2 * margin;
-    int barWidth = std::max(1, (availableWidth - (m_barCount - 1)) / m_barCount);
-    int spacing = 1;
-    
-    // Draw bars
+
+    if (m_backgroundCache.isNull() || m_backgroundCache.deviceIndependentSize() != QSizeF(size()) ||
+        m_backgroundCache.devicePixelRatio() != devicePixelRatioF()) {
+        rebuildCaches();
+    }
+
+    // Background, border and empty bar slots, only where something is dirty
+    for (const QRect &dirty : event->region()) {
+        painter.drawPixmap(dirty, m_backgroundCache, cacheRect(dirty));
+    }
+
+    // Lit part of each bar and its peak marker, copied out of the gradients
     for (int i = 0; i < m_barCount; ++i) {
-        int x = margin + i * (barWidth + spacing);
-        int barHeight = rect.height() - 2 * margin;
-        
-        // Calculate bar fill height based on level
-        int fillHeight = static_cast<int>(m_barLevels[i] * barHeight);
-        int peakHeight = static_cast<int>(m_barPeaks[i] * barHeight);
-        
-        // Choose color based on level (green -> yellow -> red like OBS)
-        QColor barColor;
-        float level = m_barLevels[i];
-        if (level < 0.7f) {
-            // Green to yellow
-            int green = 255;
-            int red = static_cast<int>(255 * (level / 0.7f));
-            barColor = QColor(red, green, 0);
-        } else {
-            // Yellow to red
-            int red = 255;
-            int green = static_cast<int>(255 * (1.0f - ((level - 0.7f) / 0.3f)));
-            barColor = QColor(red, green, 0);
+        const QRect slot = barRect(i);
+        if (!event->rect().intersects(slot)) {
+            continue;
         }
-        
-        // Draw background bar (dark)
-        QRect barRect(x, margin + barHeight - barHeight, barWidth, barHeight);
-        painter.fillRect(barRect, QColor(60, 60, 61));
-        
-        // Draw active bar portion
-        if (fillHeight > 0) {
-            QRect fillRect(x, margin + barHeight - fillHeight, barWidth, fillHeight);
-            painter.fillRect(fillRect, barColor);
+
+        if (m_shownFill[i] > 0) {
+            QRect fill(slot.left(), slot.bottom() + 1 - m_shownFill[i], slot.width(), m_shownFill[i]);
+            painter.drawPixmap(fill, m_gradientCache, cacheRect(fill));
         }
-        
-        // Draw peak indicator
-        if (peakHeight > 0 && peakHeight != fillHeight) {
-            QRect peakRect(x, margin + barHeight - peakHeight, barWidth, 2);
-            painter.fillRect(peakRect, barColor.lighter(150));
+        if (m_shownPeak[i] > 0 && m_shownPeak[i] != m_shownFill[i]) {
+            QRect peak(slot.left(), slot.bottom() + 1 - m_shownPeak[i], slot.width(), 2);
+            painter.drawPixmap(peak, m_peakCache, cacheRect(peak));
         }
     }
-    
+
     // Draw level text
-    painter.setPen(QColor(255, 255, 255));
-    QString levelText = QString("Level: %1%").arg(static_cast<int>(m_displayLevel * 100));
-    painter.drawText(rect.adjusted(5, 0, -5, 0), Qt::AlignRight | Qt::AlignBottom, levelText);
+    if (event->rect().intersects(m_textRect)) {
+        painter.setPen(QColor(255, 255, 255));
+        painter.drawText(rect.adjusted(5, 0, -5, 0), Qt::AlignRight | Qt::AlignBottom, m_shownText);
+    }
+}
+
+void AudioVisualizer::resizeEvent(QResizeEvent *event)
+{
+    // Rebuilt lazily on the next paint
+    m_backgroundCache = QPixmap();
+    m_gradientCache = QPixmap();
+    m_peakCache = QPixmap();
+
+    const QFontMetrics metrics(font());
+    const int textWidth = metrics.horizontalAdvance("M -70.0  S -70.0 LUFS");
+    m_textRect = QRect(width() - 5 - textWidth, height() - metrics.height(), textWidth, metrics.height());
+
+    QWidget::resizeEvent(event);
+}
+
+QRect AudioVisualizer::barRect(int index) const
+{
+    const int availableWidth = width() - 2 * kMargin;
+    const int barWidth = std::max(1, (availableWidth - (m_barCount - 1) * kSpacing) / m_barCount);
+    const int barHeight = height() - 2 * kMargin;
+    return QRect(kMargin + index * (barWidth + kSpacing), kMargin, barWidth, barHeight);
+}
+
+QRectF AudioVisualizer::cacheRect(const QRect &widgetRect) const
+{
+    const qreal dpr = m_backgroundCache.devicePixelRatio();
+    return QRectF(widgetRect.x() * dpr, widgetRect.y() * dpr, widgetRect.width() * dpr, widgetRect.height() * dpr);
+}
+
+void AudioVisualizer::rebuildCaches()
+{
+    const qreal dpr = devicePixelRatioF();
+    auto makePixmap = [this, dpr]() {
+        QPixmap pixmap(size() * dpr);
+        pixmap.setDevicePixelRatio(dpr);
+        pixmap.fill(Qt::transparent);
+        return pixmap;
+    };
+    const QRect rect = this->rect();
+
+    // Background, border and the dark empty bar slots
+    m_backgroundCache = makePixmap();
+    {
+        QPainter painter(&m_backgroundCache);
+        painter.fillRect(rect, QColor(42, 42, 43));
+        painter.setPen(QColor(70, 70, 71));
+        painter.drawRect(rect.adjusted(0, 0, -1, -1));
+        for (int i = 0; i < m_barCount; ++i) {
+            painter.fillRect(barRect(i), QColor(60, 60, 61));
+        }
+    }
+
+    // Every bar fully lit: green -> yellow at 70% -> red at the top, like OBS
+    const QRect firstBar = barRect(0);
+    QLinearGradient gradient(0, firstBar.bottom() + 1, 0, firstBar.top());
+    gradient.setColorAt(0.0, QColor(0, 255, 0));
+    gradient.setColorAt(0.7, QColor(255, 255, 0));
+    gradient.setColorAt(1.0, QColor(255, 0, 0));
+
+    QLinearGradient peakGradient(gradient.start(), gradient.finalStop());
+    for (const QGradientStop &stop : gradient.stops()) {
+        peakGradient.setColorAt(stop.first, stop.second.lighter(150));
+    }
+
+    m_gradientCache = makePixmap();
+    m_peakCache = makePixmap();
+    QPainter gradientPainter(&m_gradientCache);
+    QPainter peakPainter(&m_peakCache);
+    for (int i = 0; i < m_barCount; ++i) {
+        gradientPainter.fillRect(barRect(i), gradient);
+        peakPainter.fillRect(barRect(i), peakGradient);
+    }
 }
 
 QSize AudioVisualizer::sizeHint() const
@@ -2,11 +2,15 @@
 
 #include <QWidget>
 #include <QPainter>
-#include <QTimer>
-#include <QMutex>
+#include <QPixmap>
+#include "FrameClock.h"
+#include <functional>
 #include <vector>
 
-class AudioVisualizer : public QWidget
+class SpectrumAnalyzer;
+class LoudnessMeter;
+
+class AudioVisualizer : public QWidget, private FrameClock::Client
 {
     Q_OBJECT
 
@@ -14,29 +18,58 @@ public:
     explicit AudioVisualizer(QWidget *parent = nullptr);
     ~AudioVisualizer();
 
-    void updateAudioLevel(float level); // level should be 0.0 to 1.0
+    // Polled once per frame on the GUI thread; should return 0.0 to 1.0.
+    // Typically reads an atomic written by an OBS volmeter callback.
+    void setLevelSource(std::function<float()> source);
+    // Optional. While it is delivering data the bars show its bands;
+    // otherwise every bar shows the overall level.
+    void setSpectrumSource(const SpectrumAnalyzer *spectrum);
+    // Optional. While live, the readout shows momentary/short-term LUFS
+    // instead of the level percentage.
+    void setLoudnessSource(const LoudnessMeter *loudness);
     void setEnabled(bool enabled);
-    
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
     QSize sizeHint() const override;
-    
-private slots:
-    void updateVisualizer();
 
 private:
-    QTimer *m_updateTimer;
-    QMutex m_mutex;
-    float m_currentLevel;
+    // Advances smoothing/decay by one frame. Returns true if anything visible
+    // changed, in which case a repaint has been scheduled.
+    bool advanceFrame() override;
+
+    // Geometry of bar slot `index`, in widget coordinates
+    QRect barRect(int index) const;
+    QRectF cacheRect(const QRect &widgetRect) const;
+    void rebuildCaches();
+
+    std::function<float()> m_levelSource;
+    const SpectrumAnalyzer *m_spectrum;
+    const LoudnessMeter *m_loudness;
     float m_peakLevel;
     float m_displayLevel;
     bool m_enabled;
-    
+
     // Visual properties
     static constexpr int m_barCount = 20;
     static constexpr float m_peakDecay = 0.05f;
     static constexpr float m_levelDecay = 0.1f;
-    
+
     std::vector<float> m_barLevels;
     std::vector<float> m_barPeaks;
-};
\ No newline at end of file
+
+    // What the last paint showed, in pixels/text, to skip no-op repaints
+    std::vector<int> m_shownFill;
+    std::vector<int> m_shownPeak;
+    QString m_shownText;
+
+    // Pre-rendered at widget size, rebuilt after a resize. Painting a frame
+    // is just clipped blits out of these.
+    QPixmap m_backgroundCache;
+    QPixmap m_gradientCache; // Every bar fully lit
+    QPixmap m_peakCache;     // Same, lighter, for the peak markers
+    QRect m_textRect;        // Where the level text can end up
+};
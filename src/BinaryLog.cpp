@@ -0,0 +1,350 @@
+#include "BinaryLog.h"
+#include <QDateTime>
+#include <QHash>
+#include <QList>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
+
+namespace BinaryLog
+{
+namespace
+{
+// Lock-free so formatString() is safe on any logging hot path. Slots are
+// written once and never change; ID 0 (plain text) is implicit.
+constexpr int kMaxFormats = 4096;
+std::array<std::atomic<const char *>, kMaxFormats> g_formats{};
+std::atomic<int> g_formatCount{1};
+
+template <typename T>
+void appendRaw(QByteArray &out, T value)
+{
+    const T v = qToLittleEndian(value);
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+void appendString(QByteArray &out, const char *data, qsizetype size)
+{
+    out.append(static_cast<char>(ArgType::String));
+    appendRaw<quint32>(out, static_cast<quint32>(size));
+    out.append(data, size);
+}
+
+// Bounds-checked little-endian reader over a byte buffer.
+class Cursor
+{
+public:
+    Cursor(const char *data, qsizetype size) : m_data(data), m_size(size), m_pos(0) {}
+
+    bool atEnd() const { return m_pos >= m_size; }
+    qsizetype position() const { return m_pos; }
+
+    template <typename T>
+    bool read(T &value)
+    {
+        if (m_size - m_pos < static_cast<qsizetype>(sizeof(T)))
+            return false;
+        T raw;
+        std::memcpy(&raw, m_data + m_pos, sizeof(T));
+        value = qFromLittleEndian(raw);
+        m_pos += sizeof(T);
+        return true;
+    }
+
+    bool readBytes(quint32 length, QByteArray &out)
+    {
+        if (m_size - m_pos < static_cast<qsizetype>(length))
+            return false;
+        out = QByteArray(m_data + m_pos, length);
+        m_pos += length;
+        return true;
+    }
+
+private:
+    const char *m_data;
+    qsizetype m_size;
+    qsizetype m_pos;
+};
+} // namespace
+
+quint16 registerFormat(const char *format)
+{
+    const int id = g_formatCount.fetch_add(1, std::memory_order_relaxed);
+    if (id >= kMaxFormats)
+        return kTextFormatId; // Out of IDs: degrade to plain text (first argument only)
+    g_formats[id].store(format, std::memory_order_release);
+    return static_cast<quint16>(id);
+}
+
+const char *formatString(quint16 id)
+{
+    if (id == kTextFormatId)
+        return "%1";
+    const char *format = id < kMaxFormats ? g_formats[id].load(std::memory_order_acquire) : nullptr;
+    return format ? format : "<unknown format %1>";
+}
+
+void appendArg(QByteArray &out, const char *value)
+{
+    if (!value)
+        value = "(null)";
+    appendString(out, value, static_cast<qsizetype>(std::strlen(value)));
+}
+
+void appendArg(QByteArray &out, const std::string &value)
+{
+    appendString(out, value.data(), static_cast<qsizetype>(value.size()));
+}
+
+void appendArg(QByteArray &out, const QString &value)
+{
+    const QByteArray utf8 = value.toUtf8();
+    appendString(out, utf8.constData(), utf8.size());
+}
+
+void appendArg(QByteArray &out, const QByteArray &value)
+{
+    appendString(out, value.constData(), value.size());
+}
+
+void appendArg(QByteArray &out, double value)
+{
+    quint64 bits;
+    static_assert(sizeof(bits) == sizeof(value), "unexpected double size");
+    std::memcpy(&bits, &value, sizeof(bits));
+    out.append(static_cast<char>(ArgType::Double));
+    appendRaw<quint64>(out, bits);
+}
+
+QStringList decodeArgs(const QByteArray &args)
+{
+    QStringList result;
+    Cursor cursor(args.constData(), args.size());
+    while (!cursor.atEnd())
+    {
+        quint8 type = 0;
+        if (!cursor.read(type))
+            break;
+
+        switch (static_cast<ArgType>(type))
+        {
+        case ArgType::Int:
+        {
+            qint64 v = 0;
+            if (!cursor.read(v))
+                return result;
+            result.append(QString::number(v));
+            break;
+        }
+        case ArgType::UInt:
+        {
+            quint64 v = 0;
+            if (!cursor.read(v))
+                return result;
+            result.append(QString::number(v));
+            break;
+        }
+        case ArgType::Double:
+        {
+            quint64 bits = 0;
+            if (!cursor.read(bits))
+                return result;
+            double v;
+            std::memcpy(&v, &bits, sizeof(v));
+            result.append(QString::number(v));
+            break;
+        }
+        case ArgType::String:
+        {
+            quint32 length = 0;
+            QByteArray bytes;
+            if (!cursor.read(length) || !cursor.readBytes(length, bytes))
+                return result;
+            result.append(QString::fromUtf8(bytes));
+            break;
+        }
+        default:
+            return result; // Unknown tag: the rest of the buffer can't be trusted
+        }
+    }
+    return result;
+}
+
+// "%1".."%99" at format[i]: its number, and its length in length
+static int placeholderAt(const QString &format, qsizetype i, qsizetype &length)
+{
+    if (format[i] != u'%' || i + 1 >= format.size() || !format[i + 1].isDigit())
+        return 0;
+    int number = format[i + 1].digitValue();
+    length = 2;
+    if (i + 2 < format.size() && format[i + 2].isDigit())
+    {
+        number = number * 10 + format[i + 2].digitValue();
+        length = 3;
+    }
+    return number;
+}
+
+QString formatMessage(const QString &format, const QByteArray &args)
+{
+    // One pass over the format, like the multi-argument QString::arg: the
+    // lowest placeholder number gets the first argument, the next one the
+    // second, and so on. Argument text is never scanned again, so a "%1" in
+    // a path comes out as is.
+    const QStringList values = decodeArgs(args);
+    QList<int> numbers;
+    qsizetype length = 0;
+    for (qsizetype i = 0; i < format.size(); ++i)
+    {
+        const int number = placeholderAt(format, i, length);
+        if (number > 0 && !numbers.contains(number))
+            numbers.append(number);
+    }
+    std::sort(numbers.begin(), numbers.end());
+
+    QString text;
+    text.reserve(format.size());
+    for (qsizetype i = 0; i < format.size();)
+    {
+        const qsizetype rank = numbers.indexOf(placeholderAt(format, i, length));
+        if (rank >= 0 && rank < values.size())
+        {
+            text += values[rank];
+            i += length;
+        }
+        else
+        {
+            text += format[i++];
+        }
+    }
+    return text;
+}
+
+const char *levelName(int level)
+{
+    switch (level)
+    {
+    case QtDebugMsg:
+        return "DEBUG";
+    case QtInfoMsg:
+        return "INFO";
+    case QtWarningMsg:
+        return "WARN";
+    case QtCriticalMsg:
+        return "CRITICAL";
+    case QtFatalMsg:
+        return "FATAL";
+    }
+    return "UNKNOWN";
+}
+
+QString formatLine(qint64 wallMs, int level, const QString &text)
+{
+    return QString("%1 [%2] %3")
+        .arg(QDateTime::fromMSecsSinceEpoch(wallMs).toString("yyyy-MM-dd hh:mm:ss.zzz"))
+        .arg(levelName(level))
+        .arg(text);
+}
+
+void Writer::beginFile(QByteArray &out)
+{
+    out.append(kMagic, kMagicSize);
+}
+
+void Writer::beginSession(QByteArray &out, qint64 wallMs, quint64 monotonicNs)
+{
+    m_definedFormats.clear();
+    out.append(static_cast<char>(RecordKind::Session));
+    appendRaw<qint64>(out, wallMs);
+    appendRaw<quint64>(out, monotonicNs);
+}
+
+void Writer::appendEntry(QByteArray &out, quint16 formatId, int level, quint64 monotonicNs, const QByteArray &args)
+{
+    if (formatId != kTextFormatId && !m_definedFormats.contains(formatId))
+    {
+        const char *format = formatString(formatId);
+        const quint32 length = static_cast<quint32>(std::strlen(format));
+        out.append(static_cast<char>(RecordKind::FormatDef));
+        appendRaw<quint16>(out, formatId);
+        appendRaw<quint32>(out, length);
+        out.append(format, length);
+        m_definedFormats.insert(formatId);
+    }
+
+    out.append(static_cast<char>(RecordKind::Entry));
+    appendRaw<quint16>(out, formatId);
+    out.append(static_cast<char>(level));
+    appendRaw<quint64>(out, monotonicNs);
+    appendRaw<quint32>(out, static_cast<quint32>(args.size()));
+    out.append(args);
+}
+
+bool decode(const QByteArray &data, const std::function<void(const DecodedEntry &)> &sink, QString *error)
+{
+    auto fail = [error](const QString &message, qsizetype offset)
+    {
+        if (error)
+            *error = QString("%1 at offset %2").arg(message).arg(offset);
+        return false;
+    };
+
+    if (data.size() < kMagicSize || std::memcmp(data.constData(), kMagic, kMagicSize) != 0)
+        return fail("Not a binary log (bad magic)", 0);
+
+    Cursor cursor(data.constData() + kMagicSize, data.size() - kMagicSize);
+    QHash<quint16, QString> formats;
+    qint64 sessionWallMs = 0;
+    quint64 sessionMonotonicNs = 0;
+
+    while (!cursor.atEnd())
+    {
+        const qsizetype offset = kMagicSize + cursor.position();
+        quint8 kind = 0;
+        cursor.read(kind);
+
+        switch (static_cast<RecordKind>(kind))
+        {
+        case RecordKind::Session:
+            if (!cursor.read(sessionWallMs) || !cursor.read(sessionMonotonicNs))
+                return fail("Truncated session record", offset);
+            formats.clear();
+            break;
+        case RecordKind::FormatDef:
+        {
+            quint16 id = 0;
+            quint32 length = 0;
+            QByteArray format;
+            if (!cursor.read(id) || !cursor.read(length) || !cursor.readBytes(length, format))
+                return fail("Truncated format record", offset);
+            formats.insert(id, QString::fromUtf8(format));
+            break;
+        }
+        case RecordKind::Entry:
+        {
+            quint16 id = 0;
+            quint8 level = 0;
+            quint64 monotonicNs = 0;
+            quint32 length = 0;
+            QByteArray args;
+            if (!cursor.read(id) || !cursor.read(level) || !cursor.read(monotonicNs) ||
+                !cursor.read(length) || !cursor.readBytes(length, args))
+                return fail("Truncated entry record", offset);
+
+            DecodedEntry entry;
+            entry.level = level;
+            entry.wallMs = sessionWallMs + static_cast<qint64>((monotonicNs - sessionMonotonicNs) / 1000000);
+            const QString format = id == kTextFormatId ? QStringLiteral("%1")
+                                                       : formats.value(id, QStringLiteral("<undefined format %1>").arg(id));
+            entry.text = formatMessage(format, args);
+            sink(entry);
+            break;
+        }
+        default:
+            return fail(QString("Unknown record kind %1").arg(kind), offset);
+        }
+    }
+    return true;
+}
+} // namespace BinaryLog
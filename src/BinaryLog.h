@@ -0,0 +1,120 @@
+#pragma once
+
+#include <QByteArray>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+#include <QtEndian>
+#include <QtGlobal>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <type_traits>
+
+// Compact on-disk log format: every entry is a format-string ID, a level, a
+// monotonic timestamp and the raw arguments. Text is only produced by whoever
+// reads the log (LogDialog or the offline decoder).
+//
+// File layout (all integers little-endian):
+//   "ORCBLOG1"                                          magic, once per file
+//   [u8 Session][i64 wallMs][u64 monotonicNs]           start of a process session
+//   [u8 FormatDef][u16 id][u32 len][utf8 format]        before an ID's first use in a session
+//   [u8 Entry][u16 id][u8 level][u64 monotonicNs][u32 len][args]
+// Format ID 0 is reserved for plain text messages and always means "%1".
+namespace BinaryLog
+{
+enum class RecordKind : quint8
+{
+    Session = 1,
+    FormatDef = 2,
+    Entry = 3
+};
+
+enum class ArgType : quint8
+{
+    Int = 1,
+    UInt = 2,
+    Double = 3,
+    String = 4
+};
+
+constexpr char kMagic[] = "ORCBLOG1";
+constexpr int kMagicSize = 8;
+constexpr quint16 kTextFormatId = 0;
+
+inline quint64 monotonicNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+// Format registry. IDs are only stable within one process; files carry their
+// own FormatDef records so the decoder never needs the binary.
+quint16 registerFormat(const char *format);
+const char *formatString(quint16 id);
+
+// --- Argument encoding ---
+void appendArg(QByteArray &out, const char *value);
+void appendArg(QByteArray &out, const std::string &value);
+void appendArg(QByteArray &out, const QString &value);
+void appendArg(QByteArray &out, const QByteArray &value);
+void appendArg(QByteArray &out, double value);
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T> && std::is_signed_v<T>> appendArg(QByteArray &out, T value)
+{
+    const qint64 v = qToLittleEndian(static_cast<qint64>(value));
+    out.append(static_cast<char>(ArgType::Int));
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+template <typename T>
+std::enable_if_t<std::is_integral_v<T> && std::is_unsigned_v<T>> appendArg(QByteArray &out, T value)
+{
+    const quint64 v = qToLittleEndian(static_cast<quint64>(value));
+    out.append(static_cast<char>(ArgType::UInt));
+    out.append(reinterpret_cast<const char *>(&v), sizeof(v));
+}
+
+inline void appendArg(QByteArray &out, float value) { appendArg(out, static_cast<double>(value)); }
+
+inline QByteArray encodeArgs() { return QByteArray(); }
+
+template <typename... Args>
+QByteArray encodeArgs(const Args &...args)
+{
+    QByteArray out;
+    (appendArg(out, args), ...);
+    return out;
+}
+
+// --- Text rendering (shared by the app and the decoder) ---
+QStringList decodeArgs(const QByteArray &args);
+QString formatMessage(const QString &format, const QByteArray &args);
+const char *levelName(int level);
+QString formatLine(qint64 wallMs, int level, const QString &text);
+
+// Appends binary records to a buffer, emitting FormatDef records on demand.
+class Writer
+{
+public:
+    void beginFile(QByteArray &out);
+    void beginSession(QByteArray &out, qint64 wallMs, quint64 monotonicNs);
+    void appendEntry(QByteArray &out, quint16 formatId, int level, quint64 monotonicNs, const QByteArray &args);
+
+private:
+    QSet<quint16> m_definedFormats;
+};
+
+struct DecodedEntry
+{
+    qint64 wallMs = 0;
+    int level = 0;
+    QString text;
+};
+
+// Decodes a whole binary log. Returns false (with a message in *error) on a
+// malformed or truncated file; entries decoded before the problem are still delivered.
+bool decode(const QByteArray &data, const std::function<void(const DecodedEntry &)> &sink, QString *error = nullptr);
+} // namespace BinaryLog
@@ -0,0 +1,69 @@
+#include "ClipIndex.h"
+#include "Logger.h"
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QSaveFile>
+
+namespace ClipIndex
+{
+namespace
+{
+constexpr int kVersion = 1;
+}
+
+QString indexPath(const QString &outputFolder)
+{
+    return QDir(outputFolder).filePath("clips.json");
+}
+
+bool update(const QString &outputFolder, const QString &clipPath, const QJsonObject &fields)
+{
+    const QString path = indexPath(outputFolder);
+    const QString key = QDir(outputFolder).relativeFilePath(clipPath);
+
+    QJsonObject root;
+    QFile existing(path);
+    if (existing.open(QIODevice::ReadOnly))
+    {
+        QJsonParseError error;
+        const QJsonDocument document = QJsonDocument::fromJson(existing.readAll(), &error);
+        if (document.isObject())
+            root = document.object();
+        else
+            LOG_WARN("Clip index %1 is unreadable (%2), starting a new one", path, error.errorString());
+    }
+
+    QJsonArray clips = root.value("clips").toArray();
+    int index = -1;
+    for (int i = 0; i < clips.size(); ++i)
+    {
+        if (clips.at(i).toObject().value("file").toString() == key)
+        {
+            index = i;
+            break;
+        }
+    }
+
+    QJsonObject entry = index >= 0 ? clips.at(index).toObject() : QJsonObject{{"file", key}};
+    for (auto it = fields.begin(); it != fields.end(); ++it)
+        entry.insert(it.key(), it.value());
+    if (index >= 0)
+        clips.replace(index, entry);
+    else
+        clips.append(entry);
+
+    root.insert("version", kVersion);
+    root.insert("clips", clips);
+
+    const QByteArray json = QJsonDocument(root).toJson(QJsonDocument::Indented);
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit())
+    {
+        LOG_WARN("Failed to write clip index %1", path);
+        return false;
+    }
+    return true;
+}
+} // namespace ClipIndex
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <QJsonObject>
+#include <QString>
+
+// clips.json in the output folder: one entry per saved clip, keyed by its path
+// relative to that folder, carrying whatever the app learned about the clip
+// at save time (game, length, loudness, post-processing). OBS control thread
+// only (see ObsControlThread).
+namespace ClipIndex
+{
+QString indexPath(const QString &outputFolder);
+
+// Merges `fields` into the clip's entry, creating it if needed. The index is
+// rewritten atomically. Returns false if it couldn't be written.
+bool update(const QString &outputFolder, const QString &clipPath, const QJsonObject &fields);
+} // namespace ClipIndex
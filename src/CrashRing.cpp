@@ -0,0 +1,200 @@
+#include "CrashRing.h"
+#include "BinaryLog.h"
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+static_assert(sizeof(std::atomic<quint64>) == sizeof(quint64), "slot sequence must be a plain 64-bit word");
+
+CrashRing::~CrashRing()
+{
+    if (m_map) {
+        m_file.unmap(m_map);
+    }
+}
+
+QString CrashRing::open(const QString& ringPath, const QString& reportDir, qint64 sessionWallMs, quint64 sessionMonotonicNs)
+{
+    static_assert(sizeof(Header) <= kSlotSize, "header must fit in the first slot");
+    const qint64 fileSize = static_cast<qint64>(kSlotSize) * (kSlotCount + 1);
+
+    m_file.setFileName(ringPath);
+    if (!m_file.open(QIODevice::ReadWrite)) {
+        return QString();
+    }
+
+    // Recover before the mapping is reinitialized for this session.
+    QString report;
+    if (m_file.size() == fileSize) {
+        if (uchar* previous = m_file.map(0, fileSize)) {
+            report = recover(previous, fileSize, reportDir);
+            m_file.unmap(previous);
+        }
+    }
+
+    if (m_file.size() != fileSize && !m_file.resize(fileSize)) {
+        m_file.close();
+        return report;
+    }
+    m_map = m_file.map(0, fileSize);
+    if (!m_map) {
+        m_file.close();
+        return report;
+    }
+
+    std::memset(m_map, 0, fileSize);
+    Header* header = reinterpret_cast<Header*>(m_map);
+    std::memcpy(header->magic, kMagic, sizeof(header->magic));
+    header->version = kVersion;
+    header->slotSize = kSlotSize;
+    header->slotCount = kSlotCount;
+    header->sessionWallMs = sessionWallMs;
+    header->sessionMonotonicNs = sessionMonotonicNs;
+    header->state = kStateRunning;
+    return report;
+}
+
+char* CrashRing::claimSlot(quint64 monotonicNs, int level, PayloadKind kind, quint64& sequence)
+{
+    if (!m_map) {
+        return nullptr;
+    }
+
+    sequence = m_nextSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    char* slot = reinterpret_cast<char*>(m_map) + kSlotSize * (1 + (sequence - 1) % kSlotCount);
+
+    // Invalidate the slot before touching the payload so a crash mid-write
+    // leaves an empty slot rather than a torn record.
+    reinterpret_cast<std::atomic<quint64>*>(slot)->store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+
+    SlotHeader* header = reinterpret_cast<SlotHeader*>(slot);
+    header->monotonicNs = monotonicNs;
+    header->level = static_cast<quint8>(level);
+    header->kind = static_cast<quint8>(kind);
+    return slot;
+}
+
+void CrashRing::commitSlot(char* slot, quint64 sequence)
+{
+    reinterpret_cast<std::atomic<quint64>*>(slot)->store(sequence, std::memory_order_release);
+}
+
+void CrashRing::append(quint64 monotonicNs, int level, const QString& text)
+{
+    quint64 sequence = 0;
+    char* slot = claimSlot(monotonicNs, level, PayloadKind::Utf16Text, sequence);
+    if (!slot) {
+        return;
+    }
+
+    const quint32 bytes = std::min<quint32>(static_cast<quint32>(text.size() * sizeof(char16_t)), kPayloadSize & ~1u);
+    SlotHeader* header = reinterpret_cast<SlotHeader*>(slot);
+    header->formatLength = 0;
+    header->payloadLength = static_cast<quint16>(bytes);
+    std::memcpy(slot + sizeof(SlotHeader), text.constData(), bytes);
+    commitSlot(slot, sequence);
+}
+
+void CrashRing::appendFormatted(quint64 monotonicNs, int level, const char* format, const QByteArray& args)
+{
+    quint64 sequence = 0;
+    char* slot = claimSlot(monotonicNs, level, PayloadKind::Formatted, sequence);
+    if (!slot) {
+        return;
+    }
+
+    // Truncated arguments are dropped by decodeArgs() at the first incomplete one.
+    const quint32 formatBytes = std::min<quint32>(static_cast<quint32>(std::strlen(format)), kPayloadSize);
+    const quint32 argBytes = std::min<quint32>(static_cast<quint32>(args.size()), kPayloadSize - formatBytes);
+    SlotHeader* header = reinterpret_cast<SlotHeader*>(slot);
+    header->formatLength = static_cast<quint16>(formatBytes);
+    header->payloadLength = static_cast<quint16>(formatBytes + argBytes);
+    std::memcpy(slot + sizeof(SlotHeader), format, formatBytes);
+    std::memcpy(slot + sizeof(SlotHeader) + formatBytes, args.constData(), argBytes);
+    commitSlot(slot, sequence);
+}
+
+void CrashRing::markCleanShutdown()
+{
+    if (m_map) {
+        reinterpret_cast<Header*>(m_map)->state = kStateClean;
+    }
+}
+
+QString CrashRing::recover(const uchar* data, qint64 size, const QString& reportDir) const
+{
+    Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(header.magic)) != 0 || header.version != kVersion ||
+        header.slotSize != kSlotSize || header.slotCount != kSlotCount || header.state != kStateRunning) {
+        return QString();
+    }
+
+    struct Recovered
+    {
+        quint64 sequence;
+        qint64 wallMs;
+        int level;
+        QString text;
+    };
+    std::vector<Recovered> records;
+
+    for (quint32 i = 0; i < kSlotCount; ++i) {
+        const uchar* slot = data + static_cast<qint64>(kSlotSize) * (i + 1);
+        if (slot + kSlotSize > data + size) {
+            break;
+        }
+
+        SlotHeader sh;
+        std::memcpy(&sh, slot, sizeof(sh));
+        if (sh.sequence == 0 || sh.payloadLength > kPayloadSize || sh.formatLength > sh.payloadLength) {
+            continue;
+        }
+
+        const char* payload = reinterpret_cast<const char*>(slot + sizeof(SlotHeader));
+        QString text;
+        if (sh.kind == static_cast<quint8>(PayloadKind::Utf16Text)) {
+            text = QString(reinterpret_cast<const QChar*>(payload), sh.payloadLength / sizeof(char16_t));
+        } else if (sh.kind == static_cast<quint8>(PayloadKind::Formatted)) {
+            const QString format = QString::fromUtf8(payload, sh.formatLength);
+            text = BinaryLog::formatMessage(format, QByteArray(payload + sh.formatLength, sh.payloadLength - sh.formatLength));
+        } else {
+            continue;
+        }
+
+        const qint64 wallMs = header.sessionWallMs + static_cast<qint64>((sh.monotonicNs - header.sessionMonotonicNs) / 1000000);
+        records.push_back({sh.sequence, wallMs, sh.level, text});
+    }
+
+    if (records.empty()) {
+        return QString();
+    }
+    std::sort(records.begin(), records.end(), [](const Recovered& a, const Recovered& b) { return a.sequence < b.sequence; });
+
+    QDir dir(reportDir);
+    const QString stamp = QDateTime::fromMSecsSinceEpoch(records.back().wallMs).toString("yyyyMMdd-hhmmss");
+    const QString reportPath = dir.filePath(QString("crash-%1.txt").arg(stamp));
+
+    QByteArray text;
+    text += "The previous session did not shut down cleanly. Its last "
+            + QByteArray::number(static_cast<qulonglong>(records.size())) + " log records follow.\n\n";
+    for (const Recovered& r : records) {
+        text += BinaryLog::formatLine(r.wallMs, r.level, r.text).toUtf8();
+        text += '\n';
+    }
+
+    QSaveFile file(reportPath);
+    if (!file.open(QIODevice::WriteOnly) || file.write(text) != text.size() || !file.commit()) {
+        return QString();
+    }
+
+    QStringList reports = dir.entryList({"crash-*.txt"}, QDir::Files, QDir::Name);
+    while (reports.size() > kMaxCrashReports) {
+        QFile::remove(dir.filePath(reports.takeFirst()));
+    }
+    return reportPath;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <atomic>
+
+// Fixed-size, memory-mapped ring holding the most recent log records. Writing
+// a record is a slot claim plus a memcpy into mapped memory, with no syscall,
+// so the lines survive in the OS page cache even if the process dies in the
+// middle of an OBS call. The next start turns them into a crash report.
+//
+// File layout (native endianness, it is only read back on the same machine):
+//   Header, padded to kSlotSize
+//   kSlotCount slots of kSlotSize bytes: SlotHeader followed by the payload
+class CrashRing
+{
+public:
+    CrashRing() = default;
+    ~CrashRing();
+    CrashRing(const CrashRing&) = delete;
+    CrashRing& operator=(const CrashRing&) = delete;
+
+    // Maps ringPath. If the previous session didn't shut down cleanly, its
+    // records are written to a crash-<timestamp>.txt in reportDir first and
+    // that path is returned; otherwise returns an empty string.
+    QString open(const QString& ringPath, const QString& reportDir, qint64 sessionWallMs, quint64 sessionMonotonicNs);
+
+    // Safe from any thread. Payloads that don't fit in a slot are truncated.
+    void append(quint64 monotonicNs, int level, const QString& text);
+    void appendFormatted(quint64 monotonicNs, int level, const char* format, const QByteArray& args);
+
+    // Marks the ring so the next start doesn't report a crash.
+    void markCleanShutdown();
+
+private:
+    enum class PayloadKind : quint8
+    {
+        Utf16Text = 0, // Raw QString data
+        Formatted = 1  // UTF-8 format string, then BinaryLog-encoded arguments
+    };
+
+    struct Header
+    {
+        char magic[8];
+        quint32 version;
+        quint32 slotSize;
+        quint32 slotCount;
+        quint32 state;
+        qint64 sessionWallMs;
+        quint64 sessionMonotonicNs;
+    };
+
+    struct SlotHeader
+    {
+        quint64 sequence; // 0 while empty or being written; set last
+        quint64 monotonicNs;
+        quint8 level;
+        quint8 kind;
+        quint16 formatLength;
+        quint16 payloadLength;
+        quint16 reserved;
+    };
+
+    static constexpr char kMagic[] = "ORCRING1";
+    static constexpr quint32 kVersion = 1;
+    static constexpr quint32 kSlotSize = 512;
+    static constexpr quint32 kSlotCount = 2048; // 1 MB of recent history
+    static constexpr quint32 kPayloadSize = kSlotSize - sizeof(SlotHeader);
+    static constexpr quint32 kStateRunning = 1;
+    static constexpr quint32 kStateClean = 2;
+    static constexpr int kMaxCrashReports = 5;
+
+    char* claimSlot(quint64 monotonicNs, int level, PayloadKind kind, quint64& sequence);
+    void commitSlot(char* slot, quint64 sequence);
+    QString recover(const uchar* data, qint64 size, const QString& reportDir) const;
+
+    QFile m_file;
+    uchar* m_map = nullptr;
+    std::atomic<quint64> m_nextSequence{0};
+};
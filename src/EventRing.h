@@ -0,0 +1,78 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Bounded lock-free multi-producer / single-consumer ring (Vyukov's bounded
+// queue: every slot carries a sequence number telling producers and the
+// consumer whose turn it is). All slots are allocated up front, so pushing
+// never allocates; a full ring rejects the element instead. T is copied in
+// and out, so keep it small and trivially copyable.
+template <typename T, std::size_t Capacity>
+class EventRing
+{
+    static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "capacity must be a power of two");
+    static_assert(std::is_trivially_copyable_v<T>, "events are copied into preallocated slots");
+
+public:
+    EventRing()
+    {
+        for (std::size_t i = 0; i < Capacity; ++i) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    EventRing(const EventRing&) = delete;
+    EventRing& operator=(const EventRing&) = delete;
+
+    // Any thread. Returns false if the ring is full.
+    bool tryPush(const T& value)
+    {
+        std::size_t position = m_head.load(std::memory_order_relaxed);
+        for (;;) {
+            Slot& slot = m_slots[position & kMask];
+            const std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+            const auto diff = static_cast<std::ptrdiff_t>(sequence) - static_cast<std::ptrdiff_t>(position);
+            if (diff == 0) {
+                if (m_head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    slot.value = value;
+                    slot.sequence.store(position + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                position = m_head.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consumer thread only. Returns false if the ring is empty or the next
+    // producer is half-way through its push.
+    bool tryPop(T& out)
+    {
+        Slot& slot = m_slots[m_tail & kMask];
+        if (slot.sequence.load(std::memory_order_acquire) != m_tail + 1) {
+            return false;
+        }
+        out = slot.value;
+        slot.sequence.store(m_tail + Capacity, std::memory_order_release);
+        ++m_tail;
+        return true;
+    }
+
+private:
+    static constexpr std::size_t kMask = Capacity - 1;
+
+    struct Slot
+    {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    std::array<Slot, Capacity> m_slots;
+    alignas(64) std::atomic<std::size_t> m_head{0}; // producers
+    alignas(64) std::size_t m_tail = 0;             // consumer only
+};
@@ -0,0 +1,81 @@
+#include "FrameClock.h"
+#include <QCoreApplication>
+#include <QTimer>
+#include <QDebug>
+
+FrameClock &FrameClock::instance()
+{
+    static FrameClock *clock = new FrameClock;
+    return *clock;
+}
+
+FrameClock::FrameClock() : m_timer(new QTimer(QCoreApplication::instance()))
+{
+    m_timer->setInterval(16);
+    QObject::connect(m_timer, &QTimer::timeout, [this]() { tick(); });
+}
+
+void FrameClock::subscribe(Client *client)
+{
+    if (m_subscribers.contains(client)) {
+        return;
+    }
+    m_subscribers.append(client);
+    if (!m_suspended) {
+        start();
+    }
+}
+
+void FrameClock::unsubscribe(Client *client)
+{
+    m_subscribers.removeAll(client);
+    if (m_subscribers.isEmpty()) {
+        stop();
+    }
+}
+
+void FrameClock::setSuspended(bool suspended)
+{
+    if (suspended == m_suspended) {
+        return;
+    }
+    m_suspended = suspended;
+    if (suspended) {
+        stop();
+    } else if (!m_subscribers.isEmpty()) {
+        start();
+    }
+}
+
+void FrameClock::start()
+{
+    if (!m_timer->isActive()) {
+        m_ticks = m_repaints = m_idleTicks = 0;
+        m_runTime.start();
+        m_timer->start();
+    }
+}
+
+void FrameClock::stop()
+{
+    if (m_timer->isActive()) {
+        m_timer->stop();
+        qDebug() << "Meter frame clock stopped after" << m_runTime.elapsed() << "ms:"
+                 << m_ticks << "ticks," << m_repaints << "repaints," << m_idleTicks << "idle wakeups";
+    }
+}
+
+void FrameClock::tick()
+{
+    ++m_ticks;
+    int repainted = 0;
+    for (Client *client : m_subscribers) {
+        if (client->advanceFrame()) {
+            ++repainted;
+        }
+    }
+    m_repaints += repainted;
+    if (repainted == 0) {
+        ++m_idleTicks;
+    }
+}
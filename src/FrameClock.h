@@ -0,0 +1,43 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QList>
+
+class QTimer;
+
+// One ~60 Hz timer shared by every animated meter widget, running only while
+// at least one of them is visible and the clock isn't suspended. Clients
+// subscribe in showEvent and unsubscribe in hideEvent/destructor.
+class FrameClock
+{
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+        // Advances the client by one frame. Returns true if it scheduled a repaint.
+        virtual bool advanceFrame() = 0;
+    };
+
+    static FrameClock &instance();
+
+    void subscribe(Client *client);
+    void unsubscribe(Client *client);
+    // Stops the timer even with subscribers left, e.g. while the window is
+    // minimized (its widgets still count as visible then)
+    void setSuspended(bool suspended);
+
+private:
+    FrameClock();
+    void tick();
+    void start();
+    void stop();
+
+    QTimer *m_timer;
+    QList<Client *> m_subscribers;
+    bool m_suspended = false;
+    QElapsedTimer m_runTime;
+    quint64 m_ticks = 0;
+    quint64 m_repaints = 0;
+    quint64 m_idleTicks = 0;
+};
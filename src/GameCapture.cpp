@@ -1,4 +1,10 @@
 #include "GameCapture.h"
+#include "Logger.h"
+#include "Trace.h"
+#include "ClipIndex.h"
+#include "NoiseSuppressionCalibrator.h"
+#include "AudioReplayBuffer.h"
+#include "ObsEventBridge.h"
 #include <obs.hpp>
 #include <obs-module.h>
 #include <obs-encoder.h>
@@ -16,6 +22,11 @@
 #include <QRegularExpression>
 #include <QFileInfo>
 #include <QFile>
+#include <QDateTime>
+#include <QJsonObject>
+#include <QProcess>
+#include <algorithm>
+#include <cmath>
 #include <tuple>
 #include <unordered_map>
 
@@ -39,46 +50,38 @@ static QString GetPathForGameName(const QString &outputFolder, const QString &ga
     return cleanGameName.isEmpty() ? baseFolder + "/General" : baseFolder + "/" + cleanGameName;
 }
 
-// Static callback functions for OBS signals
-static void onBufferStopSignal(void *data, calldata_t *cd);
+// How long a stopping buffer output, and a save, get before giving up on them
+static constexpr int kOutputStopTimeoutMs = 3000;
+static constexpr int kSaveTimeoutMs = 30000;
 
-static void replay_buffer_saved_callback(void *data, calldata_t *cd)
+static double roundedTenth(double value)
 {
-    if (!data || !cd)
-    {
-        qDebug() << "Invalid callback data";
-        return;
-    }
-
-    GameCapture *capture = static_cast<GameCapture *>(data);
-
-    // OBS can use different keys for the path parameter
-    const char *path = calldata_string(cd, "path");
-    if (!path || strlen(path) == 0)
-        path = calldata_string(cd, "file");
-    if (!path || strlen(path) == 0)
-        path = calldata_string(cd, "filename");
-    if (!path || strlen(path) == 0)
-        path = calldata_string(cd, "output_path");
-
-    qDebug() << "Replay buffer saved callback - path:" << (path ? path : "null");
-
-    QString pathStr = path ? QString::fromUtf8(path) : QString();
-
-    // Use queued connection to avoid threading issues
-    QMetaObject::invokeMethod(capture, [capture, pathStr]()
-                              { capture->handleReplayBufferSaved(pathStr); }, Qt::QueuedConnection);
+    return std::round(value * 10.0) / 10.0;
 }
 
-static void onBufferStopSignal(void *data, calldata_t *cd)
+// A clip's "loudness" entry in the clip index
+static QJsonObject loudnessJson(const LoudnessStats &stats)
 {
-    Q_UNUSED(cd)
-    if (!data)
-        return;
+    return QJsonObject{
+        {"integratedLufs", roundedTenth(stats.integrated)},
+        {"maxMomentaryLufs", roundedTenth(stats.maxMomentary)},
+        {"maxShortTermLufs", roundedTenth(stats.maxShortTerm)},
+        {"samplePeakDbfs", roundedTenth(stats.samplePeak)},
+        {"measuredSeconds", roundedTenth(stats.seconds)},
+        {"partial", stats.partial}};
+}
 
-    GameCapture *capture = static_cast<GameCapture *>(data);
-    QMetaObject::invokeMethod(capture, [capture]()
-                              { capture->onBufferStopped(); }, Qt::QueuedConnection);
+// Reads the saved file's path from the replay buffer's "saved" signal.
+// OBS can use different keys for it.
+static const char *replaySavedPath(calldata_t *cd)
+{
+    for (const char *key : {"path", "file", "filename", "output_path"})
+    {
+        const char *path = calldata_string(cd, key);
+        if (path && *path)
+            return path;
+    }
+    return nullptr;
 }
 
 GameCapture::GameCapture(QObject *parent)
@@ -97,17 +100,19 @@ GameCapture::GameCapture(QObject *parent)
       m_bufferVideoEncoder(nullptr),
       m_bufferAudioEncoder(nullptr),
       m_bufferDurationSeconds(60),
-      m_bufferStopTimer(new QTimer(this)),
-      m_saveClipTimeoutTimer(new QTimer(this))
+      m_obsEvents(new ObsEventBridge(this)),
+      m_suppressionCalibrator(new NoiseSuppressionCalibrator(this)),
+      m_audioReplay(new AudioReplayBuffer(this))
 {
     m_bufferState.reset();
-    m_bufferStopTimer->setSingleShot(true);
-    m_bufferStopTimer->setInterval(3000); // 3 second timeout
-    connect(m_bufferStopTimer, &QTimer::timeout, this, &GameCapture::onBufferStopTimeout);
 
-    m_saveClipTimeoutTimer->setSingleShot(true);
-    m_saveClipTimeoutTimer->setInterval(30000); // 30 second timeout
-    connect(m_saveClipTimeoutTimer, &QTimer::timeout, this, &GameCapture::onSaveClipTimeout);
+    connect(m_suppressionCalibrator, &NoiseSuppressionCalibrator::finished, this, [this](const QString &method)
+            {
+        // Don't measure again this session, even if nothing could be measured
+        m_calibratedSuppressionMethod = method.isEmpty() ? QString("speex") : method;
+        if (m_microphoneSource)
+            ApplyNoiseSuppression(m_microphoneSource, m_microphoneSettings); });
+    connect(m_audioReplay, &AudioReplayBuffer::saved, this, &GameCapture::handleAudioReplaySaved);
 
     // Start the cooldown timer
     m_saveCooldownTimer.start();
@@ -126,8 +131,13 @@ bool GameCapture::Initialize()
 void GameCapture::Shutdown()
 {
     StopClippingMode();
+    // Outputs still stopping are forced to stop and released before OBS goes
+    m_outputStops.cancel();
     ClearCapture();
 
+    m_suppressionCalibrator->cancel();
+    m_audioReplay->stop();
+
     // Explicitly release all persistent OBS components that are not tied
     // to the replay buffer output's lifecycle.
     if (m_bufferVideoEncoder)
@@ -155,6 +165,7 @@ void GameCapture::Shutdown()
         obs_scene_release(m_scene);
         m_scene = nullptr;
     }
+    m_mixLoudness.detach();
     if (m_obsInitialized)
     {
         obs_shutdown();
@@ -185,6 +196,11 @@ bool GameCapture::StartClippingMode()
 
 void GameCapture::StopClippingMode()
 {
+    // Abandon whatever the session still has pending (a save, a buffer
+    // reset), even if clipping already stopped on its own
+    ++m_bufferSession;
+    m_sessionOperations.cancel();
+
     if (!m_clippingModeActive.load())
     {
         return;
@@ -192,42 +208,41 @@ void GameCapture::StopClippingMode()
 
     qDebug() << "Stopping clipping mode";
 
-    if (m_isRecording.load())
-    {
-        m_isRecording = false;
-        disconnectReplayBufferSignals();
-    }
-
     CleanupCircularBuffer();
     m_clippingModeActive = false;
     emit clippingModeChanged(false);
     qDebug() << "Clipping mode stopped";
 }
 
-void GameCapture::onSaveClipTimeout()
+bool GameCapture::SaveInstantReplay(int durationSeconds, const std::string &filename)
 {
-    if (m_isRecording.load())
+    TRACE_SCOPE("GameCapture::SaveInstantReplay");
+    LOG_DEBUG("SaveInstantReplay called with duration: %1 filename: %2", durationSeconds, filename);
+
+    if (!m_clippingModeActive.load() || !m_bufferOutput || !obs_output_active(m_bufferOutput))
     {
-        qDebug() << "Save operation timed out";
-        m_isRecording = false;
-        disconnectReplayBufferSignals();
-        emit recordingFinished(false, m_currentRecordingFile);
+        qDebug() << "Cannot save replay: clipping not active or buffer is inactive.";
+        return false;
     }
-}
 
-bool GameCapture::SaveInstantReplay(int durationSeconds, const std::string &filename)
-{
-    qDebug() << "SaveInstantReplay called with duration:" << durationSeconds << "filename:" << filename.c_str();
+    // Joins the burst that's waiting to be saved: its clip now runs up to here
+    if (m_burstPending)
+    {
+        m_burstLastRequestMs = m_burstTimer.elapsed();
+        ++m_burstRequests;
+        LOG_INFO("Save request merged into the pending clip (%1 requests)", m_burstRequests);
+        return true;
+    }
 
-    if (m_saveCooldownTimer.elapsed() < SAVE_COOLDOWN_MS)
+    if (m_isRecording.load())
     {
-        qDebug() << "Cannot save replay: Save button is on cooldown.";
+        qDebug() << "Cannot save replay: already saving.";
         return false;
     }
 
-    if (!m_clippingModeActive.load() || m_isRecording.load() || !m_bufferOutput || !obs_output_active(m_bufferOutput))
+    if (m_saveBurstWindowSeconds <= 0 && m_saveCooldownTimer.elapsed() < SAVE_COOLDOWN_MS)
     {
-        qDebug() << "Cannot save replay: clipping not active, already saving, or buffer is inactive.";
+        LOG_DEBUG("Cannot save replay: Save button is on cooldown.");
         return false;
     }
 
@@ -238,26 +253,58 @@ bool GameCapture::SaveInstantReplay(int durationSeconds, const std::string &file
     emit recordingStarted();
     m_currentRecordingFile = QString::fromStdString(filename);
 
-    disconnectReplayBufferSignals();
-
-    signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-    if (!handler)
+    if (m_saveBurstWindowSeconds > 0)
     {
-        qDebug() << "No signal handler found";
-        m_isRecording = false;
-        return false;
+        m_burstPending = true;
+        m_burstTimer.start();
+        m_burstLastRequestMs = 0;
+        m_burstRequests = 1;
+        SaveBurst(m_bufferOutput);
+        return true;
     }
 
-    signal_handler_connect(handler, "saved", replay_buffer_saved_callback, this);
+    // Runs up to the wait for the "saved" signal; if the save couldn't be
+    // requested it has already ended
+    m_pendingSaveSeconds = m_bufferDurationSeconds;
+    m_pendingKeepSeconds = 0.0;
+    SaveReplay(m_bufferOutput);
+    return m_isRecording.load();
+}
 
-    qDebug() << "Triggering replay buffer save using procedure call";
-    proc_handler_t *proc_handler = obs_output_get_proc_handler(m_bufferOutput);
+Task<> GameCapture::SaveBurst(obs_output_t *bufferOutput)
+{
+    const OBSOutput output(bufferOutput);
+    const WaitResult waited = co_await Delay(this, m_saveBurstWindowSeconds * 1000, &m_sessionOperations);
+    m_burstPending = false;
+    if (waited != WaitResult::Completed)
+    {
+        // Clipping stopped first, taking the buffer with it
+        FailSave(QString("clipping stopped before the pending clip (%1 requests) was saved").arg(m_burstRequests));
+        co_return;
+    }
+
+    // The buffer keeps the window on top of the clip length, so a save now
+    // still reaches a full clip length back from the first request. What
+    // came after the last request is cut off once the file is written.
+    const double savedSeconds = std::min(static_cast<double>(BufferRetentionSeconds()), m_bufferUptime.elapsed() / 1000.0);
+    const double tailSeconds = (m_burstTimer.elapsed() - m_burstLastRequestMs) / 1000.0;
+    m_pendingSaveSeconds = savedSeconds;
+    m_pendingKeepSeconds = std::max(savedSeconds - tailSeconds, 1.0);
+    LOG_INFO("Saving %1 request(s) as one clip of %2 s", m_burstRequests, QString::number(m_pendingKeepSeconds, 'f', 1));
+    co_await SaveReplay(output);
+}
+
+Task<> GameCapture::SaveReplay(obs_output_t *bufferOutput)
+{
+    const OBSOutput output(bufferOutput);
+    OutputSignal saved(m_obsEvents, output, "saved", kSaveTimeoutMs, &m_sessionOperations, replaySavedPath);
+
+    LOG_DEBUG("Triggering replay buffer save using procedure call");
+    proc_handler_t *proc_handler = obs_output_get_proc_handler(output);
     if (!proc_handler)
     {
-        qDebug() << "No procedure handler found";
-        m_isRecording = false;
-        disconnectReplayBufferSignals();
-        return false;
+        FailSave("the buffer output has no procedure handler");
+        co_return;
     }
 
     struct calldata params = {0};
@@ -267,16 +314,46 @@ bool GameCapture::SaveInstantReplay(int durationSeconds, const std::string &file
 
     if (!success)
     {
-        qDebug() << "Failed to call save procedure";
-        m_isRecording = false;
-        disconnectReplayBufferSignals();
-        return false;
+        FailSave("the buffer output's save procedure failed");
+        co_return;
+    }
+
+    const quint64 traceId = ++m_saveTraceId;
+    Trace::asyncBegin("Save replay", traceId);
+    const double savedSeconds = std::min(m_pendingSaveSeconds, m_bufferUptime.elapsed() / 1000.0);
+    m_pendingUntrimmedLoudness = MeasureSavedLoudness(savedSeconds);
+    // A merged burst is trimmed back to its last request, so only that part
+    // is measured for the clip: the tail after it is cut
+    m_pendingLoudness = m_pendingKeepSeconds > 0.0
+                            ? MeasureSavedLoudness(m_pendingKeepSeconds, std::max(savedSeconds - m_pendingKeepSeconds, 0.0))
+                            : m_pendingUntrimmedLoudness;
+    LOG_DEBUG("Save operation initiated successfully");
+
+    const WaitResult result = co_await saved;
+    Trace::asyncEnd("Save replay", traceId);
+    switch (result)
+    {
+    case WaitResult::Completed:
+        LOG_DEBUG("Replay buffer saved after %1 ms - path: %2", saved.elapsedMs(), saved.argument());
+        handleReplayBufferSaved(saved.argument());
+        break;
+    case WaitResult::TimedOut:
+        FailSave("timed out waiting for the file");
+        break;
+    case WaitResult::Cancelled:
+        FailSave("clipping stopped before the file was written");
+        break;
     }
+}
 
-    m_saveClipTimeoutTimer->start();
-
-    qDebug() << "Save operation initiated successfully";
-    return true;
+// Every save that emitted recordingStarted ends in recordingFinished, so
+// the UI never stays on "Saving clip..." (a merged burst has already told
+// each request it was accepted)
+void GameCapture::FailSave(const QString &reason)
+{
+    LOG_WARN("Clip save failed: %1", reason);
+    m_isRecording = false;
+    emit recordingFinished(false, m_currentRecordingFile);
 }
 
 bool GameCapture::SaveClip(int durationSeconds, const std::string &filename)
@@ -393,12 +470,95 @@ void GameCapture::EnsureDirectoryForGameName(const QString &gameName)
     }
 }
 
+void GameCapture::SetLoudnessNormalization(bool enabled, double targetLufs)
+{
+    m_normalizeLoudness = enabled;
+    m_targetLufs = targetLufs;
+}
+
+bool GameCapture::SetAudioReplayBuffer(bool enabled, int retentionSeconds)
+{
+    m_audioReplay->setRetention(retentionSeconds);
+    if (!enabled)
+    {
+        m_audioReplay->stop();
+        m_audioReplay->clear();
+        return true;
+    }
+    return m_audioReplay->isActive() || StartAudioReplay();
+}
+
+bool GameCapture::IsAudioReplayActive() const
+{
+    return m_audioReplay->isActive();
+}
+
+bool GameCapture::StartAudioReplay()
+{
+    if (!m_obsInitialized.load())
+        return false;
+
+    // Outside clipping mode the sources and encoder may not be set up yet.
+    // While clipping, the replay buffer's are used as they are.
+    if (!m_clippingModeActive.load())
+        RefreshAudioReplaySources();
+    if (!m_bufferAudioEncoder)
+        return false;
+    return m_audioReplay->start(m_bufferAudioEncoder);
+}
+
+void GameCapture::RefreshAudioReplaySources()
+{
+    if (!UpdateBufferAudioComponents())
+        return;
+    // The next clipping session can reuse what was just set up
+    m_bufferState.lastAudioSettings = m_audioSettings;
+    m_bufferState.lastMicrophoneSettings = m_microphoneSettings;
+}
+
+bool GameCapture::SaveAudioReplay()
+{
+    TRACE_SCOPE("GameCapture::SaveAudioReplay");
+    if (!m_audioReplay->isActive() || m_audioReplaySaving)
+    {
+        LOG_DEBUG("Cannot save audio replay: buffer inactive or already saving");
+        return false;
+    }
+
+    const QString folder = GetCurrentGameFolder();
+    QDir().mkpath(folder);
+    const QString path = folder + "/Audio_" + QDateTime::currentDateTime().toString("yyyyMMdd_hhmmss") + ".aac";
+
+    m_pendingAudioReplaySeconds = m_audioReplay->bufferedSeconds();
+    m_pendingAudioReplayLoudness = MeasureSavedLoudness(m_pendingAudioReplaySeconds);
+    if (!m_audioReplay->save(path))
+        return false;
+
+    m_audioReplaySaving = true;
+    emit recordingStarted();
+    return true;
+}
+
+void GameCapture::handleAudioReplaySaved(const QString &path, bool success)
+{
+    m_audioReplaySaving = false;
+    if (!success)
+    {
+        emit recordingFinished(false, path);
+        return;
+    }
+
+    RecordClipInIndex(path, "audio", m_pendingAudioReplaySeconds, m_pendingAudioReplayLoudness);
+    emit recordingFinished(true, path);
+    if (m_normalizeLoudness)
+        NormalizeClipLoudness(path, m_pendingAudioReplayLoudness);
+}
+
 void GameCapture::handleReplayBufferSaved(const QString &path)
 {
-    m_saveClipTimeoutTimer->stop();
-    qDebug() << "handleReplayBufferSaved called with path:" << path;
+    TRACE_SCOPE("GameCapture::handleReplayBufferSaved");
+    LOG_DEBUG("handleReplayBufferSaved called with path: %1", path);
     m_isRecording = false;
-    disconnectReplayBufferSignals();
 
     QString savedPath = path;
     if (!savedPath.isEmpty())
@@ -429,20 +589,156 @@ void GameCapture::handleReplayBufferSaved(const QString &path)
 
     if (!savedPath.isEmpty() && QFile::exists(savedPath))
     {
+        const double keepSeconds = m_pendingKeepSeconds;
+        RecordClipInIndex(savedPath, "video", keepSeconds > 0.0 ? keepSeconds : m_pendingSaveSeconds, m_pendingLoudness);
         emit recordingFinished(true, savedPath);
+        // Normalizing has to wait for the trimmed file
+        if (keepSeconds > 0.0)
+            TrimClip(savedPath, keepSeconds, m_pendingLoudness, m_pendingUntrimmedLoudness);
+        else if (m_normalizeLoudness)
+            NormalizeClipLoudness(savedPath, m_pendingLoudness);
     }
     else
     {
         emit recordingFinished(false, "");
     }
 
-    QTimer::singleShot(200, this, [this]()
-                       {
-        if (m_clippingModeActive.load() && !FastBufferReset()) {
-            qDebug() << "Fast reset failed, falling back to full restart";
-            StopClippingMode();
-            QTimer::singleShot(500, this, [this]() { StartClippingMode(); });
+    ResetBufferAfterSave();
+}
+
+// The meter only keeps LoudnessMeter::kHistorySeconds, so the start of a
+// longer save isn't measured. Such stats are marked partial.
+LoudnessStats GameCapture::MeasureSavedLoudness(double savedSeconds, double skipSeconds) const
+{
+    LoudnessStats stats = m_mixLoudness.measure(savedSeconds, skipSeconds);
+    stats.partial = savedSeconds + skipSeconds > LoudnessMeter::kHistorySeconds && stats.seconds + 1.0 < savedSeconds;
+    return stats;
+}
+
+void GameCapture::RecordClipInIndex(const QString &path, const QString &type, double durationSeconds, const LoudnessStats &stats)
+{
+    ClipIndex::update(m_outputFolder, path,
+                      {{"game", m_currentGameName.isEmpty() ? QString("Unknown") : m_currentGameName},
+                       {"savedAt", QDateTime::currentDateTime().toString(Qt::ISODate)},
+                       {"type", type},
+                       {"durationSeconds", roundedTenth(durationSeconds)},
+                       {"loudness", loudnessJson(stats)}});
+}
+
+void GameCapture::NormalizeClipLoudness(const QString &path, const LoudnessStats &stats)
+{
+    if (stats.isSilent())
+    {
+        LOG_INFO("Not normalizing %1: no audio above the gate", path);
+        return;
+    }
+    if (stats.partial)
+    {
+        LOG_INFO("Not normalizing %1: only its last %2 s were measured", path, QString::number(stats.seconds, 'f', 0));
+        return;
+    }
+
+    // A plain gain change: the loudness is already known, so no analysis pass
+    // is needed. Boosts stop short of pushing sample peaks over -1 dBFS;
+    // cuts are never limited.
+    double gainDb = m_targetLufs - stats.integrated;
+    if (gainDb > 0.0)
+        gainDb = std::min(gainDb, std::max(0.0, -1.0 - stats.samplePeak));
+    if (std::abs(gainDb) < 0.5)
+    {
+        LOG_DEBUG("%1 is within 0.5 LU of the target, not normalizing", path);
+        return;
+    }
+
+    // Video and any other streams are copied untouched; only audio is re-encoded.
+    const QStringList args{
+        "-map", "0", "-c", "copy",
+        "-c:a", "aac", "-b:a", QString("%1k").arg(m_audioSettings.bitrate),
+        "-af", QString("volume=%1dB").arg(gainDb, 0, 'f', 2)};
+
+    const QString outputFolder = m_outputFolder;
+    const double targetLufs = m_targetLufs;
+    RewriteClip(path, args, "normalizing", [path, outputFolder, targetLufs, gainDb](bool replaced)
+                {
+        if (!replaced)
+            return;
+        ClipIndex::update(outputFolder, path,
+                          {{"normalized", QJsonObject{{"targetLufs", targetLufs},
+                                                      {"gainDb", std::round(gainDb * 10.0) / 10.0}}}});
+        LOG_INFO("Normalized %1 by %2 dB", path, gainDb); });
+}
+
+// Cuts a merged burst's clip back to its last request. Stream copy, so only
+// the end moves and nothing is re-encoded.
+// The clip was indexed with keptStats; if it stays untrimmed, the entry and
+// normalizing fall back to untrimmedStats.
+void GameCapture::TrimClip(const QString &path, double keepSeconds, const LoudnessStats &keptStats, const LoudnessStats &untrimmedStats)
+{
+    const QStringList args{"-map", "0", "-c", "copy", "-t", QString::number(keepSeconds, 'f', 3)};
+    const QString outputFolder = m_outputFolder;
+    const double savedSeconds = m_pendingSaveSeconds;
+    RewriteClip(path, args, "trimming", [this, path, keepSeconds, keptStats, untrimmedStats, outputFolder, savedSeconds](bool replaced)
+                {
+        if (replaced)
+            LOG_INFO("Trimmed %1 to %2 s", path, QString::number(keepSeconds, 'f', 1));
+        else
+            ClipIndex::update(outputFolder, path, {{"durationSeconds", roundedTenth(savedSeconds)},
+                                                   {"loudness", loudnessJson(untrimmedStats)}});
+        if (m_normalizeLoudness)
+            NormalizeClipLoudness(path, replaced ? keptStats : untrimmedStats); });
+}
+
+// Runs ffmpeg over a saved clip into a temporary file, which then takes the
+// clip's place. done runs on this thread, told whether that happened.
+void GameCapture::RewriteClip(const QString &path, const QStringList &outputArgs, const QString &action, std::function<void(bool replaced)> done)
+{
+    const QString ffmpeg = QStandardPaths::findExecutable("ffmpeg");
+    if (ffmpeg.isEmpty())
+    {
+        LOG_WARN("No ffmpeg on PATH for %1 %2, leaving it as is", action, path);
+        done(false);
+        return;
+    }
+
+    const QFileInfo info(path);
+    const QString tempPath = info.dir().filePath(info.completeBaseName() + "." + action + "." + info.suffix());
+    const QStringList args = QStringList{"-hide_banner", "-nostdin", "-y", "-i", path} + outputArgs + QStringList{tempPath};
+
+    QProcess *process = new QProcess(this);
+    process->setStandardOutputFile(QProcess::nullDevice());
+    process->setStandardErrorFile(QProcess::nullDevice());
+
+    connect(process, &QProcess::finished, this, [process, path, tempPath, action, done](int exitCode, QProcess::ExitStatus status)
+            {
+        process->deleteLater();
+        if (status != QProcess::NormalExit || exitCode != 0) {
+            LOG_WARN("ffmpeg failed %1 %2 (exit code %3)", action, path, exitCode);
+            QFile::remove(tempPath);
+            done(false);
+            return;
+        }
+        // Replaces the clip in one step (MoveFileEx with REPLACE_EXISTING on
+        // Windows), so it is never missing. If the clip is open in a player
+        // this fails and the original stays as it was.
+        std::error_code error;
+        std::filesystem::rename(std::filesystem::path(tempPath.toStdWString()),
+                                std::filesystem::path(path.toStdWString()), error);
+        if (error) {
+            LOG_WARN("Couldn't replace %1 after %2 it: %3", path, action, QString::fromStdString(error.message()));
+            QFile::remove(tempPath);
+            done(false);
+            return;
+        }
+        done(true); });
+    connect(process, &QProcess::errorOccurred, this, [process, path, action, done](QProcess::ProcessError error)
+            {
+        if (error == QProcess::FailedToStart) {
+            LOG_WARN("Couldn't start ffmpeg for %1 %2", action, path);
+            process->deleteLater();
+            done(false);
         } });
+
+    process->start(ffmpeg, args);
 }
 
 // These methods now just update the internal settings objects.
@@ -465,16 +761,29 @@ bool GameCapture::UpdateAudioSettings(const AudioSettings &settings)
     {
         obs_source_set_volume(m_desktopAudioSource, settings.volume);
     }
+    // So is the device; the source is then up to date for the next buffer start too.
+    if (m_desktopAudioSource && settings.deviceId != m_audioSettings.deviceId)
+    {
+        SwitchSourceDevice(m_desktopAudioSource, settings.deviceId);
+        m_bufferState.lastAudioSettings.deviceId = settings.deviceId;
+    }
 
     m_audioSettings = settings;
+    // Clipping mode applies enable changes on its next start; the audio-only
+    // buffer has no such restart point, so apply them now.
+    if (m_audioReplay->isActive() && !m_clippingModeActive.load())
+        RefreshAudioReplaySources();
     return true;
 }
 
 bool GameCapture::UpdateMicrophoneSettings(const MicrophoneSettings &settings)
 {
-    // Volume and filters can be updated live.
+    // Volume, device and filters can be updated live.
     bool volumeChanged = (settings.volume != m_microphoneSettings.volume);
-    bool noiseSuppressionChanged = (settings.noiseSuppression != m_microphoneSettings.noiseSuppression);
+    bool deviceChanged = (settings.deviceId != m_microphoneSettings.deviceId);
+    bool noiseSuppressionChanged = (settings.noiseSuppression != m_microphoneSettings.noiseSuppression ||
+                                    settings.noiseSuppressionMethod != m_microphoneSettings.noiseSuppressionMethod);
+    bool noiseGateChanged = !settings.hasSameNoiseGate(m_microphoneSettings);
 
     if (m_microphoneSource)
     {
@@ -482,18 +791,24 @@ bool GameCapture::UpdateMicrophoneSettings(const MicrophoneSettings &settings)
         {
             obs_source_set_volume(m_microphoneSource, settings.volume);
         }
+        if (deviceChanged)
+        {
+            SwitchSourceDevice(m_microphoneSource, settings.deviceId);
+            m_bufferState.lastMicrophoneSettings.deviceId = settings.deviceId;
+        }
         if (noiseSuppressionChanged)
         {
-            obs_source_t *filter = obs_source_get_filter_by_name(m_microphoneSource, "Noise Suppression");
-            if (filter)
-            {
-                obs_source_set_enabled(filter, settings.noiseSuppression);
-                obs_source_release(filter);
-            }
+            ApplyNoiseSuppression(m_microphoneSource, settings);
+        }
+        if (noiseGateChanged)
+        {
+            ApplyNoiseGate(m_microphoneSource, settings);
         }
     }
 
     m_microphoneSettings = settings;
+    if (m_audioReplay->isActive() && !m_clippingModeActive.load())
+        RefreshAudioReplaySources();
     return true;
 }
 
@@ -502,58 +817,18 @@ bool GameCapture::UpdateBufferSettings()
     if (!m_bufferOutput)
         return false;
 
-    if (m_bufferDurationSeconds != m_bufferState.lastBufferDuration)
+    if (BufferRetentionSeconds() != m_bufferState.lastBufferDuration)
     {
         obs_data_t *settings = obs_data_create();
-        obs_data_set_int(settings, "max_time_sec", m_bufferDurationSeconds);
+        obs_data_set_int(settings, "max_time_sec", BufferRetentionSeconds());
         // Directory is updated separately when the game changes
         obs_output_update(m_bufferOutput, settings);
         obs_data_release(settings);
-        m_bufferState.lastBufferDuration = m_bufferDurationSeconds;
+        m_bufferState.lastBufferDuration = BufferRetentionSeconds();
     }
     return true;
 }
 
-void GameCapture::onBufferStopped()
-{
-    qDebug() << "Buffer stop signal received";
-    m_bufferStopTimer->stop();
-
-    if (m_bufferOutput)
-    {
-        signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-        if (handler)
-        {
-            signal_handler_disconnect(handler, "stop", onBufferStopSignal, this);
-        }
-    }
-    if (m_pendingBufferCallback)
-    {
-        m_pendingBufferCallback();
-    }
-}
-
-void GameCapture::onBufferStopTimeout()
-{
-    qDebug() << "Buffer stop timeout - forcing completion";
-    if (m_bufferOutput)
-    {
-        signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-        if (handler)
-        {
-            signal_handler_disconnect(handler, "stop", onBufferStopSignal, this);
-        }
-        if (obs_output_active(m_bufferOutput))
-        {
-            obs_output_force_stop(m_bufferOutput);
-        }
-    }
-    if (m_pendingBufferCallback)
-    {
-        m_pendingBufferCallback();
-    }
-}
-
 void GameCapture::StopRecording()
 {
     // This method is now only for live recording, not replay buffer saving.
@@ -565,6 +840,7 @@ void GameCapture::StopRecording()
 
 bool GameCapture::InitializeOBS()
 {
+    TRACE_SCOPE("GameCapture::InitializeOBS");
     qDebug() << "Initializing OBS";
     char exe_path[MAX_PATH];
     GetModuleFileNameA(NULL, exe_path, MAX_PATH);
@@ -639,6 +915,8 @@ bool GameCapture::InitializeOBS()
     obs_set_output_source(0, obs_scene_get_source(m_scene));
     DetectAvailableEncoders();
     m_desktopAudioSource = CreateAudioSource();
+    // Mix 0 is what the replay buffer's audio encoder records
+    m_mixLoudness.attachOutputMix(0);
     m_obsInitialized = true;
     qDebug() << "OBS initialized successfully";
     return true;
@@ -663,7 +941,7 @@ bool GameCapture::InitializeAudio()
 void GameCapture::DetectAvailableEncoders()
 {
     m_availableEncoders.clear();
-    qDebug() << "Detecting available encoders...";
+    LOG_DEBUG("Detecting available encoders...");
 
     // This map provides user-friendly names and our internal EncoderType for each OBS encoder ID.
     // The IDs are based on modern OBS Studio versions.
@@ -687,13 +965,13 @@ void GameCapture::DetectAvailableEncoders()
         if (it != encoder_map.end())
         {
             // We found a known encoder that is available on the system.
-            qDebug() << "Detected available encoder:" << it->second.second.c_str() << "(" << id << ")";
+            LOG_INFO("Detected available encoder: %1 (%2)", it->second.second, id);
             m_availableEncoders.push_back({it->second.first,    // type (EncoderType enum)
                                            it->first,           // id (std::string)
                                            it->second.second}); // name (std::string)
         }
     }
-    qDebug() << "Encoder detection finished. Found" << m_availableEncoders.size() << "encoders.";
+    LOG_INFO("Encoder detection finished. Found %1 encoders.", m_availableEncoders.size());
 }
 
 obs_data_t *GameCapture::GetEncoderDataSettings(const EncodingSettings &settings, const std::string &encoder_id)
@@ -771,6 +1049,7 @@ obs_data_t *GameCapture::GetEncoderDataSettings(const EncodingSettings &settings
 
 obs_encoder_t *GameCapture::CreateEncoder(const EncodingSettings &settings)
 {
+    TRACE_SCOPE("GameCapture::CreateEncoder");
     std::string encoder_id;
     for (const auto &encoder : m_availableEncoders)
     {
@@ -839,52 +1118,104 @@ obs_source_t *GameCapture::CreateMicrophoneSource()
         obs_source_set_enabled(source, m_microphoneSettings.enabled);
         obs_source_set_monitoring_type(source, OBS_MONITORING_TYPE_NONE);
 
-        if (m_microphoneSettings.noiseSuppression)
-        {
-            obs_source_t *filter = obs_source_create("noise_suppress_filter", "Noise Suppression", nullptr, nullptr);
-            if (filter)
-            {
-                obs_source_filter_add(source, filter);
-                obs_source_release(filter);
-            }
-        }
+        ApplyNoiseSuppression(source, m_microphoneSettings);
+        ApplyNoiseGate(source, m_microphoneSettings);
     }
     return source;
 }
 
-void GameCapture::RecreateAudioSource()
+void GameCapture::ApplyNoiseSuppression(obs_source_t *microphone, const MicrophoneSettings &settings)
 {
-    bool wasActive = m_clippingModeActive.load();
-    if (wasActive)
-        StopClippingMode();
-    if (m_desktopAudioSource)
+    const bool automatic = settings.noiseSuppressionMethod == "auto";
+    if (!settings.noiseSuppression || !automatic)
+        m_suppressionCalibrator->cancel();
+
+    obs_source_t *filter = obs_source_get_filter_by_name(microphone, "Noise Suppression");
+    if (!settings.noiseSuppression)
     {
-        obs_source_release(m_desktopAudioSource);
-        m_desktopAudioSource = nullptr;
+        if (filter)
+        {
+            obs_source_set_enabled(filter, false);
+            obs_source_release(filter);
+        }
+        return;
     }
-    m_desktopAudioSource = CreateAudioSource();
-    if (wasActive)
-        QTimer::singleShot(500, [this]()
-                           { StartClippingMode(); });
+
+    // Until calibrated, "auto" runs Speex: the cheapest, and always available
+    QString method = QString::fromStdString(settings.noiseSuppressionMethod);
+    if (automatic)
+        method = m_calibratedSuppressionMethod.isEmpty() ? QString("speex") : m_calibratedSuppressionMethod;
+
+    obs_data_t *suppressionSettings = obs_data_create();
+    obs_data_set_string(suppressionSettings, "method", method.toUtf8().constData());
+    if (filter)
+    {
+        obs_source_update(filter, suppressionSettings);
+        obs_source_set_enabled(filter, true);
+    }
+    else if ((filter = obs_source_create("noise_suppress_filter", "Noise Suppression", suppressionSettings, nullptr)))
+    {
+        // New filters go last, so turned on after the gate exists it would
+        // run after it. The gate should only see what suppression leaves.
+        obs_source_filter_add(microphone, filter);
+        obs_source_filter_set_order(microphone, filter, OBS_ORDER_MOVE_TOP);
+    }
+    obs_data_release(suppressionSettings);
+
+    // Benchmarks private filters, so the microphone keeps running Speex meanwhile
+    if (filter && automatic && m_calibratedSuppressionMethod.isEmpty() && !m_suppressionCalibrator->isRunning())
+        m_suppressionCalibrator->start();
+    if (filter)
+        obs_source_release(filter);
 }
 
-void GameCapture::RecreateMicrophoneSource()
+void GameCapture::ApplyNoiseGate(obs_source_t *microphone, const MicrophoneSettings &settings)
 {
-    bool wasActive = m_clippingModeActive.load();
-    if (wasActive)
-        StopClippingMode();
-    if (m_microphoneSource)
+    // libobs' noise_gate_filter: a per-sample envelope follower with
+    // open/close hysteresis. Runs after noise suppression, which
+    // ApplyNoiseSuppression() keeps at the front of the chain.
+    obs_source_t *filter = obs_source_get_filter_by_name(microphone, "Noise Gate");
+    if (!settings.noiseGate)
     {
-        obs_source_release(m_microphoneSource);
-        m_microphoneSource = nullptr;
+        if (filter)
+        {
+            obs_source_set_enabled(filter, false);
+            obs_source_release(filter);
+        }
+        return;
     }
-    if (m_microphoneSettings.enabled)
+
+    obs_data_t *gateSettings = obs_data_create();
+    obs_data_set_double(gateSettings, "open_threshold", settings.noiseGateThreshold);
+    // The gate never closes above where it opens
+    obs_data_set_double(gateSettings, "close_threshold", std::min(settings.noiseGateCloseThreshold, settings.noiseGateThreshold));
+    obs_data_set_int(gateSettings, "hold_time", static_cast<int>(settings.noiseGateHoldTime));
+    obs_data_set_int(gateSettings, "release_time", static_cast<int>(settings.noiseGateReleaseTime));
+
+    if (filter)
     {
-        m_microphoneSource = CreateMicrophoneSource();
+        obs_source_update(filter, gateSettings);
+        obs_source_set_enabled(filter, true);
+        obs_source_release(filter);
     }
-    if (wasActive)
-        QTimer::singleShot(500, [this]()
-                           { StartClippingMode(); });
+    else if ((filter = obs_source_create("noise_gate_filter", "Noise Gate", gateSettings, nullptr)))
+    {
+        obs_source_filter_add(microphone, filter);
+        obs_source_release(filter);
+    }
+    obs_data_release(gateSettings);
+}
+
+void GameCapture::SwitchSourceDevice(obs_source_t *source, const std::string &deviceId)
+{
+    // The WASAPI source reopens its endpoint on update. The source object,
+    // its filters and meters and the outputs mixing it all stay as they are,
+    // so a running buffer only misses the few ms the reconnect takes.
+    obs_data_t *settings = obs_data_create();
+    obs_data_set_string(settings, "device_id", deviceId.empty() ? "default" : deviceId.c_str());
+    obs_source_update(source, settings);
+    obs_data_release(settings);
+    LOG_INFO("%1 switched to device %2", QString::fromUtf8(obs_source_get_name(source)), QString::fromStdString(deviceId));
 }
 
 std::string GameCapture::GenerateFilename(int duration)
@@ -976,6 +1307,7 @@ bool GameCapture::ValidateOBSState()
 
 bool GameCapture::SetupCircularBuffer()
 {
+    TRACE_SCOPE("GameCapture::SetupCircularBuffer");
     if (!ValidateOBSState())
         return false;
 
@@ -1002,7 +1334,7 @@ bool GameCapture::SetupCircularBuffer()
     m_bufferState.lastEncodingSettings = m_encodingSettings;
     m_bufferState.lastAudioSettings = m_audioSettings;
     m_bufferState.lastMicrophoneSettings = m_microphoneSettings;
-    m_bufferState.lastBufferDuration = m_bufferDurationSeconds;
+    m_bufferState.lastBufferDuration = BufferRetentionSeconds();
 
     qDebug() << "Circular buffer setup successful and is now active.";
     return true;
@@ -1014,52 +1346,54 @@ void GameCapture::CleanupCircularBuffer()
         return;
 
     qDebug() << "Cleaning up circular buffer (stopping and releasing output).";
-    disconnectReplayBufferSignals();
 
     // The cleanup process now only targets the replay_buffer output.
     // Encoders and audio sources remain alive for the next session.
-    if (m_bufferOutput && obs_output_active(m_bufferOutput))
-    {
-        // Stop the buffer asynchronously to prevent blocking the main thread.
-        m_pendingBufferCallback = [this]()
-        {
-            completeBufferCleanup();
-            m_pendingBufferCallback = nullptr;
-        };
-        signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-        if (handler)
-        {
-            signal_handler_connect(handler, "stop", onBufferStopSignal, this);
-        }
-        m_bufferStopTimer->start();
-        obs_output_stop(m_bufferOutput);
-    }
-    else
-    {
-        completeBufferCleanup();
-    }
-}
-
-void GameCapture::completeBufferCleanup()
-{
     if (m_bufferOutput)
     {
+        // A running output is stopped in the background and released once
+        // stopped; the next session creates an output of its own meanwhile
+        if (obs_output_active(m_bufferOutput))
+            ReleaseWhenStopped(m_bufferOutput);
         obs_output_release(m_bufferOutput);
         m_bufferOutput = nullptr;
     }
     m_bufferState.isActive = false;
 }
 
-void GameCapture::disconnectReplayBufferSignals()
+Task<> GameCapture::ReleaseWhenStopped(obs_output_t *bufferOutput)
 {
-    if (m_bufferOutput)
+    const OBSOutput output(bufferOutput);
+    co_await StopOutput(output, &m_outputStops);
+}
+
+Task<bool> GameCapture::StopOutput(obs_output_t *bufferOutput, CancelScope *scope)
+{
+    const OBSOutput output(bufferOutput);
+    if (!obs_output_active(output))
+        co_return true;
+
+    WaitResult result = WaitResult::Cancelled;
+    qint64 waitedMs = 0;
     {
-        signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-        if (handler)
-        {
-            signal_handler_disconnect(handler, "saved", replay_buffer_saved_callback, this);
-        }
+        OutputSignal stopped(m_obsEvents, output, "stop", kOutputStopTimeoutMs, scope);
+        obs_output_stop(output);
+        result = co_await stopped;
+        waitedMs = stopped.elapsedMs();
     }
+
+    if (result == WaitResult::Completed)
+    {
+        LOG_DEBUG("Output %1 stopped after %2 ms", QString::fromUtf8(obs_output_get_name(output)), waitedMs);
+        co_return true;
+    }
+
+    qDebug() << (result == WaitResult::TimedOut ? "Output stop timed out" : "Output stop abandoned") << "- forcing it";
+    if (obs_output_active(output))
+    {
+        obs_output_force_stop(output);
+    }
+    co_return false;
 }
 
 bool GameCapture::CreateBufferOutput()
@@ -1074,7 +1408,7 @@ bool GameCapture::CreateBufferOutput()
     }
 
     obs_data_t *output_settings = obs_data_create();
-    obs_data_set_int(output_settings, "max_time_sec", m_bufferDurationSeconds);
+    obs_data_set_int(output_settings, "max_time_sec", BufferRetentionSeconds());
     QString outputPath = GetCurrentGameFolder();
     obs_data_set_string(output_settings, "directory", outputPath.toUtf8().constData());
     obs_data_set_string(output_settings, "format", "Replay_%CCYY%MM%DD_%hh%mm%ss");
@@ -1107,9 +1441,10 @@ bool GameCapture::StartBufferOutput()
         qDebug() << "Failed to start buffer output:" << obs_output_get_last_error(m_bufferOutput);
         return false;
     }
+    m_bufferUptime.start();
 
     // Reapply encoder settings after start; some drivers override them.
-    QTimer::singleShot(1000, [this]()
+    QTimer::singleShot(1000, this, [this]()
                        {
         if (m_bufferOutput && obs_output_active(m_bufferOutput) && m_bufferVideoEncoder) {
             std::string encoder_id = obs_encoder_get_id(m_bufferVideoEncoder);
@@ -1127,11 +1462,11 @@ bool GameCapture::UpdateBufferVideoEncoder()
     bool needsRecreation = !m_bufferVideoEncoder || m_bufferState.hasEncodingChanges(m_encodingSettings);
     if (!needsRecreation)
     {
-        qDebug() << "Video encoder is up-to-date. No recreation needed.";
+        LOG_DEBUG("Video encoder is up-to-date. No recreation needed.");
         return true;
     }
 
-    qDebug() << "Recreating video encoder due to settings change or first-time setup.";
+    LOG_DEBUG("Recreating video encoder due to settings change or first-time setup.");
     if (m_bufferVideoEncoder)
     {
         obs_encoder_release(m_bufferVideoEncoder);
@@ -1188,32 +1523,8 @@ bool GameCapture::UpdateBufferAudioComponents()
         obs_source_set_volume(m_microphoneSource, m_microphoneSettings.volume);
         obs_source_set_enabled(m_microphoneSource, m_microphoneSettings.enabled);
 
-        obs_source_t *filter = obs_source_get_filter_by_name(m_microphoneSource, "Noise Suppression");
-        if (m_microphoneSettings.noiseSuppression)
-        {
-            if (!filter)
-            {
-                obs_source_t *new_filter = obs_source_create("noise_suppress_filter", "Noise Suppression", nullptr, nullptr);
-                if (new_filter)
-                {
-                    obs_source_filter_add(m_microphoneSource, new_filter);
-                    obs_source_release(new_filter);
-                }
-            }
-            else
-            {
-                obs_source_set_enabled(filter, true);
-            }
-        }
-        else
-        {
-            if (filter)
-            {
-                obs_source_set_enabled(filter, false);
-            }
-        }
-        if (filter)
-            obs_source_release(filter);
+        ApplyNoiseSuppression(m_microphoneSource, m_microphoneSettings);
+        ApplyNoiseGate(m_microphoneSource, m_microphoneSettings);
 
         obs_set_output_source(2, m_microphoneSettings.enabled ? m_microphoneSource : nullptr);
     }
@@ -1226,6 +1537,10 @@ bool GameCapture::UpdateBufferAudioComponents()
     if (encoderSettingsChanged)
     {
         qDebug() << "Recreating audio encoder due to settings change.";
+        // The audio-only buffer shares the encoder; it keeps its packets
+        // across the restart.
+        const bool audioReplayWasActive = m_audioReplay->isActive();
+        m_audioReplay->stop();
         if (m_bufferAudioEncoder)
             obs_encoder_release(m_bufferAudioEncoder);
         m_bufferAudioEncoder = CreateAudioEncoder();
@@ -1235,49 +1550,57 @@ bool GameCapture::UpdateBufferAudioComponents()
             return false;
         }
         obs_encoder_set_audio(m_bufferAudioEncoder, obs_get_audio());
+        if (audioReplayWasActive)
+            m_audioReplay->start(m_bufferAudioEncoder);
     }
 
     return true;
 }
 
-bool GameCapture::FastBufferReset()
+Task<> GameCapture::ResetBufferAfterSave()
 {
-    if (!m_bufferOutput || !obs_output_active(m_bufferOutput) || m_pendingBufferCallback)
-    {
-        return false;
-    }
-
-    // Asynchronously stop and then restart the buffer output. This is much
-    // faster than destroying and recreating the entire object.
-    m_pendingBufferCallback = [this]()
-    {
-        m_pendingBufferCallback = nullptr;
-        if (!m_bufferVideoEncoder || !m_bufferAudioEncoder)
+    if (m_bufferResetting)
+        co_return;
+    m_bufferResetting = true;
+    const quint64 session = m_bufferSession;
+    const OBSOutput output(m_bufferOutput);
+
+    // Stop and then restart the buffer output. This is much faster than
+    // destroying and recreating the entire object.
+    bool restarted = false;
+    if (co_await Delay(this, 200, &m_sessionOperations) == WaitResult::Completed && output &&
+        obs_output_active(output))
+    {
+        const bool stopped = co_await StopOutput(output, &m_sessionOperations);
+        if (session != m_bufferSession)
         {
-            StopClippingMode();
-            QTimer::singleShot(500, this, &GameCapture::StartClippingMode);
-            return;
+            m_bufferResetting = false;
+            co_return;
         }
-        if (!obs_output_start(m_bufferOutput))
+        if (stopped && m_bufferVideoEncoder && m_bufferAudioEncoder && obs_output_start(output))
         {
-            StopClippingMode();
-            QTimer::singleShot(500, this, &GameCapture::StartClippingMode);
-            return;
+            m_bufferUptime.start();
+            co_await Delay(this, 500, &m_sessionOperations);
+            restarted = obs_output_active(output);
         }
-        QTimer::singleShot(500, [this]()
-                           {
-            if (m_clippingModeActive.load() && (!m_bufferOutput || !obs_output_active(m_bufferOutput))) {
-                 StopClippingMode();
-                 QTimer::singleShot(500, this, &GameCapture::StartClippingMode);
-            } });
-    };
+    }
+    m_bufferResetting = false;
 
-    signal_handler_t *handler = obs_output_get_signal_handler(m_bufferOutput);
-    if (handler)
+    // Clipping stopped meanwhile
+    if (session != m_bufferSession || !m_clippingModeActive.load())
+        co_return;
+
+    if (!restarted)
     {
-        signal_handler_connect(handler, "stop", onBufferStopSignal, this);
+        qDebug() << "Fast reset failed, falling back to full restart";
+        co_await RestartClippingMode();
     }
-    m_bufferStopTimer->start();
-    obs_output_stop(m_bufferOutput);
-    return true;
+}
+
+Task<> GameCapture::RestartClippingMode()
+{
+    StopClippingMode();
+    const quint64 session = m_bufferSession;
+    if (co_await Delay(this, 500, &m_sessionOperations) == WaitResult::Completed && session == m_bufferSession)
+        StartClippingMode();
 }
\ No newline at end of file
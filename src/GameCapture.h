@@ -10,6 +10,9 @@
 #include <QObject>
 #include <QTimer>
 #include <QString>
+#include <QStringList>
+#include "LoudnessMeter.h"
+#include "ObsTask.h"
 
 // Forward declarations
 struct obs_scene;
@@ -24,6 +27,10 @@ typedef struct obs_encoder obs_encoder_t;
 typedef struct calldata calldata_t;
 typedef struct obs_data obs_data_t;
 
+class NoiseSuppressionCalibrator;
+class AudioReplayBuffer;
+class ObsEventBridge;
+
 enum class EncoderType
 {
     NVENC_H264,
@@ -86,6 +93,9 @@ struct MicrophoneSettings
     std::string deviceId = "default";
     std::string deviceName = "Default Microphone";
     bool noiseSuppression = true;
+    // noise_suppress_filter method: "speex", "rnnoise", "nvafx_denoiser", or
+    // "auto" to measure them on this machine and pick one
+    std::string noiseSuppressionMethod = "auto";
     bool noiseGate = false;
     float noiseGateThreshold = -30.0f;
     float noiseGateCloseThreshold = -32.0f;
@@ -98,6 +108,16 @@ struct MicrophoneSettings
                deviceId == other.deviceId;
     }
     bool operator!=(const MicrophoneSettings &other) const { return !(*this == other); }
+
+    // The gate is a filter on the live source, so these never need a recreate
+    bool hasSameNoiseGate(const MicrophoneSettings &other) const
+    {
+        return noiseGate == other.noiseGate &&
+               noiseGateThreshold == other.noiseGateThreshold &&
+               noiseGateCloseThreshold == other.noiseGateCloseThreshold &&
+               noiseGateHoldTime == other.noiseGateHoldTime &&
+               noiseGateReleaseTime == other.noiseGateReleaseTime;
+    }
 };
 
 struct EncodingSettings
@@ -205,29 +225,38 @@ public:
     const EncodingSettings &GetEncodingSettings() const { return m_encodingSettings; }
     void SetBufferDuration(int seconds) { m_bufferDurationSeconds = seconds; }
     int GetBufferDuration() const { return m_bufferDurationSeconds; }
+    // Save requests within this many seconds of the first become one clip,
+    // from a clip length before the first to the last. The buffer keeps that
+    // much on top of the clip length. 0 saves each request at once.
+    void SetSaveBurstWindow(int seconds) { m_saveBurstWindowSeconds = seconds; }
     bool IsInitialized() const { return m_obsInitialized.load(); }
     const CaptureSettings &GetSettings() const { return m_settings; }
     void SetSettings(const CaptureSettings &settings) { m_settings = settings; }
     void SetOutputFolder(const QString &folder);
     void EnsureDirectoryForGameName(const QString &gameName);
-
-    // Public Callbacks & Updaters
-    void handleReplayBufferSaved(const QString &path);
+    // Loudness of everything that goes into a clip (the encoder's mix)
+    const LoudnessMeter &GetMixLoudness() const { return m_mixLoudness; }
+    // Re-encodes the audio of each saved clip to targetLufs (needs ffmpeg on PATH)
+    void SetLoudnessNormalization(bool enabled, double targetLufs);
+    // Audio-only replay buffer: desktop + mic from the clip encoder, kept for
+    // its own retention length. Runs with or without clipping mode.
+    bool SetAudioReplayBuffer(bool enabled, int retentionSeconds);
+    bool IsAudioReplayActive() const;
+    bool SaveAudioReplay();
+
+    // Public Updaters
     bool UpdateEncodingSettings(const EncodingSettings &settings);
     bool UpdateAudioSettings(const AudioSettings &settings);
     bool UpdateMicrophoneSettings(const MicrophoneSettings &settings);
 
-public slots:
-    void onBufferStopped();
-    void onBufferStopTimeout();
-    void onSaveClipTimeout();
-
 signals:
     void recordingStarted();
     void recordingFinished(bool success, const QString &filename);
     void clippingModeChanged(bool active);
 
 private:
+    friend class SaveBurstTest; // tests/SaveBurstTest.cpp
+
     // This struct tracks the state of the active buffer to determine
     // if expensive OBS components need to be recreated on the next start.
     struct BufferState
@@ -276,6 +305,11 @@ private:
     void UpdateBufferOutputDirectory();
     void CheckForGameChange();
     void ParseGameFromLog(const QString &logMessage);
+    LoudnessStats MeasureSavedLoudness(double savedSeconds, double skipSeconds = 0.0) const;
+    void RecordClipInIndex(const QString &path, const QString &type, double durationSeconds, const LoudnessStats &stats);
+    void NormalizeClipLoudness(const QString &path, const LoudnessStats &stats);
+    void TrimClip(const QString &path, double keepSeconds, const LoudnessStats &keptStats, const LoudnessStats &untrimmedStats);
+    void RewriteClip(const QString &path, const QStringList &outputArgs, const QString &action, std::function<void(bool replaced)> done);
 
     // OBS Object Creation
     obs_data_t *GetEncoderDataSettings(const EncodingSettings &settings, const std::string &encoder_id);
@@ -283,20 +317,30 @@ private:
     obs_encoder_t *CreateAudioEncoder();
     obs_source_t *CreateAudioSource();
     obs_source_t *CreateMicrophoneSource();
-    void RecreateAudioSource();
-    void RecreateMicrophoneSource();
+    void SwitchSourceDevice(obs_source_t *source, const std::string &deviceId);
+    void ApplyNoiseSuppression(obs_source_t *microphone, const MicrophoneSettings &settings);
+    void ApplyNoiseGate(obs_source_t *microphone, const MicrophoneSettings &settings);
 
     // Buffer Management
     bool SetupCircularBuffer();
     void CleanupCircularBuffer();
-    void completeBufferCleanup();
-    void disconnectReplayBufferSignals();
     bool CreateBufferOutput();
     bool StartBufferOutput();
     bool UpdateBufferVideoEncoder();
     bool UpdateBufferAudioComponents();
     bool UpdateBufferSettings();
-    bool FastBufferReset();
+    Task<bool> StopOutput(obs_output_t *output, CancelScope *scope); // Forces it if it doesn't stop in time
+    Task<> ReleaseWhenStopped(obs_output_t *output);
+    int BufferRetentionSeconds() const { return m_bufferDurationSeconds + m_saveBurstWindowSeconds; }
+    Task<> SaveBurst(obs_output_t *output);
+    Task<> SaveReplay(obs_output_t *output);
+    void FailSave(const QString &reason);
+    void handleReplayBufferSaved(const QString &path);
+    Task<> ResetBufferAfterSave();
+    Task<> RestartClippingMode();
+    bool StartAudioReplay();
+    void RefreshAudioReplaySources();
+    void handleAudioReplaySaved(const QString &path, bool success);
 
     // State & Settings
     std::atomic<bool> m_obsInitialized;
@@ -324,11 +368,39 @@ private:
     obs_encoder_t *m_bufferAudioEncoder;  // Persistent
 
     // Timers & Async Management
-    QTimer *m_bufferStopTimer;
-    QTimer *m_saveClipTimeoutTimer;
-    std::function<void()> m_pendingBufferCallback;
-    QElapsedTimer m_saveCooldownTimer;
+    ObsEventBridge *m_obsEvents; // OBS signal callbacks -> this thread
+    CancelScope m_sessionOperations; // Waits of the current clipping session
+    CancelScope m_outputStops;       // Outputs of ended sessions that are still stopping
+    quint64 m_bufferSession = 0;     // Bumped whenever clipping stops
+    bool m_bufferResetting = false;
+    QElapsedTimer m_saveCooldownTimer; // Only without a burst window
     const qint64 SAVE_COOLDOWN_MS = 2000;
+    int m_saveBurstWindowSeconds = 0;
+    bool m_burstPending = false;     // Waiting out the window before saving
+    QElapsedTimer m_burstTimer;      // Since the burst's first request
+    qint64 m_burstLastRequestMs = 0; // On m_burstTimer
+    int m_burstRequests = 0;
+    QElapsedTimer m_bufferUptime;    // Since the buffer output last started empty
+    quint64 m_saveTraceId = 0; // Pairs the save request with its "saved" callback in traces
+
+    // Noise suppression method picked for "auto", empty until calibrated
+    NoiseSuppressionCalibrator *m_suppressionCalibrator;
+    QString m_calibratedSuppressionMethod;
+
+    // Audio-only replay buffer, sharing m_bufferAudioEncoder
+    AudioReplayBuffer *m_audioReplay;
+    bool m_audioReplaySaving = false;
+    double m_pendingAudioReplaySeconds = 0.0;
+    LoudnessStats m_pendingAudioReplayLoudness;
+
+    // Loudness
+    LoudnessMeter m_mixLoudness;
+    LoudnessStats m_pendingLoudness;          // What the clip keeps, measured when the save was requested
+    LoudnessStats m_pendingUntrimmedLoudness; // The whole save, in case trimming fails
+    double m_pendingSaveSeconds = 0.0; // What the saved file covers
+    double m_pendingKeepSeconds = 0.0; // Trimmed to this once saved; 0 keeps it all
+    bool m_normalizeLoudness = false;
+    double m_targetLufs = -16.0;
 
     // File & Path Management
     QString m_currentRecordingFile;
@@ -1,6 +1,6 @@
 #include "KeybindDialog.h"
 #include <QtWidgets/QApplication>
-#include <QSettings>
+#include "SettingsStore.h"
 
 KeybindDialog::KeybindDialog(QWidget *parent)
     : QDialog(parent)
@@ -183,7 +183,7 @@ void KeybindDialog::resetToDefaults()
 
 void KeybindDialog::loadSettings()
 {
-    QSettings settings("GameClipRecorder", "Settings");
+    const SettingsStore &settings = SettingsStore::instance();
     m_settings.clipSave = QKeySequence(settings.value("keybind_clip", "F9").toString());
     m_settings.clippingModeToggle = QKeySequence(settings.value("keybind_clipping", "F10").toString());
     setKeybindSettings(m_settings);
@@ -191,7 +191,7 @@ void KeybindDialog::loadSettings()
 
 void KeybindDialog::saveSettings()
 {
-    QSettings settings("GameClipRecorder", "Settings");
+    SettingsStore &settings = SettingsStore::instance();
     settings.setValue("keybind_clip", m_settings.clipSave.toString());
     settings.setValue("keybind_clipping", m_settings.clippingModeToggle.toString());
 }
\ No newline at end of file
@@ -9,7 +9,6 @@
 #include <QtWidgets/QKeySequenceEdit>
 #include <QtWidgets/QGroupBox>
 #include <QKeySequence>
-#include <QSettings>
 
 // Streamlined KeybindSettings for core clipping functionality
 struct KeybindSettings
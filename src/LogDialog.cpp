@@ -1,14 +1,20 @@
 #include "LogDialog.h"
 #include "Logger.h"
+#include "LogModel.h"
 #include <QVBoxLayout>
 #include <QHBoxLayout>
-#include <QPlainTextEdit>
+#include <QListView>
+#include <QScrollBar>
+#include <QComboBox>
+#include <QLineEdit>
 #include <QPushButton>
 #include <QClipboard>
 #include <QApplication>
 
 LogDialog::LogDialog(QWidget *parent)
-    : QDialog(parent)
+    : QDialog(parent),
+      m_model(new LogModel(this)),
+      m_followTail(true)
 {
     setWindowTitle("Application Logs");
     setWindowFlags(windowFlags() & ~Qt::WindowContextHelpButtonHint);
@@ -17,35 +23,76 @@ LogDialog::LogDialog(QWidget *parent)
 
     setupUI();
     applyStyle();
-
-    // Connect to the logger to receive new messages in real-time
-    connect(Logger::instance(), &Logger::newMessage, this, &LogDialog::onNewLogMessage);
 }
 
 LogDialog::~LogDialog() {}
 
 void LogDialog::showEvent(QShowEvent *event)
 {
+    // Only subscribe while visible; the logger doesn't emit batches nobody listens to.
+    // Subscribed before taking the snapshot, so no batch falls between the two;
+    // the model drops whatever the snapshot already has, by sequence number.
+    connect(Logger::instance(), &Logger::recordsWritten, m_model, &LogModel::appendRecords, Qt::UniqueConnection);
+
     // Populate with existing logs when the dialog is shown.
-    m_logView->clear();
-    m_logView->appendPlainText(Logger::instance()->getMessages().join('\n'));
+    m_model->resetRecords(Logger::instance()->getRecords());
+    m_followTail = true;
+    m_logView->scrollToBottom();
     QDialog::showEvent(event);
 }
 
+void LogDialog::hideEvent(QHideEvent *event)
+{
+    disconnect(Logger::instance(), &Logger::recordsWritten, m_model, &LogModel::appendRecords);
+    QDialog::hideEvent(event);
+}
+
 void LogDialog::setupUI()
 {
     QVBoxLayout* mainLayout = new QVBoxLayout(this);
     mainLayout->setSpacing(10);
     mainLayout->setContentsMargins(10, 10, 10, 10);
 
-    m_logView = new QPlainTextEdit();
-    m_logView->setReadOnly(true);
-    m_logView->setWordWrapMode(QTextOption::NoWrap);
+    QHBoxLayout* filterLayout = new QHBoxLayout();
+    filterLayout->setSpacing(10);
+
+    m_levelFilter = new QComboBox();
+    m_levelFilter->addItem("All levels", static_cast<int>(LogModel::MinLevel::Debug));
+    m_levelFilter->addItem("Info and above", static_cast<int>(LogModel::MinLevel::Info));
+    m_levelFilter->addItem("Warnings and above", static_cast<int>(LogModel::MinLevel::Warning));
+    m_levelFilter->addItem("Errors only", static_cast<int>(LogModel::MinLevel::Critical));
+    connect(m_levelFilter, &QComboBox::currentIndexChanged, this, [this]() {
+        m_model->setMinLevel(static_cast<LogModel::MinLevel>(m_levelFilter->currentData().toInt()));
+    });
+    filterLayout->addWidget(m_levelFilter);
+
+    m_textFilter = new QLineEdit();
+    m_textFilter->setPlaceholderText("Filter...");
+    m_textFilter->setClearButtonEnabled(true);
+    connect(m_textFilter, &QLineEdit::textChanged, m_model, &LogModel::setFilterText);
+    filterLayout->addWidget(m_textFilter, 1);
+
+    mainLayout->addLayout(filterLayout);
+
+    // Uniform item sizes let the view lay out rows without asking the model
+    // for their text, so only the visible rows are ever formatted.
+    m_logView = new QListView();
+    m_logView->setModel(m_model);
+    m_logView->setUniformItemSizes(true);
+    m_logView->setSelectionMode(QAbstractItemView::ExtendedSelection);
+    m_logView->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_logView->setHorizontalScrollBarPolicy(Qt::ScrollBarAsNeeded);
     QFont font("Consolas", 10);
     font.setStyleHint(QFont::Monospace);
     m_logView->setFont(font);
     mainLayout->addWidget(m_logView);
 
+    // Stick to the newest line unless the user has scrolled up.
+    connect(m_logView->verticalScrollBar(), &QScrollBar::valueChanged, this, [this](int value) {
+        m_followTail = value == m_logView->verticalScrollBar()->maximum();
+    });
+    connect(m_model, &LogModel::rowsCommitted, this, &LogDialog::onRowsCommitted);
+
     QHBoxLayout* buttonLayout = new QHBoxLayout();
     buttonLayout->setSpacing(10);
 
@@ -77,7 +124,7 @@ void LogDialog::applyStyle()
             color: #e0e0e0;
             font-family: Inter, sans-serif;
         }
-        QPlainTextEdit {
+        QListView, QLineEdit, QComboBox {
             background-color: #000000;
             border: 1px solid #333333;
             border-radius: 4px;
@@ -102,20 +149,19 @@ void LogDialog::applyStyle()
 }
 
 
-void LogDialog::onNewLogMessage(const QString& message)
+void LogDialog::onRowsCommitted()
 {
-    // Append new messages as they arrive, only if the dialog is visible
-    if (isVisible()) {
-        m_logView->appendPlainText(message);
+    if (m_followTail) {
+        m_logView->scrollToBottom();
     }
 }
 
 void LogDialog::copyLogsToClipboard()
 {
-    QApplication::clipboard()->setText(m_logView->toPlainText());
+    QApplication::clipboard()->setText(m_model->filteredText());
 }
 
 void LogDialog::clearLogs()
 {
-    m_logView->clear();
+    m_model->clear();
 }
\ No newline at end of file
@@ -3,8 +3,11 @@
 #include <QDialog>
 
 // Forward declarations
-class QPlainTextEdit;
+class QListView;
 class QPushButton;
+class QComboBox;
+class QLineEdit;
+class LogModel;
 
 class LogDialog : public QDialog
 {
@@ -16,9 +19,10 @@ public:
 
 protected:
     void showEvent(QShowEvent* event) override;
+    void hideEvent(QHideEvent* event) override;
 
 private slots:
-    void onNewLogMessage(const QString& message);
+    void onRowsCommitted();
     void copyLogsToClipboard();
     void clearLogs();
 
@@ -26,7 +30,11 @@ private:
     void setupUI();
     void applyStyle();
 
-    QPlainTextEdit* m_logView;
+    LogModel* m_model;
+    QListView* m_logView;
+    QComboBox* m_levelFilter;
+    QLineEdit* m_textFilter;
+    bool m_followTail;
     QPushButton* m_copyButton;
     QPushButton* m_clearButton;
     QPushButton* m_closeButton;
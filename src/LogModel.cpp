@@ -0,0 +1,219 @@
+#include "LogModel.h"
+#include <QColor>
+#include <algorithm>
+
+LogModel::LogModel(QObject* parent)
+    : QAbstractListModel(parent)
+{
+    m_commitTimer.setSingleShot(true);
+    m_commitTimer.setInterval(kCommitIntervalMs);
+    connect(&m_commitTimer, &QTimer::timeout, this, &LogModel::commitPending);
+}
+
+int LogModel::rowCount(const QModelIndex& parent) const
+{
+    return parent.isValid() ? 0 : static_cast<int>(m_visible.size());
+}
+
+QVariant LogModel::data(const QModelIndex& index, int role) const
+{
+    if (!index.isValid() || index.row() >= static_cast<int>(m_visible.size())) {
+        return QVariant();
+    }
+
+    const Entry& entry = entryAt(m_visible[index.row()]);
+    switch (role) {
+    case Qt::DisplayRole:
+        // Only ever called for rows the view is about to paint.
+        return Logger::instance()->formatRecord(entry.record);
+    case Qt::ForegroundRole:
+        switch (entry.record.type) {
+        case QtWarningMsg:
+            return QColor("#e0b050");
+        case QtCriticalMsg:
+        case QtFatalMsg:
+            return QColor("#ff6060");
+        default:
+            return QVariant();
+        }
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::appendRecords(const QList<LogRecord>& records)
+{
+    m_pending.append(records);
+    if (!m_commitTimer.isActive()) {
+        m_commitTimer.start();
+    }
+}
+
+void LogModel::commitPending()
+{
+    if (m_pending.isEmpty()) {
+        return;
+    }
+
+    QList<LogRecord> batch;
+    batch.swap(m_pending);
+
+    // A live batch can overlap the snapshot the model was seeded with.
+    batch.erase(std::remove_if(batch.begin(), batch.end(),
+                               [this](const LogRecord& r) { return r.sequence <= m_lastSequence; }),
+                batch.end());
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    // Under a storm only the newest kCapacity records can survive anyway.
+    if (batch.size() > kCapacity) {
+        batch.remove(0, batch.size() - kCapacity);
+    }
+
+    // Make room: evict the oldest entries and whatever rows they backed.
+    const quint64 newEnd = m_endAbsolute + static_cast<quint64>(batch.size());
+    if (newEnd - m_firstAbsolute > static_cast<quint64>(kCapacity)) {
+        const quint64 newFirst = newEnd - kCapacity;
+        const auto firstKept = std::lower_bound(m_visible.begin(), m_visible.end(), newFirst);
+        const int removed = static_cast<int>(firstKept - m_visible.begin());
+        if (removed > 0) {
+            beginRemoveRows(QModelIndex(), 0, removed - 1);
+            m_visible.erase(m_visible.begin(), firstKept);
+            endRemoveRows();
+        }
+        m_firstAbsolute = newFirst;
+    }
+
+    std::vector<quint64> added;
+    for (LogRecord& record : batch) {
+        const quint64 absolute = m_endAbsolute++;
+        const size_t slot = static_cast<size_t>(absolute % kCapacity);
+        if (slot == m_ring.size()) {
+            m_ring.emplace_back();
+        }
+
+        Entry& entry = m_ring[slot];
+        m_lastSequence = record.sequence;
+        entry.record = std::move(record);
+        entry.text.clear();
+        entry.hasText = false;
+
+        if (accepts(entry)) {
+            added.push_back(absolute);
+        }
+    }
+
+    if (!added.empty()) {
+        const int firstRow = static_cast<int>(m_visible.size());
+        beginInsertRows(QModelIndex(), firstRow, firstRow + static_cast<int>(added.size()) - 1);
+        m_visible.insert(m_visible.end(), added.begin(), added.end());
+        endInsertRows();
+    }
+
+    emit rowsCommitted();
+}
+
+void LogModel::resetRecords(const QList<LogRecord>& records)
+{
+    beginResetModel();
+    m_ring.clear();
+    m_visible.clear();
+    m_pending.clear();
+    m_firstAbsolute = 0;
+    m_endAbsolute = 0;
+    m_lastSequence = 0;
+    endResetModel();
+
+    m_pending = records;
+    commitPending();
+}
+
+void LogModel::clear()
+{
+    // Keep m_lastSequence so batches already in flight don't bring lines back.
+    beginResetModel();
+    m_ring.clear();
+    m_visible.clear();
+    m_pending.clear();
+    m_firstAbsolute = 0;
+    m_endAbsolute = 0;
+    endResetModel();
+}
+
+void LogModel::setMinLevel(MinLevel level)
+{
+    if (level == m_minLevel) {
+        return;
+    }
+    m_minLevel = level;
+    rebuildIndex();
+}
+
+void LogModel::setFilterText(const QString& text)
+{
+    if (text == m_filterText) {
+        return;
+    }
+    m_filterText = text;
+    rebuildIndex();
+}
+
+QString LogModel::filteredText() const
+{
+    QStringList lines;
+    lines.reserve(static_cast<qsizetype>(m_visible.size()));
+    for (quint64 absolute : m_visible) {
+        lines.append(Logger::instance()->formatRecord(entryAt(absolute).record));
+    }
+    return lines.join('\n');
+}
+
+const LogModel::Entry& LogModel::entryAt(quint64 absolute) const
+{
+    return m_ring[static_cast<size_t>(absolute % kCapacity)];
+}
+
+const QString& LogModel::textOf(const Entry& entry) const
+{
+    if (!entry.hasText) {
+        entry.text = Logger::instance()->messageText(entry.record);
+        entry.hasText = true;
+    }
+    return entry.text;
+}
+
+bool LogModel::accepts(const Entry& entry) const
+{
+    if (severity(entry.record.type) < static_cast<int>(m_minLevel)) {
+        return false;
+    }
+    return m_filterText.isEmpty() || textOf(entry).contains(m_filterText, Qt::CaseInsensitive);
+}
+
+void LogModel::rebuildIndex()
+{
+    beginResetModel();
+    m_visible.clear();
+    for (quint64 absolute = m_firstAbsolute; absolute < m_endAbsolute; ++absolute) {
+        if (accepts(entryAt(absolute))) {
+            m_visible.push_back(absolute);
+        }
+    }
+    endResetModel();
+}
+
+int LogModel::severity(QtMsgType type)
+{
+    // QtMsgType isn't ordered by severity (QtInfoMsg was added last).
+    switch (type) {
+    case QtDebugMsg:
+        return static_cast<int>(MinLevel::Debug);
+    case QtInfoMsg:
+        return static_cast<int>(MinLevel::Info);
+    case QtWarningMsg:
+        return static_cast<int>(MinLevel::Warning);
+    default:
+        return static_cast<int>(MinLevel::Critical);
+    }
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <QAbstractListModel>
+#include <QTimer>
+#include <deque>
+#include <vector>
+#include "Logger.h"
+
+// Fixed-capacity ring of log records for the log viewer. Rows are only
+// formatted when the view asks for them, and incoming batches are buffered
+// and committed at most once per kCommitIntervalMs.
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    // Lowest severity shown, in increasing order
+    enum class MinLevel { Debug, Info, Warning, Critical };
+
+    explicit LogModel(QObject* parent = nullptr);
+
+    int rowCount(const QModelIndex& parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex& index, int role = Qt::DisplayRole) const override;
+
+    // Replaces the contents with a snapshot, e.g. Logger::getRecords().
+    void resetRecords(const QList<LogRecord>& records);
+    void clear();
+
+    void setMinLevel(MinLevel level);
+    void setFilterText(const QString& text);
+
+    // All rows passing the current filter, formatted, one per line.
+    QString filteredText() const;
+
+signals:
+    // Emitted after a batch of rows has been committed.
+    void rowsCommitted();
+
+public slots:
+    // Thread-safe when connected queued; cheap, just buffers the batch.
+    void appendRecords(const QList<LogRecord>& records);
+
+private slots:
+    void commitPending();
+
+private:
+    struct Entry
+    {
+        LogRecord record;
+        mutable QString text; // Message text, formatted on first use
+        mutable bool hasText = false;
+    };
+
+    static constexpr int kCapacity = 50000;
+    static constexpr int kCommitIntervalMs = 50;
+
+    const Entry& entryAt(quint64 absolute) const;
+    const QString& textOf(const Entry& entry) const;
+    bool accepts(const Entry& entry) const;
+    void rebuildIndex();
+    static int severity(QtMsgType type);
+
+    std::vector<Entry> m_ring;   // Slot = absolute index % kCapacity
+    quint64 m_firstAbsolute = 0; // Absolute index of the oldest stored entry
+    quint64 m_endAbsolute = 0;   // One past the newest
+    quint64 m_lastSequence = 0;  // Drops duplicates between a snapshot and live batches
+
+    std::deque<quint64> m_visible; // Absolute indices passing the filter, in order
+
+    QList<LogRecord> m_pending;
+    QTimer m_commitTimer;
+
+    MinLevel m_minLevel = MinLevel::Debug;
+    QString m_filterText;
+};
@@ -3,8 +3,67 @@
 #include <QDir>
 #include <QStandardPaths>
 #include <QStringConverter> // Required for the Utf8 enum
+#include <QMetaMethod>
+#include <QFileInfo>
+#include <QSaveFile>
+#include <QtConcurrent/QtConcurrent>
+#include <array>
+#include <chrono>
 
 Logger* Logger::m_instance = nullptr;
+bool Logger::m_binaryMode = false;
+
+namespace {
+const char* const kLogBaseName = "app";
+
+QString activeLogSuffix(bool binary)
+{
+    return binary ? QStringLiteral(".binlog") : QStringLiteral(".log");
+}
+
+quint32 crc32(const QByteArray& data)
+{
+    static const auto table = []() {
+        std::array<quint32, 256> t{};
+        for (quint32 i = 0; i < 256; ++i) {
+            quint32 c = i;
+            for (int k = 0; k < 8; ++k) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[i] = c;
+        }
+        return t;
+    }();
+
+    quint32 crc = 0xFFFFFFFFu;
+    for (char ch : data) {
+        crc = table[(crc ^ static_cast<quint8>(ch)) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFFu;
+}
+
+// Wraps qCompress's deflate stream in a gzip container so archives open in any
+// standard tool. qCompress emits a 4-byte length, a 2-byte zlib header, the raw
+// deflate data and a 4-byte Adler-32 trailer.
+QByteArray gzipCompress(const QByteArray& data)
+{
+    const QByteArray zlib = qCompress(data, 9);
+    if (zlib.size() < 10) {
+        return QByteArray();
+    }
+
+    QByteArray out;
+    out.reserve(zlib.size() + 12);
+    const char header[10] = {'\x1f', '\x8b', 8, 0, 0, 0, 0, 0, 2, '\xff'};
+    out.append(header, sizeof(header));
+    out.append(zlib.constData() + 6, zlib.size() - 10);
+
+    const quint32 trailer[2] = {qToLittleEndian(crc32(data)),
+                                qToLittleEndian(static_cast<quint32>(data.size()))};
+    out.append(reinterpret_cast<const char*>(trailer), sizeof(trailer));
+    return out;
+}
+}
 
 // The global message handler function
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg)
@@ -21,73 +80,347 @@ Logger* Logger::instance()
     return m_instance;
 }
 
-Logger::Logger(QObject* parent) : QObject(parent), m_logFile(nullptr), m_logStream(nullptr)
+void Logger::setBinaryMode(bool enabled)
+{
+    m_binaryMode = enabled;
+}
+
+Logger::Logger(QObject* parent)
+    : QObject(parent),
+      m_logFile(nullptr),
+      m_logStream(nullptr),
+      m_logCreatedMs(0),
+      m_sessionWallMs(QDateTime::currentMSecsSinceEpoch()),
+      m_sessionMonotonicNs(BinaryLog::monotonicNs()),
+      m_nextSequence(1),
+      m_pending(0),
+      m_stopRequested(false),
+      m_flushRequested(0),
+      m_flushCompleted(0)
 {
     // Optional: Log to a file as well for persistence across sessions
-    QString logPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
-    QDir dir(logPath);
+    m_logDir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir dir(m_logDir);
     if (!dir.exists()) {
         dir.mkpath(".");
     }
-    m_logFile = new QFile(logPath + "/app.log");
-    if (m_logFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+    openLogFile();
+
+    // Compress anything a previous run rotated but didn't get to archive.
+    startArchiving();
+
+    const QString crashReport = m_crashRing.open(m_logDir + "/crash.ring", m_logDir, m_sessionWallMs, m_sessionMonotonicNs);
+
+    // All formatting and file I/O happens on this thread, never on the caller's.
+    m_writerThread = std::thread(&Logger::writerLoop, this);
+
+    if (!crashReport.isEmpty()) {
+        // Can't go through qWarning() here: instance() isn't set up yet.
+        logMessage(QtWarningMsg, QString("Previous session ended unexpectedly. Crash report written to %1").arg(crashReport));
+    }
+}
+
+Logger::~Logger()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_wakeMutex);
+        m_stopRequested = true;
+    }
+    m_wakeCondition.notify_one();
+    if (m_writerThread.joinable()) {
+        m_writerThread.join();
+    }
+    m_instance = nullptr;
+
+    closeLogFile();
+    m_archiveTask.waitForFinished();
+    m_crashRing.markCleanShutdown();
+}
+
+void Logger::logMessage(QtMsgType type, const QString &message)
+{
+    LogRecord record;
+    record.type = type;
+    record.monotonicNs = BinaryLog::monotonicNs();
+    record.message = message;
+    enqueue(std::move(record));
+}
+
+void Logger::logFormatted(QtMsgType type, quint16 formatId, QByteArray args)
+{
+    LogRecord record;
+    record.type = type;
+    record.monotonicNs = BinaryLog::monotonicNs();
+    record.formatId = formatId;
+    record.args = std::move(args);
+    enqueue(std::move(record));
+}
+
+void Logger::enqueue(LogRecord&& record)
+{
+    // Lands in the mapped crash ring right away, before any buffering.
+    if (record.formatId == BinaryLog::kTextFormatId) {
+        m_crashRing.append(record.monotonicNs, record.type, record.message);
+    } else {
+        m_crashRing.appendFormatted(record.monotonicNs, record.type, BinaryLog::formatString(record.formatId), record.args);
+    }
+
+    const QtMsgType type = record.type;
+    m_queue.push(std::move(record));
+
+    const int pending = m_pending.fetch_add(1, std::memory_order_acq_rel) + 1;
+    if (pending == 1) {
+        // The writer sleeps without a timeout while idle, so the first record
+        // after a quiet period has to wake it. Taking the mutex here closes the
+        // window between its predicate check and going to sleep.
+        { std::lock_guard<std::mutex> lock(m_wakeMutex); }
+        m_wakeCondition.notify_one();
+    } else if (pending == kBatchSize) {
+        m_wakeCondition.notify_one();
+    }
+
+    if (type == QtFatalMsg) {
+        // The process is about to abort; make sure this line reaches the disk.
+        flush();
+    }
+}
+
+void Logger::flush()
+{
+    if (std::this_thread::get_id() == m_writerThread.get_id()) {
+        return;
+    }
+
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    if (m_stopRequested) {
+        return;
+    }
+    const quint64 target = ++m_flushRequested;
+    m_wakeCondition.notify_one();
+    m_flushedCondition.wait(lock, [this, target]() { return m_flushCompleted >= target; });
+}
+
+void Logger::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_wakeMutex);
+    for (;;) {
+        auto urgent = [this]() {
+            return m_stopRequested || m_flushRequested != m_flushCompleted;
+        };
+
+        // Sleep until there is something to write...
+        m_wakeCondition.wait(lock, [this, &urgent]() {
+            return urgent() || m_pending.load(std::memory_order_acquire) > 0;
+        });
+        // ...then give the batch a moment to fill up unless someone is waiting on us.
+        m_wakeCondition.wait_for(lock, std::chrono::milliseconds(kFlushIntervalMs), [this, &urgent]() {
+            return urgent() || m_pending.load(std::memory_order_acquire) >= kBatchSize;
+        });
+
+        const bool stopping = m_stopRequested;
+        const quint64 flushTarget = m_flushRequested;
+        lock.unlock();
+
+        drainQueue();
+        rotateIfNeeded();
+
+        lock.lock();
+        if (flushTarget != m_flushCompleted) {
+            m_flushCompleted = flushTarget;
+            m_flushedCondition.notify_all();
+        }
+        if (stopping) {
+            break;
+        }
+    }
+}
+
+void Logger::drainQueue()
+{
+    QList<LogRecord> batch;
+    LogRecord record;
+    while (m_queue.pop(record)) {
+        m_pending.fetch_sub(1, std::memory_order_acq_rel);
+        record.sequence = m_nextSequence++;
+        batch.append(std::move(record));
+    }
+    if (batch.isEmpty()) {
+        return;
+    }
+
+    if (m_binaryMode) {
+        // Binary mode never builds text here; plain messages go out as format 0.
+        if (m_logFile && m_logFile->isOpen()) {
+            QByteArray buffer;
+            for (const LogRecord& entry : batch) {
+                const QByteArray args = entry.formatId == BinaryLog::kTextFormatId
+                                            ? BinaryLog::encodeArgs(entry.message)
+                                            : entry.args;
+                m_binaryWriter.appendEntry(buffer, entry.formatId, entry.type, entry.monotonicNs, args);
+            }
+            m_logFile->write(buffer);
+            m_logFile->flush();
+        }
+    } else if (m_logStream) {
+        for (const LogRecord& entry : batch) {
+            (*m_logStream) << formatRecord(entry) << "\n";
+        }
+        m_logStream->flush();
+    }
+
+    {
+        QMutexLocker locker(&m_mutex);
+        m_messages.append(batch);
+        if (m_messages.size() > kMaxMessagesInMemory) { // Keep last 2000 messages in memory
+            m_messages.remove(0, m_messages.size() - kMaxMessagesInMemory);
+        }
+    }
+
+    if (isSignalConnected(QMetaMethod::fromSignal(&Logger::recordsWritten))) {
+        emit recordsWritten(batch);
+    }
+}
+
+QString Logger::messageText(const LogRecord& record) const
+{
+    if (record.formatId == BinaryLog::kTextFormatId) {
+        return record.message;
+    }
+    return BinaryLog::formatMessage(QString::fromUtf8(BinaryLog::formatString(record.formatId)), record.args);
+}
+
+QString Logger::formatRecord(const LogRecord& record) const
+{
+    const QString text = messageText(record);
+    const qint64 wallMs = m_sessionWallMs + static_cast<qint64>((record.monotonicNs - m_sessionMonotonicNs) / 1000000);
+    return BinaryLog::formatLine(wallMs, record.type, text);
+}
+
+QList<LogRecord> Logger::getRecords() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_messages;
+}
+
+void Logger::openLogFile()
+{
+    const QString path = m_logDir + "/" + kLogBaseName + activeLogSuffix(m_binaryMode);
+    m_logFile = new QFile(path);
+    if (!m_logFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return;
+    }
+
+    // Age counts from when the file was started, not from when this process opened it.
+    const QDateTime born = QFileInfo(*m_logFile).birthTime();
+    m_logCreatedMs = (m_logFile->size() > 0 && born.isValid()) ? born.toMSecsSinceEpoch()
+                                                               : QDateTime::currentMSecsSinceEpoch();
+
+    if (m_binaryMode) {
+        QByteArray header;
+        if (m_logFile->size() == 0) {
+            m_binaryWriter.beginFile(header);
+        }
+        m_binaryWriter.beginSession(header, m_sessionWallMs, m_sessionMonotonicNs);
+        m_logFile->write(header);
+        m_logFile->flush();
+    } else {
         m_logStream = new QTextStream(m_logFile);
         m_logStream->setEncoding(QStringConverter::Utf8);
     }
 }
 
-Logger::~Logger()
+void Logger::closeLogFile()
 {
     if (m_logStream) {
         m_logStream->flush();
         delete m_logStream;
+        m_logStream = nullptr;
     }
     if (m_logFile) {
         m_logFile->close();
         delete m_logFile;
+        m_logFile = nullptr;
     }
 }
 
-void Logger::logMessage(QtMsgType type, const QString &message)
+void Logger::rotateIfNeeded()
 {
-    QString typeStr;
-    switch (type) {
-    case QtDebugMsg:
-        typeStr = "DEBUG";
-        break;
-    case QtInfoMsg:
-        typeStr = "INFO";
-        break;
-    case QtWarningMsg:
-        typeStr = "WARN";
-        break;
-    case QtCriticalMsg:
-        typeStr = "CRITICAL";
-        break;
-    case QtFatalMsg:
-        typeStr = "FATAL";
-        break;
-    }
-
-    QString formattedMessage = QString("%1 [%2] %3")
-        .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
-        .arg(typeStr)
-        .arg(message);
+    if (!m_logFile || !m_logFile->isOpen()) {
+        return;
+    }
 
-    QMutexLocker locker(&m_mutex);
-    m_messages.append(formattedMessage);
-    if (m_messages.size() > 2000) { // Keep last 2000 messages in memory
-        m_messages.removeFirst();
+    const qint64 now = QDateTime::currentMSecsSinceEpoch();
+    const bool tooBig = m_logFile->size() >= kMaxLogFileBytes;
+    const bool tooOld = m_logFile->size() > 0 && now - m_logCreatedMs >= kMaxLogAgeMs;
+    if (!tooBig && !tooOld) {
+        return;
     }
-    if (m_logStream) {
-        (*m_logStream) << formattedMessage << "\n";
-        m_logStream->flush();
+
+    // Everything written so far has already been flushed by drainQueue, and
+    // producers only touch the queue, so the swap can't lose a line.
+    const QString activePath = m_logFile->fileName();
+    const QString suffix = activeLogSuffix(m_binaryMode);
+    const QString stamp = QDateTime::fromMSecsSinceEpoch(now).toString("yyyyMMdd-hhmmsszzz");
+    const QString archivePath = m_logDir + "/" + kLogBaseName + "-" + stamp + suffix;
+
+    closeLogFile();
+    const bool renamed = QFile::rename(activePath, archivePath);
+    openLogFile();
+
+    if (renamed) {
+        startArchiving();
+    } else {
+        // Something else holds the file open; try again after another full period.
+        m_logCreatedMs = now;
     }
-    emit newMessage(formattedMessage);
 }
 
-QStringList Logger::getMessages() const
+void Logger::startArchiving()
 {
-    QMutexLocker locker(&m_mutex);
-    return m_messages;
-}
\ No newline at end of file
+    const QString logDir = m_logDir;
+    auto task = [logDir]() { archivePendingLogs(logDir, kMaxArchivedLogs); };
+
+    // Passes must not overlap or two of them could pick up the same file.
+    if (m_archiveTask.isRunning()) {
+        m_archiveTask = m_archiveTask.then(QtFuture::Launch::Async, task);
+    } else {
+        m_archiveTask = QtConcurrent::run(task);
+    }
+}
+
+void Logger::archivePendingLogs(const QString& logDir, int keep)
+{
+    QDir dir(logDir);
+    const QString prefix = QString(kLogBaseName) + "-";
+
+    // Rotated but uncompressed archives. The .gz only appears once it is
+    // complete (QSaveFile), and the original is removed after that, so a crash
+    // at any point leaves either the original or a valid archive behind.
+    const QStringList pending = dir.entryList({prefix + "*.log", prefix + "*.binlog"}, QDir::Files, QDir::Name);
+    for (const QString& name : pending) {
+        const QString sourcePath = dir.filePath(name);
+        const QString archivePath = sourcePath + ".gz";
+
+        if (!QFile::exists(archivePath)) {
+            QFile source(sourcePath);
+            if (!source.open(QIODevice::ReadOnly)) {
+                continue;
+            }
+            const QByteArray compressed = gzipCompress(source.readAll());
+            source.close();
+
+            QSaveFile archive(archivePath);
+            if (compressed.isEmpty() || !archive.open(QIODevice::WriteOnly) ||
+                archive.write(compressed) != compressed.size() || !archive.commit()) {
+                continue;
+            }
+        }
+        QFile::remove(sourcePath);
+    }
+
+    // Retention: timestamped names sort chronologically, newest last.
+    QStringList archives = dir.entryList({prefix + "*.gz"}, QDir::Files, QDir::Name);
+    while (archives.size() > keep) {
+        QFile::remove(dir.filePath(archives.takeFirst()));
+    }
+}
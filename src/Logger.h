@@ -6,10 +6,110 @@
 #include <QDateTime>
 #include <QFile>
 #include <QTextStream>
+#include <QFuture>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include "BinaryLog.h"
+#include "CrashRing.h"
+#include "MpscQueue.h"
 
 // Custom message handler to be installed with qInstallMessageHandler
 void messageHandler(QtMsgType type, const QMessageLogContext &context, const QString &msg);
 
+// Logs a static format string ("%1"-style placeholders) plus raw arguments.
+// The string is registered once per call site; only its ID and the encoded
+// arguments travel through the logger, so text is built lazily.
+#define LOG_FMT(type, format, ...)                                                    \
+    do                                                                                \
+    {                                                                                 \
+        static const quint16 logFormatId_ = BinaryLog::registerFormat(format);        \
+        Logger::instance()->logFormatted(type, logFormatId_,                          \
+                                         BinaryLog::encodeArgs(__VA_ARGS__));         \
+    } while (false)
+
+// Build-time log level: calls below it compile to nothing and their arguments
+// are never evaluated. 0 = debug, 1 = info, 2 = warning, 3 = critical.
+// CMake sets it to info for non-Debug builds.
+#ifndef OBSRC_MIN_LOG_LEVEL
+#define OBSRC_MIN_LOG_LEVEL 0
+#endif
+
+#define LOG_AT_LEVEL(level, type, format, ...)                                        \
+    do                                                                                \
+    {                                                                                 \
+        if constexpr ((level) >= OBSRC_MIN_LOG_LEVEL)                                 \
+        {                                                                             \
+            LOG_FMT(type, format, __VA_ARGS__);                                       \
+        }                                                                             \
+    } while (false)
+
+#define LOG_DEBUG(format, ...) LOG_AT_LEVEL(0, QtDebugMsg, format, __VA_ARGS__)
+#define LOG_INFO(format, ...) LOG_AT_LEVEL(1, QtInfoMsg, format, __VA_ARGS__)
+#define LOG_WARN(format, ...) LOG_AT_LEVEL(2, QtWarningMsg, format, __VA_ARGS__)
+#define LOG_CRITICAL(format, ...) LOG_AT_LEVEL(3, QtCriticalMsg, format, __VA_ARGS__)
+
+// Per-call-site throttle for the rate-limited macros below.
+class LogRateLimiter
+{
+public:
+    explicit LogRateLimiter(quint64 intervalMs) : m_intervalNs(intervalMs * 1000000) {}
+
+    // True if the call site may log now. suppressed receives how many calls
+    // were swallowed since the last one that got through.
+    bool allow(quint32& suppressed)
+    {
+        const quint64 now = BinaryLog::monotonicNs();
+        quint64 next = m_nextAllowedNs.load(std::memory_order_relaxed);
+        if (now < next || !m_nextAllowedNs.compare_exchange_strong(next, now + m_intervalNs, std::memory_order_relaxed)) {
+            m_suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressed = m_suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    const quint64 m_intervalNs;
+    std::atomic<quint64> m_nextAllowedNs{0};
+    std::atomic<quint32> m_suppressed{0};
+};
+
+// Logs at most once per intervalMs from this call site. Calls in between are
+// only counted (arguments aren't evaluated) and reported before the next line
+// that gets through.
+#define LOG_RATE_LIMITED(level, type, intervalMs, format, ...)                        \
+    do                                                                                \
+    {                                                                                 \
+        if constexpr ((level) >= OBSRC_MIN_LOG_LEVEL)                                 \
+        {                                                                             \
+            static LogRateLimiter logLimiter_(intervalMs);                            \
+            quint32 logSuppressed_ = 0;                                               \
+            if (logLimiter_.allow(logSuppressed_))                                    \
+            {                                                                         \
+                if (logSuppressed_ > 0)                                               \
+                    LOG_FMT(type, "Last message repeated %1 times", logSuppressed_);  \
+                LOG_FMT(type, format, __VA_ARGS__);                                   \
+            }                                                                         \
+        }                                                                             \
+    } while (false)
+
+#define LOG_DEBUG_LIMITED(intervalMs, format, ...) LOG_RATE_LIMITED(0, QtDebugMsg, intervalMs, format, __VA_ARGS__)
+#define LOG_WARN_LIMITED(intervalMs, format, ...) LOG_RATE_LIMITED(2, QtWarningMsg, intervalMs, format, __VA_ARGS__)
+
+// A single log call as captured on the producing thread. Formatting happens
+// later on the writer thread.
+struct LogRecord
+{
+    quint64 sequence = 0; // Assigned by the writer thread, strictly increasing
+    QtMsgType type = QtDebugMsg;
+    quint64 monotonicNs = 0;
+    quint16 formatId = BinaryLog::kTextFormatId;
+    QString message;  // formatId == kTextFormatId
+    QByteArray args;  // otherwise: encoded arguments for the format string
+};
+
 class Logger : public QObject
 {
     Q_OBJECT
@@ -17,11 +117,29 @@ class Logger : public QObject
 public:
     static Logger* instance();
 
+    // Must be called before the first message is logged. Binary mode writes
+    // app.binlog (see BinaryLog.h) instead of the plain-text app.log.
+    static void setBinaryMode(bool enabled);
+
+    // Cheap on the calling thread: stamps the record and pushes it onto a
+    // lock-free queue. Fatal messages block until they are on disk.
     void logMessage(QtMsgType type, const QString &message);
-    QStringList getMessages() const;
+    void logFormatted(QtMsgType type, quint16 formatId, QByteArray args);
+
+    // Snapshot of the most recent records (up to kMaxMessagesInMemory).
+    QList<LogRecord> getRecords() const;
+    // Renders a record as the line that goes to app.log.
+    QString formatRecord(const LogRecord& record) const;
+    // Only the message part of formatRecord(), without timestamp and level.
+    QString messageText(const LogRecord& record) const;
+
+    // Blocks until everything enqueued before the call has been written and flushed.
+    void flush();
 
 signals:
-    void newMessage(const QString& message);
+    // One signal per written batch, emitted from the writer thread and only
+    // while something is connected. Records are not formatted.
+    void recordsWritten(const QList<LogRecord>& records);
 
 private:
     Logger(QObject* parent = nullptr);
@@ -29,9 +147,50 @@ private:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    void enqueue(LogRecord&& record);
+    void writerLoop();
+    void drainQueue();
+
+    // Log file lifecycle. Rotation only ever runs on the writer thread,
+    // between batches, so nothing is in flight while the file is swapped.
+    void openLogFile();
+    void closeLogFile();
+    void rotateIfNeeded();
+    void startArchiving();
+    static void archivePendingLogs(const QString& logDir, int keep);
+
+    // Flush policy for the writer thread
+    static constexpr int kBatchSize = 256;
+    static constexpr int kFlushIntervalMs = 500;
+    static constexpr int kMaxMessagesInMemory = 2000;
+
+    // Rotation policy
+    static constexpr qint64 kMaxLogFileBytes = 10 * 1024 * 1024;
+    static constexpr qint64 kMaxLogAgeMs = 24LL * 60 * 60 * 1000;
+    static constexpr int kMaxArchivedLogs = 10;
+
     static Logger* m_instance;
-    QStringList m_messages;
+    static bool m_binaryMode;
+    QList<LogRecord> m_messages;
     mutable QMutex m_mutex;
+    QString m_logDir;
     QFile* m_logFile;
     QTextStream* m_logStream;
-};
\ No newline at end of file
+    qint64 m_logCreatedMs; // For age-based rotation
+    QFuture<void> m_archiveTask;
+    CrashRing m_crashRing;
+    BinaryLog::Writer m_binaryWriter;
+    qint64 m_sessionWallMs;       // Wall clock at m_sessionMonotonicNs, used to
+    quint64 m_sessionMonotonicNs; // turn monotonic timestamps into dates
+
+    MpscQueue<LogRecord> m_queue;
+    quint64 m_nextSequence; // writer thread only
+    std::atomic<int> m_pending;
+    std::thread m_writerThread;
+    std::mutex m_wakeMutex;
+    std::condition_variable m_wakeCondition;
+    std::condition_variable m_flushedCondition;
+    bool m_stopRequested;
+    quint64 m_flushRequested; // guarded by m_wakeMutex
+    quint64 m_flushCompleted; // guarded by m_wakeMutex
+};
@@ -0,0 +1,340 @@
+#include "LoudnessMeter.h"
+#include <obs.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+constexpr double kAbsoluteGateLufs = -70.0;
+constexpr double kRelativeGateLu = -10.0;
+
+quint64 nowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+double toLufs(double meanSquare)
+{
+    if (meanSquare <= 0.0) {
+        return LoudnessMeter::kSilenceLufs;
+    }
+    return std::max(LoudnessMeter::kSilenceLufs, -0.691 + 10.0 * std::log10(meanSquare));
+}
+
+double fromLufs(double lufs)
+{
+    return std::pow(10.0, (lufs + 0.691) / 10.0);
+}
+}
+
+LoudnessMeter::LoudnessMeter()
+    : m_history(kHistoryBlocks, 0.0f),
+      m_historyPeaks(kHistoryBlocks, 0.0f)
+{
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    detach();
+}
+
+void LoudnessMeter::attach(obs_source_t *source)
+{
+    detach();
+    if (!source) {
+        return;
+    }
+
+    configure();
+    m_weakSource = obs_source_get_weak_source(source);
+    obs_source_add_audio_capture_callback(source, &LoudnessMeter::sourceCallback, this);
+}
+
+void LoudnessMeter::attachOutputMix(size_t mixIndex)
+{
+    detach();
+    if (!obs_get_audio()) {
+        return;
+    }
+
+    configure();
+    m_mixIndex = mixIndex;
+    m_mixAttached = true;
+    // Float planar at the output rate, same as the source callbacks
+    obs_add_raw_audio_callback(mixIndex, nullptr, &LoudnessMeter::mixCallback, this);
+}
+
+void LoudnessMeter::detach()
+{
+    if (m_weakSource) {
+        if (obs_source_t *source = obs_weak_source_get_source(m_weakSource)) {
+            // Takes the source's callback mutex, so no callback is running once this returns.
+            obs_source_remove_audio_capture_callback(source, &LoudnessMeter::sourceCallback, this);
+            obs_source_release(source);
+        }
+        obs_weak_source_release(m_weakSource);
+        m_weakSource = nullptr;
+    }
+    if (m_mixAttached) {
+        obs_remove_raw_audio_callback(m_mixIndex, &LoudnessMeter::mixCallback, this);
+        m_mixAttached = false;
+    }
+    reset();
+}
+
+void LoudnessMeter::configure()
+{
+    obs_audio_info info = {};
+    const double sampleRate = obs_get_audio_info(&info) ? info.samples_per_sec : 48000.0;
+    const size_t channels = obs_get_audio() ? audio_output_get_channels(obs_get_audio()) : 2;
+    m_channels = std::clamp(static_cast<int>(channels), 1, kMaxChannels);
+    m_blockFrames = std::max(1, static_cast<int>(std::lround(sampleRate / kBlocksPerSecond)));
+
+    // BS.1770 channel weights for OBS's layouts (FL FR FC LFE RL RR [SL SR]):
+    // LFE is ignored, surrounds count ~+1.5 dB.
+    for (int c = 0; c < kMaxChannels; ++c) {
+        double weight = 1.0;
+        if (m_channels >= 6 && c == 3) {
+            weight = 0.0;
+        } else if (m_channels >= 6 && c >= 4) {
+            weight = 1.41;
+        }
+        m_channelWeight[c] = weight;
+    }
+
+    // K-weighting pre-filter and RLB high pass, derived for the actual rate
+    // (the coefficient tables in BS.1770 are for 48 kHz only).
+    {
+        const double f0 = 1681.974450955533;
+        const double gainDb = 3.999843853973347;
+        const double q = 0.7071752369554196;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double vh = std::pow(10.0, gainDb / 20.0);
+        const double vb = std::pow(vh, 0.4996667741545416);
+        const double a0 = 1.0 + k / q + k * k;
+        m_stages[0] = {(vh + vb * k / q + k * k) / a0, 2.0 * (k * k - vh) / a0, (vh - vb * k / q + k * k) / a0,
+                       2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+    {
+        const double f0 = 38.13547087602444;
+        const double q = 0.5003270373238773;
+        const double k = std::tan(kPi * f0 / sampleRate);
+        const double a0 = 1.0 + k / q + k * k;
+        m_stages[1] = {1.0, -2.0, 1.0, 2.0 * (k * k - 1.0) / a0, (1.0 - k / q + k * k) / a0};
+    }
+
+    reset();
+}
+
+void LoudnessMeter::reset()
+{
+    m_channelState = {};
+    m_blockSum = {};
+    m_framesInBlock = 0;
+    m_blockPeak = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        m_historyPos = 0;
+        m_historyCount = 0;
+    }
+    m_momentary.store(kSilenceLufs, std::memory_order_relaxed);
+    m_shortTerm.store(kSilenceLufs, std::memory_order_relaxed);
+    m_lastBlockNs.store(0, std::memory_order_relaxed);
+}
+
+void LoudnessMeter::sourceCallback(void *param, obs_source_t *, const audio_data *audio, bool muted)
+{
+    static_cast<LoudnessMeter *>(param)->process(audio, muted);
+}
+
+void LoudnessMeter::mixCallback(void *param, size_t, audio_data *audio)
+{
+    static_cast<LoudnessMeter *>(param)->process(audio, false);
+}
+
+void LoudnessMeter::process(const audio_data *audio, bool muted)
+{
+    if (!audio) {
+        return;
+    }
+
+    // Sub-blocks usually end mid-packet, so walk the packet in runs that stop
+    // at block boundaries. Each run filters one channel at a time through
+    // both stages, keeping the filter state in registers.
+    uint32_t offset = 0;
+    while (offset < audio->frames) {
+        const uint32_t run = std::min<uint32_t>(audio->frames - offset, m_blockFrames - m_framesInBlock);
+
+        for (int c = 0; c < m_channels; ++c) {
+            const float *samples = reinterpret_cast<const float *>(audio->data[c]);
+            if (muted || !samples || m_channelWeight[c] == 0.0) {
+                continue;
+            }
+
+            const Biquad &s1 = m_stages[0];
+            const Biquad &s2 = m_stages[1];
+            double z10 = m_channelState[c].z[0][0], z11 = m_channelState[c].z[0][1];
+            double z20 = m_channelState[c].z[1][0], z21 = m_channelState[c].z[1][1];
+            double sum = 0.0;
+            float peak = m_blockPeak;
+
+            for (uint32_t i = offset; i < offset + run; ++i) {
+                const double x = samples[i];
+                peak = std::max(peak, std::fabs(samples[i]));
+
+                const double y1 = s1.b0 * x + z10;
+                z10 = s1.b1 * x - s1.a1 * y1 + z11;
+                z11 = s1.b2 * x - s1.a2 * y1;
+
+                const double y2 = s2.b0 * y1 + z20;
+                z20 = s2.b1 * y1 - s2.a1 * y2 + z21;
+                z21 = s2.b2 * y1 - s2.a2 * y2;
+
+                sum += y2 * y2;
+            }
+
+            m_channelState[c].z[0][0] = z10;
+            m_channelState[c].z[0][1] = z11;
+            m_channelState[c].z[1][0] = z20;
+            m_channelState[c].z[1][1] = z21;
+            m_blockSum[c] += sum;
+            m_blockPeak = peak;
+        }
+
+        offset += run;
+        m_framesInBlock += static_cast<int>(run);
+        if (m_framesInBlock >= m_blockFrames) {
+            finishBlock();
+        }
+    }
+}
+
+void LoudnessMeter::finishBlock()
+{
+    double energy = 0.0;
+    for (int c = 0; c < m_channels; ++c) {
+        energy += m_channelWeight[c] * m_blockSum[c] / m_blockFrames;
+    }
+    m_blockSum = {};
+    m_framesInBlock = 0;
+
+    double momentary = 0.0;
+    double shortTerm = 0.0;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        m_history[m_historyPos] = static_cast<float>(energy);
+        m_historyPeaks[m_historyPos] = m_blockPeak;
+        m_historyPos = (m_historyPos + 1) % kHistoryBlocks;
+        m_historyCount = std::min(m_historyCount + 1, kHistoryBlocks);
+
+        const int shortBlocks = std::min(m_historyCount, kShortTermBlocks);
+        for (int i = 1; i <= shortBlocks; ++i) {
+            const double block = m_history[(m_historyPos - i + kHistoryBlocks) % kHistoryBlocks];
+            shortTerm += block;
+            if (i <= kMomentaryBlocks) {
+                momentary += block;
+            }
+        }
+        momentary /= std::min(shortBlocks, kMomentaryBlocks);
+        shortTerm /= shortBlocks;
+    }
+    m_blockPeak = 0.0f;
+
+    m_momentary.store(toLufs(momentary), std::memory_order_relaxed);
+    m_shortTerm.store(toLufs(shortTerm), std::memory_order_relaxed);
+    m_lastBlockNs.store(nowNs(), std::memory_order_relaxed);
+}
+
+bool LoudnessMeter::isLive() const
+{
+    const quint64 last = m_lastBlockNs.load(std::memory_order_relaxed);
+    return last != 0 && nowNs() - last < kStaleAfterNs;
+}
+
+LoudnessStats LoudnessMeter::measure(double seconds, double skipSeconds) const
+{
+    std::vector<double> blocks;
+    float peak = 0.0f;
+    {
+        std::lock_guard<std::mutex> lock(m_historyMutex);
+        const int skipped = std::clamp(static_cast<int>(std::lround(skipSeconds * kBlocksPerSecond)), 0, m_historyCount);
+        const int wanted = static_cast<int>(std::lround(seconds * kBlocksPerSecond));
+        const int count = std::clamp(wanted, 0, m_historyCount - skipped);
+        blocks.reserve(count);
+        for (int i = count + skipped; i > skipped; --i) {
+            const int index = (m_historyPos - i + kHistoryBlocks) % kHistoryBlocks;
+            blocks.push_back(m_history[index]);
+            peak = std::max(peak, m_historyPeaks[index]);
+        }
+    }
+
+    LoudnessStats stats;
+    const int count = static_cast<int>(blocks.size());
+    stats.seconds = static_cast<double>(count) / kBlocksPerSecond;
+    stats.samplePeak = peak > 0.0f ? std::max(kSilenceLufs, 20.0 * std::log10(peak)) : kSilenceLufs;
+    if (count == 0) {
+        return stats;
+    }
+
+    // 400 ms gating blocks overlapping by 75%, i.e. one per sub-block once
+    // four are available; a shorter stretch is treated as a single block.
+    std::vector<double> gatingBlocks;
+    const int gatingSpan = std::min(count, kMomentaryBlocks);
+    double running = 0.0;
+    for (int i = 0; i < count; ++i) {
+        running += blocks[i];
+        if (i >= gatingSpan) {
+            running -= blocks[i - gatingSpan];
+        }
+        if (i >= gatingSpan - 1) {
+            gatingBlocks.push_back(running / gatingSpan);
+        }
+    }
+
+    const int shortSpan = std::min(count, kShortTermBlocks);
+    running = 0.0;
+    double maxShortTerm = 0.0;
+    for (int i = 0; i < count; ++i) {
+        running += blocks[i];
+        if (i >= shortSpan) {
+            running -= blocks[i - shortSpan];
+        }
+        if (i >= shortSpan - 1) {
+            maxShortTerm = std::max(maxShortTerm, running / shortSpan);
+        }
+    }
+    stats.maxShortTerm = toLufs(maxShortTerm);
+
+    // Two-pass gating: absolute at -70 LUFS, then relative at 10 LU below
+    // the loudness of what passed the first gate.
+    const double absoluteGate = fromLufs(kAbsoluteGateLufs);
+    double gatedSum = 0.0;
+    int gatedCount = 0;
+    double maxMomentary = 0.0;
+    for (double block : gatingBlocks) {
+        maxMomentary = std::max(maxMomentary, block);
+        if (block > absoluteGate) {
+            gatedSum += block;
+            ++gatedCount;
+        }
+    }
+    stats.maxMomentary = toLufs(maxMomentary);
+    if (gatedCount == 0) {
+        return stats;
+    }
+
+    const double relativeGate = fromLufs(toLufs(gatedSum / gatedCount) + kRelativeGateLu);
+    gatedSum = 0.0;
+    gatedCount = 0;
+    for (double block : gatingBlocks) {
+        if (block > absoluteGate && block > relativeGate) {
+            gatedSum += block;
+            ++gatedCount;
+        }
+    }
+    stats.integrated = gatedCount > 0 ? toLufs(gatedSum / gatedCount) : kSilenceLufs;
+    return stats;
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <mutex>
+#include <vector>
+#include <QtGlobal>
+
+struct obs_source;
+typedef struct obs_source obs_source_t;
+struct obs_weak_source;
+typedef struct obs_weak_source obs_weak_source_t;
+struct audio_data;
+
+// Loudness over a stretch of recent audio, per ITU-R BS.1770-4 / EBU R128.
+struct LoudnessStats
+{
+    double integrated = -70.0;   // LUFS, gated
+    double maxMomentary = -70.0; // LUFS, loudest 400 ms block
+    double maxShortTerm = -70.0; // LUFS, loudest 3 s window
+    double samplePeak = -70.0;   // dBFS
+    double seconds = 0.0;        // Audio actually covered, may be less than asked for
+    bool partial = false;        // Set by callers when that falls short of what was saved
+
+    bool isSilent() const { return integrated <= -70.0; }
+};
+
+// EBU R128 meter. Audio is K-weighted on the OBS audio thread and reduced to
+// the mean square of every 100 ms sub-block; momentary (400 ms) and
+// short-term (3 s) loudness are published through atomics, and a few minutes
+// of sub-blocks are kept so the gated integrated loudness of any recent
+// stretch (e.g. what a replay clip holds) can be computed afterwards.
+//
+// Feeds either from one source's audio capture callback or from an output
+// mix, which is exactly what the encoders see.
+class LoudnessMeter
+{
+public:
+    static constexpr double kSilenceLufs = -70.0;
+    static constexpr int kHistorySeconds = 300;
+
+    LoudnessMeter();
+    ~LoudnessMeter();
+    LoudnessMeter(const LoudnessMeter &) = delete;
+    LoudnessMeter &operator=(const LoudnessMeter &) = delete;
+
+    // Owning thread only. Attaching to anything detaches from the previous feed.
+    void attach(obs_source_t *source);
+    void attachOutputMix(size_t mixIndex);
+    void detach();
+    bool isAttached() const { return m_weakSource != nullptr || m_mixAttached; }
+
+    // False once no audio has been measured for a while. Safe from any thread.
+    bool isLive() const;
+
+    // LUFS, kSilenceLufs when quiet or detached. Safe from any thread.
+    double momentary() const { return m_momentary.load(std::memory_order_relaxed); }
+    double shortTerm() const { return m_shortTerm.load(std::memory_order_relaxed); }
+
+    // Stats over `seconds` of audio ending `skipSeconds` ago. Safe from any thread.
+    LoudnessStats measure(double seconds, double skipSeconds = 0.0) const;
+
+private:
+    static constexpr int kBlocksPerSecond = 10; // 100 ms sub-blocks
+    static constexpr int kMomentaryBlocks = 4;
+    static constexpr int kShortTermBlocks = 30;
+    static constexpr int kHistoryBlocks = kHistorySeconds * kBlocksPerSecond;
+    static constexpr int kMaxChannels = 8;
+    static constexpr quint64 kStaleAfterNs = 500000000; // 500 ms
+
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+    };
+    struct ChannelState
+    {
+        double z[2][2] = {}; // Transposed direct form II state, per stage
+    };
+
+    static void sourceCallback(void *param, obs_source_t *source, const audio_data *audio, bool muted);
+    static void mixCallback(void *param, size_t mixIndex, audio_data *audio);
+    void configure();
+    void process(const audio_data *audio, bool muted);
+    void finishBlock();
+    void reset();
+
+    obs_weak_source_t *m_weakSource = nullptr;
+    bool m_mixAttached = false;
+    size_t m_mixIndex = 0;
+
+    // Audio thread only while attached
+    std::array<Biquad, 2> m_stages{}; // High shelf, then high pass
+    std::array<ChannelState, kMaxChannels> m_channelState{};
+    std::array<double, kMaxChannels> m_channelWeight{};
+    std::array<double, kMaxChannels> m_blockSum{};
+    int m_channels = 2;
+    int m_blockFrames = 4800;
+    int m_framesInBlock = 0;
+    float m_blockPeak = 0.0f;
+
+    // Ring of per-sub-block weighted mean squares and sample peaks
+    mutable std::mutex m_historyMutex;
+    std::vector<float> m_history;
+    std::vector<float> m_historyPeaks;
+    int m_historyPos = 0;
+    int m_historyCount = 0;
+
+    std::atomic<double> m_momentary{kSilenceLufs};
+    std::atomic<double> m_shortTerm{kSilenceLufs};
+    std::atomic<quint64> m_lastBlockNs{0};
+};
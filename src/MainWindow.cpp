@@ -1,5 +1,10 @@
 #include "MainWindow.h"
 #include "LogDialog.h"
+#include "MeterPanel.h"
+#include "FrameClock.h"
+#include "Trace.h"
+#include "Logger.h"
+#include "SettingsStore.h"
 #include <QtWidgets/QApplication>
 #include <QMessageBox>
 #include <QStandardPaths>
@@ -14,15 +19,22 @@
 #include <QAction>
 #include <QDebug>
 #include <QSettings>
+#include <QDateTime>
 #include <QVariantMap>
+#include <QSignalBlocker>
+#include <vector>
 #include <QIcon>
 #include <mmsystem.h>
 #include <QRegularExpressionValidator>
 #include <tlhelp32.h>
+#include <psapi.h>
 
 #include <obs.hpp>
 #include <obs-frontend-api.h>
 
+// Global while tracing is on; not user-configurable since it is a diagnostics tool
+static const QKeySequence TRACE_EXPORT_SEQUENCE("Ctrl+Alt+Shift+T");
+
 // Helper function to update profile combo boxes based on codec
 static void updateProfileComboBox(QComboBox *combo, bool is_hevc, const QStringList &h264_profiles, const QStringList &hevc_profiles)
 {
@@ -51,24 +63,65 @@ static void updateProfileComboBox(QComboBox *combo, bool is_hevc, const QStringL
     combo->blockSignals(false);
 }
 
-MainWindow::MainWindow(GameCapture *capture, QWidget *parent)
+// A device the user picked is used while it's plugged in, "default" otherwise.
+// Until the devices are enumerated the pick is assumed to be there.
+static QString availableDeviceId(const QList<QPair<QString, QString>> &devices, const QString &preferredId)
+{
+    if (devices.isEmpty())
+        return preferredId;
+    for (const auto &device : devices)
+    {
+        if (device.first == preferredId)
+            return preferredId;
+    }
+    return "default";
+}
+
+static void fillDeviceCombo(QComboBox *combo, const QList<QPair<QString, QString>> &devices, const QString &selectedId)
+{
+    const QSignalBlocker blocker(combo);
+    combo->clear();
+    for (const auto &device : devices)
+        combo->addItem(device.second, device.first);
+    const int index = combo->findData(selectedId);
+    if (index != -1)
+        combo->setCurrentIndex(index);
+}
+
+// For comparing the window's footprint loaded and unloaded
+static QString memoryUsage()
+{
+    PROCESS_MEMORY_COUNTERS_EX counters = {};
+    counters.cb = sizeof(counters);
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS *>(&counters), sizeof(counters)))
+        return "unknown";
+    return QString("working set %1 MB, private %2 MB")
+        .arg(counters.WorkingSetSize / (1024.0 * 1024.0), 0, 'f', 1)
+        .arg(counters.PrivateUsage / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+MainWindow::MainWindow(ObsControlThread *obs, const AppSettings &settings, QWidget *parent)
     : QMainWindow(parent),
-      m_capture(capture),
+      m_obs(obs),
+      m_capture(obs->capture()),
       m_trayIcon(nullptr),
       m_processMonitor(nullptr),
       m_processMonitorThread(nullptr),
       m_globalHotkey(nullptr),
       m_keybindDialog(nullptr),
+      m_deviceWatcher(new AudioDeviceWatcher(this)),
       m_logDialog(nullptr),
       m_clippingState(DISABLED),
       m_gameDetected(false),
       m_audioVisualizer(nullptr),
       m_microphoneVisualizer(nullptr),
-      m_visualizerUpdateTimer(nullptr), // <-- MODIFIED
-      m_audioVolmeter(nullptr),
-      m_microphoneVolmeter(nullptr),
-      m_currentAudioLevel(0.0f),
-      m_currentMicrophoneLevel(0.0f)
+      m_desktopMeter(m_meterBank.addMeter("Desktop Audio")),
+      m_microphoneMeter(m_meterBank.addMeter("Microphone")),
+      m_meterGroup(nullptr),
+      m_meterPanel(nullptr),
+      m_settings(settings),
+      m_activeAudioDeviceId(QString::fromStdString(settings.audio.deviceId)),
+      m_activeMicDeviceId(QString::fromStdString(settings.microphone.deviceId))
 {
     // Set window icon
     setWindowIcon(QIcon(":/logo.ico"));
@@ -76,45 +129,50 @@ MainWindow::MainWindow(GameCapture *capture, QWidget *parent)
     setMinimumSize(420, 550);
     resize(450, 800);
 
-    m_outputFolder = QStandardPaths::writableLocation(QStandardPaths::MoviesLocation) + "/Clips";
-
     setupMenuBar();
     setupUI();
+    m_uiLoaded = true;
     setupTrayIcon();
     applyStyles();
-    loadSettings();
+    loadSettings(settings);
     setupGlobalHotkeys();
 
     connect(m_capture, &GameCapture::clippingModeChanged, this, &MainWindow::onClippingModeChanged);
-    connect(m_capture, &GameCapture::recordingStarted, [this]()
+    connect(m_capture, &GameCapture::recordingStarted, this, [this]()
             {
+    if (!m_uiLoaded)
+        return;
     m_statusLabel->setText("Saving clip...");
     m_statusLabel->setStyleSheet("color: #b0b0b0;"); });
-    connect(m_capture, &GameCapture::recordingFinished, [this](bool success, const QString &filename)
+    connect(m_capture, &GameCapture::recordingFinished, this, [this](bool success, const QString &filename)
             {
-    // Re-enable the save clip button here.
-    m_clipButton->setEnabled(true);
+    // Re-enable the save buttons here. Audio-only saves also end up here,
+    // with or without clipping mode.
+    if (m_uiLoaded) {
+        m_clipButton->setEnabled(m_clippingState == ACTIVE);
+        m_saveAudioReplayButton->setEnabled(m_capture->IsAudioReplayActive());
+        m_statusLabel->setText(success ? "Clip saved successfully!" : "Failed to save clip!");
+        m_statusLabel->setStyleSheet(success ? "color: #ffffff;" : "color: #909090;");
+    }
 
     if (success) {
-        m_statusLabel->setText("Clip saved successfully!");
-        m_statusLabel->setStyleSheet("color: #ffffff;");
-        if (m_soundEnabledCheckBox->isChecked()) {
+        if (m_settings.notificationSound) {
             playNotificationSound();
         }
-        if (m_trayNotificationsCheckBox->isChecked() && m_trayIcon && m_trayIcon->isVisible()) {
+        if (m_settings.trayNotifications && m_trayIcon && m_trayIcon->isVisible()) {
             m_trayIcon->showMessage("Clip Saved",
                 QString("Clip saved: %1").arg(QFileInfo(filename).fileName()),
                 QSystemTrayIcon::Information, 3000);
         }
-    } else {
-        m_statusLabel->setText("Failed to save clip!");
-        m_statusLabel->setStyleSheet("color: #909090;");
     } });
 
 
-    // Initial refresh
-    refreshAudioDevices();
-    refreshMicrophoneDevices();
+    // The watcher pushes the device lists once enumerated and again on every hot-plug
+    connect(m_deviceWatcher, &AudioDeviceWatcher::outputDevicesChanged, this, &MainWindow::onAudioDevicesReceived);
+    connect(m_deviceWatcher, &AudioDeviceWatcher::inputDevicesChanged, this, &MainWindow::onMicrophoneDevicesReceived);
+    connect(m_deviceWatcher, &AudioDeviceWatcher::defaultDeviceChanged, this, [](bool input, const QString &deviceId)
+            { LOG_INFO("Default %1 device is now %2", input ? QString("input") : QString("output"), deviceId); });
+    m_deviceWatcher->start();
 
     qDebug() << "Application startup complete. UI is initialized.";
 }
@@ -123,36 +181,37 @@ MainWindow::~MainWindow()
 {
     stopProcessMonitor();
     saveSettings();
-    if (m_autoStartCheckBox && !m_autoStartCheckBox->isChecked())
+    SettingsStore::instance().flush();
+    if (!m_settings.autoStart)
     {
         removeAutoStart();
     }
 
     // Ensure volmeters are destroyed on exit
-    if (m_audioVolmeter)
-    {
-        obs_volmeter_destroy(m_audioVolmeter);
-    }
-    if (m_microphoneVolmeter)
-    {
-        obs_volmeter_destroy(m_microphoneVolmeter);
-    }
+    m_audioSpectrum.detach();
+    m_microphoneSpectrum.detach();
+    m_audioLoudness.detach();
+    m_microphoneLoudness.detach();
 }
 
 void MainWindow::postInitRefresh()
 {
-    if (!m_capture || !m_capture->IsInitialized())
+    if (!m_capture->IsInitialized())
         return;
 
-    refreshEncoders();
-    onEncodingSettingsChanged();
+    if (m_uiLoaded)
+    {
+        refreshEncoders();
+        onEncodingSettingsChanged();
+    }
     onAudioSettingsChanged();
     onMicrophoneSettingsChanged();
+    onAudioReplayChanged();
 
     updateUiForState();
 
     bool autostarted = QCoreApplication::arguments().contains("--autostart");
-    if (autostarted && m_startClippingAutomaticallyCheckBox->isChecked())
+    if (autostarted && m_settings.startClippingAutomatically)
     {
         qDebug() << "Autostart detected, enabling clipping mode.";
         QTimer::singleShot(100, this, &MainWindow::toggleClippingMode);
@@ -177,9 +236,6 @@ void MainWindow::setupUI()
     m_settingsTabs->addTab(createAudioSettingsTab(), "Audio");
     m_settingsTabs->addTab(createNotificationSettingsTab(), "Notifications");
     mainLayout->addWidget(m_settingsTabs);
-
-    m_visualizerUpdateTimer = new QTimer(this);
-    connect(m_visualizerUpdateTimer, &QTimer::timeout, this, &MainWindow::updateVisualizers);
 }
 
 QWidget *MainWindow::createMainControls()
@@ -211,6 +267,18 @@ QWidget *MainWindow::createMainControls()
     connect(m_clipLengthCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onClipLengthChanged);
     layout->addWidget(m_clipLengthCombo);
 
+    layout->addWidget(new QLabel("Merge Saves:"));
+    m_saveBurstWindowSpinBox = new QSpinBox;
+    m_saveBurstWindowSpinBox->setRange(0, 30);
+    m_saveBurstWindowSpinBox->setValue(0);
+    m_saveBurstWindowSpinBox->setSuffix("s");
+    m_saveBurstWindowSpinBox->setSpecialValueText("Off");
+    m_saveBurstWindowSpinBox->setToolTip("Saves within this many seconds of each other become one longer clip.\n"
+                                         "The clip is only written once the time is up, so every save waits that long,\n"
+                                         "and is lost if clipping is stopped before then.");
+    connect(m_saveBurstWindowSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onSaveBurstWindowChanged);
+    layout->addWidget(m_saveBurstWindowSpinBox);
+
     return container;
 }
 
@@ -303,6 +371,9 @@ QWidget *MainWindow::createGeneralSettingsTab()
     settingsLayout->addWidget(m_minimizeToTrayCheckBox);
     m_startClippingAutomaticallyCheckBox = new QCheckBox("Enable clipping when app starts with Windows");
     settingsLayout->addWidget(m_startClippingAutomaticallyCheckBox);                                      
+    m_unloadWindowInTrayCheckBox = new QCheckBox("Free the window's memory while in the tray");
+    m_unloadWindowInTrayCheckBox->setToolTip("The window is rebuilt when shown again, which takes a moment.");
+    settingsLayout->addWidget(m_unloadWindowInTrayCheckBox);
     layout->addWidget(settingsGroup);
 
     layout->addStretch();
@@ -528,7 +599,7 @@ QWidget *MainWindow::createAudioSettingsTab()
     connect(m_audioDeviceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onAudioDeviceChanged);
     deviceLayout->addWidget(m_audioDeviceCombo);
     m_refreshAudioButton = new QPushButton("Refresh");
-    connect(m_refreshAudioButton, &QPushButton::clicked, this, &MainWindow::refreshAudioDevices);
+    connect(m_refreshAudioButton, &QPushButton::clicked, m_deviceWatcher, &AudioDeviceWatcher::rescan);
     deviceLayout->addWidget(m_refreshAudioButton);
     audioLayout->addLayout(deviceLayout);
     QHBoxLayout *volumeLayout = new QHBoxLayout;
@@ -545,10 +616,30 @@ QWidget *MainWindow::createAudioSettingsTab()
     volumeLayout->addWidget(m_audioVolumeSlider);
     volumeLayout->addWidget(m_volumeLabel);
     audioLayout->addLayout(volumeLayout);
+    QHBoxLayout *loudnessLayout = new QHBoxLayout;
+    m_normalizeLoudnessCheckBox = new QCheckBox("Normalize saved clips to");
+    m_normalizeLoudnessCheckBox->setToolTip("Re-encodes the audio of each saved clip to the target loudness (EBU R128). Video is copied untouched. Requires ffmpeg on PATH.");
+    connect(m_normalizeLoudnessCheckBox, &QCheckBox::toggled, this, &MainWindow::onLoudnessNormalizationChanged);
+    loudnessLayout->addWidget(m_normalizeLoudnessCheckBox);
+    m_targetLoudnessSpinBox = new QDoubleSpinBox;
+    m_targetLoudnessSpinBox->setRange(-30.0, -10.0);
+    m_targetLoudnessSpinBox->setSingleStep(0.5);
+    m_targetLoudnessSpinBox->setDecimals(1);
+    m_targetLoudnessSpinBox->setSuffix(" LUFS");
+    m_targetLoudnessSpinBox->setValue(-16.0);
+    m_targetLoudnessSpinBox->setEnabled(false);
+    connect(m_targetLoudnessSpinBox, QOverload<double>::of(&QDoubleSpinBox::valueChanged), this, &MainWindow::onLoudnessNormalizationChanged);
+    loudnessLayout->addWidget(m_targetLoudnessSpinBox);
+    loudnessLayout->addStretch();
+    audioLayout->addLayout(loudnessLayout);
     m_showAudioLevelsCheckBox = new QCheckBox("Show Audio Levels");
     connect(m_showAudioLevelsCheckBox, &QCheckBox::toggled, this, &MainWindow::onShowAudioLevelsChanged);
     audioLayout->addWidget(m_showAudioLevelsCheckBox);
     m_audioVisualizer = new AudioVisualizer;
+    m_audioVisualizer->setLevelSource([this]()
+                                      { return m_audioEnabledCheckBox->isChecked() ? m_meterBank.peakAmplitude(m_desktopMeter) : 0.0f; });
+    m_audioVisualizer->setSpectrumSource(&m_audioSpectrum);
+    m_audioVisualizer->setLoudnessSource(&m_audioLoudness);
     m_audioVisualizer->setVisible(false);
     audioLayout->addWidget(m_audioVisualizer);
     layout->addWidget(audioGroup);
@@ -564,7 +655,7 @@ QWidget *MainWindow::createAudioSettingsTab()
     connect(m_micDeviceCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onMicrophoneDeviceChanged);
     micDeviceLayout->addWidget(m_micDeviceCombo);
     m_refreshMicButton = new QPushButton("Refresh");
-    connect(m_refreshMicButton, &QPushButton::clicked, this, &MainWindow::refreshMicrophoneDevices);
+    connect(m_refreshMicButton, &QPushButton::clicked, m_deviceWatcher, &AudioDeviceWatcher::rescan);
     micDeviceLayout->addWidget(m_refreshMicButton);
     micLayout->addLayout(micDeviceLayout);
     QHBoxLayout *micVolumeLayout = new QHBoxLayout;
@@ -581,14 +672,98 @@ QWidget *MainWindow::createAudioSettingsTab()
     micVolumeLayout->addWidget(m_micVolumeSlider);
     micVolumeLayout->addWidget(m_micVolumeLabel);
     micLayout->addLayout(micVolumeLayout);
+    QHBoxLayout *suppressionLayout = new QHBoxLayout;
+    suppressionLayout->addWidget(new QLabel("Noise Suppression:"));
+    m_noiseSuppressionCombo = new QComboBox;
+    m_noiseSuppressionCombo->addItem("Off", "off");
+    m_noiseSuppressionCombo->addItem("Auto", "auto");
+    m_noiseSuppressionCombo->addItem("Speex", "speex");
+    m_noiseSuppressionCombo->addItem("RNNoise", "rnnoise");
+    m_noiseSuppressionCombo->addItem("NVIDIA Noise Removal", "nvafx_denoiser");
+    m_noiseSuppressionCombo->setCurrentIndex(1);
+    m_noiseSuppressionCombo->setToolTip("Auto measures each method on your microphone at startup and picks the best one that stays within a small CPU budget.");
+    connect(m_noiseSuppressionCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::onMicrophoneSettingsChanged);
+    suppressionLayout->addWidget(m_noiseSuppressionCombo);
+    micLayout->addLayout(suppressionLayout);
+    auto makeGateSpinBox = [this](int min, int max, int value, const QString &suffix)
+    {
+        QSpinBox *spinBox = new QSpinBox;
+        spinBox->setRange(min, max);
+        spinBox->setValue(value);
+        spinBox->setSuffix(suffix);
+        spinBox->setEnabled(false);
+        connect(spinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onMicrophoneSettingsChanged);
+        return spinBox;
+    };
+    m_noiseGateCheckBox = new QCheckBox("Noise Gate");
+    m_noiseGateCheckBox->setToolTip("Mutes the microphone while its level is below the open threshold.");
+    m_noiseGateOpenSpinBox = makeGateSpinBox(-96, 0, -30, " dB");
+    m_noiseGateCloseSpinBox = makeGateSpinBox(-96, 0, -32, " dB");
+    m_noiseGateHoldSpinBox = makeGateSpinBox(0, 10000, 200, " ms");
+    m_noiseGateReleaseSpinBox = makeGateSpinBox(0, 10000, 150, " ms");
+    connect(m_noiseGateCheckBox, &QCheckBox::toggled, [this](bool enabled)
+            {
+        m_noiseGateOpenSpinBox->setEnabled(enabled);
+        m_noiseGateCloseSpinBox->setEnabled(enabled);
+        m_noiseGateHoldSpinBox->setEnabled(enabled);
+        m_noiseGateReleaseSpinBox->setEnabled(enabled);
+        onMicrophoneSettingsChanged(); });
+    micLayout->addWidget(m_noiseGateCheckBox);
+    QGridLayout *gateLayout = new QGridLayout;
+    gateLayout->addWidget(new QLabel("Open:"), 0, 0);
+    gateLayout->addWidget(m_noiseGateOpenSpinBox, 0, 1);
+    gateLayout->addWidget(new QLabel("Close:"), 0, 2);
+    gateLayout->addWidget(m_noiseGateCloseSpinBox, 0, 3);
+    gateLayout->addWidget(new QLabel("Hold:"), 1, 0);
+    gateLayout->addWidget(m_noiseGateHoldSpinBox, 1, 1);
+    gateLayout->addWidget(new QLabel("Release:"), 1, 2);
+    gateLayout->addWidget(m_noiseGateReleaseSpinBox, 1, 3);
+    micLayout->addLayout(gateLayout);
     m_showMicLevelsCheckBox = new QCheckBox("Show Microphone Levels");
     connect(m_showMicLevelsCheckBox, &QCheckBox::toggled, this, &MainWindow::onShowMicLevelsChanged);
     micLayout->addWidget(m_showMicLevelsCheckBox);
     m_microphoneVisualizer = new AudioVisualizer;
+    m_microphoneVisualizer->setLevelSource([this]()
+                                           { return m_micEnabledCheckBox->isChecked() ? m_meterBank.peakAmplitude(m_microphoneMeter) : 0.0f; });
+    m_microphoneVisualizer->setSpectrumSource(&m_microphoneSpectrum);
+    m_microphoneVisualizer->setLoudnessSource(&m_microphoneLoudness);
     m_microphoneVisualizer->setVisible(false);
     micLayout->addWidget(m_microphoneVisualizer);
     layout->addWidget(micGroup);
 
+    QGroupBox *audioReplayGroup = new QGroupBox("Audio-Only Buffer");
+    QVBoxLayout *audioReplayLayout = new QVBoxLayout(audioReplayGroup);
+    m_audioReplayCheckBox = new QCheckBox("Keep an audio-only replay buffer");
+    m_audioReplayCheckBox->setToolTip("Buffers desktop audio and microphone without video, separately from clipping mode. "
+                                      "It reuses the clip audio encoder, so it costs almost no CPU.");
+    connect(m_audioReplayCheckBox, &QCheckBox::toggled, this, &MainWindow::onAudioReplayChanged);
+    audioReplayLayout->addWidget(m_audioReplayCheckBox);
+    QHBoxLayout *audioReplayControlsLayout = new QHBoxLayout;
+    audioReplayControlsLayout->addWidget(new QLabel("Keep last:"));
+    m_audioReplayMinutesSpinBox = new QSpinBox;
+    m_audioReplayMinutesSpinBox->setRange(1, 120);
+    m_audioReplayMinutesSpinBox->setValue(60);
+    m_audioReplayMinutesSpinBox->setSuffix(" min");
+    m_audioReplayMinutesSpinBox->setEnabled(false);
+    connect(m_audioReplayMinutesSpinBox, QOverload<int>::of(&QSpinBox::valueChanged), this, &MainWindow::onAudioReplayChanged);
+    audioReplayControlsLayout->addWidget(m_audioReplayMinutesSpinBox);
+    audioReplayControlsLayout->addStretch();
+    m_saveAudioReplayButton = new QPushButton("Save Audio");
+    m_saveAudioReplayButton->setToolTip("The Save Clip hotkey also saves the audio buffer while clipping is disabled.");
+    m_saveAudioReplayButton->setEnabled(false);
+    connect(m_saveAudioReplayButton, &QPushButton::clicked, this, &MainWindow::saveAudioReplay);
+    audioReplayControlsLayout->addWidget(m_saveAudioReplayButton);
+    audioReplayLayout->addLayout(audioReplayControlsLayout);
+    layout->addWidget(audioReplayGroup);
+
+    // Every channel of every metered source, shown while any levels are
+    m_meterGroup = new QGroupBox("Channel Levels");
+    QVBoxLayout *meterLayout = new QVBoxLayout(m_meterGroup);
+    m_meterPanel = new MeterPanel(&m_meterBank);
+    meterLayout->addWidget(m_meterPanel);
+    m_meterGroup->setVisible(false);
+    layout->addWidget(m_meterGroup);
+
     layout->addStretch();
     return tab;
 }
@@ -631,6 +806,15 @@ void MainWindow::setupMenuBar()
     m_helpMenu = menuBar->addMenu("Help");
     m_showLogsAction = m_helpMenu->addAction("Show Logs");
     connect(m_showLogsAction, &QAction::triggered, this, &MainWindow::showLogs);
+
+    m_helpMenu->addSeparator();
+    m_traceEnabledAction = m_helpMenu->addAction("Record Performance Trace");
+    m_traceEnabledAction->setCheckable(true);
+    connect(m_traceEnabledAction, &QAction::toggled, this, &MainWindow::onTracingToggled);
+    m_exportTraceAction = m_helpMenu->addAction("Export Trace (last 60 s)");
+    m_exportTraceAction->setShortcut(TRACE_EXPORT_SEQUENCE);
+    m_exportTraceAction->setEnabled(false);
+    connect(m_exportTraceAction, &QAction::triggered, this, &MainWindow::exportTrace);
 }
 
 void MainWindow::setupTrayIcon()
@@ -696,312 +880,272 @@ void MainWindow::applyStyles()
     )");
 }
 
-void MainWindow::loadSettings()
-{
-    qDebug() << "--- Loading settings ---";
-    QSettings settings(QSettings::IniFormat, QSettings::UserScope, "GameClipRecorder", "Settings");
-
-    // Block signals on widgets to prevent premature saves during loading
-    m_resolutionCombo->blockSignals(true);
-    m_fpsCombo->blockSignals(true);
-    m_autoStartCheckBox->blockSignals(true);
-    m_minimizeToTrayCheckBox->blockSignals(true);
-    m_startClippingAutomaticallyCheckBox->blockSignals(true); // <-- ADDED
-    m_clipLengthCombo->blockSignals(true);
-    m_rateControlCombo->blockSignals(true);
-    m_bitrateSpinBox->blockSignals(true);
-    m_crfSpinBox->blockSignals(true);
-    m_keyframeIntervalSpinBox->blockSignals(true);
-    m_x264PresetCombo->blockSignals(true);
-    m_x264ProfileCombo->blockSignals(true);
-    m_x264TuneCombo->blockSignals(true);
-    m_x264OptionsEdit->blockSignals(true);
-    m_nvencPresetCombo->blockSignals(true);
-    m_nvencTuningCombo->blockSignals(true);
-    m_nvencMultipassCombo->blockSignals(true);
-    m_nvencProfileCombo->blockSignals(true);
-    m_nvencLookaheadCheckBox->blockSignals(true);
-    m_nvencPsychoVisualTuningCheckBox->blockSignals(true);
-    m_nvencGpuSpinBox->blockSignals(true);
-    m_nvencMaxBFramesSpinBox->blockSignals(true);
-    m_qsvPresetCombo->blockSignals(true);
-    m_qsvProfileCombo->blockSignals(true);
-    m_qsvLowPowerCheckBox->blockSignals(true);
-    m_amfUsageCombo->blockSignals(true);
-    m_amfProfileCombo->blockSignals(true);
-    m_amfBramesSpinBox->blockSignals(true);
-    m_amfOptionsEdit->blockSignals(true);
-    m_audioVolumeSlider->blockSignals(true);
-    m_audioEnabledCheckBox->blockSignals(true);
-    m_showAudioLevelsCheckBox->blockSignals(true);
-    m_micEnabledCheckBox->blockSignals(true);
-    m_micVolumeSlider->blockSignals(true);
-    m_showMicLevelsCheckBox->blockSignals(true);
-    m_soundEnabledCheckBox->blockSignals(true);
-    m_trayNotificationsCheckBox->blockSignals(true);
-
-    // Video settings must be loaded and applied before OBS initialization.
-    CaptureSettings captureSettings = m_capture->GetSettings();
-    QString resolutionStr = settings.value("videoResolution", "1920x1080").toString();
-    QStringList resParts = resolutionStr.split('x');
-
-    if (resParts.size() == 2 && resParts[0].toInt() > 0 && resParts[1].toInt() > 0)
-    {
-        captureSettings.width = resParts[0].toInt();
-        captureSettings.height = resParts[1].toInt();
-    }
-    else
-    {
-        qWarning() << "Invalid resolution string in settings:" << resolutionStr << ". Falling back to 1920x1080.";
-        resolutionStr = "1920x1080";
-        captureSettings.width = 1920;
-        captureSettings.height = 1080;
-    }
+// Only mirrors the settings in the widgets; main() has already applied them
+// to the capture.
+void MainWindow::loadSettings(const AppSettings &settings)
+{
+    // Keep the change handlers from saving or applying half-loaded state
+    std::vector<QSignalBlocker> blockers;
+    for (QWidget *widget : centralWidget()->findChildren<QWidget *>())
+        blockers.emplace_back(widget);
 
-    captureSettings.fps = settings.value("videoFps", 60).toInt();
-    m_capture->SetSettings(captureSettings);
-    m_resolutionCombo->setCurrentText(resolutionStr);
-    m_fpsCombo->setCurrentText(QString::number(captureSettings.fps));
+    m_resolutionCombo->setCurrentText(QString("%1x%2").arg(settings.capture.width).arg(settings.capture.height));
+    m_fpsCombo->setCurrentText(QString::number(settings.capture.fps));
 
-    m_outputFolder = settings.value("outputFolder", QStandardPaths::writableLocation(QStandardPaths::MoviesLocation) + "/Clips").toString();
+    m_outputFolder = settings.outputFolder;
     m_outputPathEdit->setText(m_outputFolder);
-    m_capture->SetOutputFolder(m_outputFolder);
 
     m_gameExes.clear();
     m_gameList->clear();
-    int size = settings.beginReadArray("gameExes");
-    for (int i = 0; i < size; ++i)
+    for (const QString &exe : settings.gameExes)
     {
-        settings.setArrayIndex(i);
-        QString exe = settings.value("exe").toString();
-        if (!exe.isEmpty())
-        {
-            m_gameExes.insert(exe);
-            m_gameList->addItem(exe);
-        }
+        m_gameExes.insert(exe);
+        m_gameList->addItem(exe);
     }
-    settings.endArray();
 
-    // Proactively create directories for all known games.
-    for (int i = 0; i < m_gameList->count(); ++i)
+    m_autoStartCheckBox->setChecked(settings.autoStart);
+    m_minimizeToTrayCheckBox->setChecked(settings.minimizeToTray);
+    m_startClippingAutomaticallyCheckBox->setChecked(settings.startClippingAutomatically);
+    m_unloadWindowInTrayCheckBox->setChecked(settings.unloadWindowInTray);
+    m_clipLengthCombo->setCurrentText(QString("%1s").arg(settings.clipLengthSeconds));
+    m_saveBurstWindowSpinBox->setValue(settings.saveBurstWindowSeconds);
+
+    const EncodingSettings &encoding = settings.encoding;
+    m_preferredEncoderType = settings.encoderType;
+    m_rateControlCombo->setCurrentIndex(encoding.use_cbr ? 0 : 1);
+    m_bitrateSpinBox->setValue(encoding.bitrate);
+    m_crfSpinBox->setValue(encoding.crf);
+    m_keyframeIntervalSpinBox->setValue(encoding.keyint_sec);
+
+    m_x264PresetCombo->setCurrentText(QString::fromStdString(encoding.x264Preset));
+    m_x264ProfileCombo->setCurrentText(QString::fromStdString(encoding.x264Profile));
+    m_x264TuneCombo->setCurrentText(QString::fromStdString(encoding.x264Tune));
+    m_x264OptionsEdit->setText(QString::fromStdString(encoding.x264opts));
+
+    auto selectData = [](QComboBox *combo, const std::string &value)
     {
-        QString exeName = m_gameList->item(i)->text();
-        QString gameName = QFileInfo(exeName).baseName();
-        m_capture->EnsureDirectoryForGameName(gameName);
-    }
-
-    if (m_autoStartCheckBox)
-    {
-        m_autoStartCheckBox->setChecked(settings.value("autoStart", false).toBool());
-    }
-    if (m_minimizeToTrayCheckBox)
-    {
-        m_minimizeToTrayCheckBox->setChecked(settings.value("minimizeToTray", true).toBool());
-    }
-    if (m_startClippingAutomaticallyCheckBox)
-    {
-        m_startClippingAutomaticallyCheckBox->setChecked(settings.value("startClippingAutomatically", false).toBool());
-    }
-
-    m_clipLengthCombo->setCurrentText(settings.value("clipLength", "60s").toString());
-    QString durationText = m_clipLengthCombo->currentText();
-    int duration = durationText.left(durationText.length() - 1).toInt();
-    m_capture->SetBufferDuration(duration);
-
-    m_rateControlCombo->setCurrentIndex(settings.value("use_cbr", true).toBool() ? 0 : 1);
-    m_bitrateSpinBox->setValue(settings.value("bitrate", 8000).toInt());
-    m_crfSpinBox->setValue(settings.value("crf", 22).toInt());
-    m_keyframeIntervalSpinBox->setValue(settings.value("keyint_sec", 0).toInt());
-
-    m_x264PresetCombo->setCurrentText(settings.value("x264Preset", "veryfast").toString());
-    m_x264ProfileCombo->setCurrentText(settings.value("x264Profile", "high").toString());
-    m_x264TuneCombo->setCurrentText(settings.value("x264Tune", "zerolatency").toString());
-    m_x264OptionsEdit->setText(settings.value("x264opts", "").toString());
-
-    int presetIdx = m_nvencPresetCombo->findData(settings.value("nvencPreset", "p5").toString());
-    if (presetIdx != -1)
-        m_nvencPresetCombo->setCurrentIndex(presetIdx);
-    int tuningIdx = m_nvencTuningCombo->findData(settings.value("nvencTuning", "hq").toString());
-    if (tuningIdx != -1)
-        m_nvencTuningCombo->setCurrentIndex(tuningIdx);
-    int multipassIdx = m_nvencMultipassCombo->findData(settings.value("nvencMultipass", "qres").toString());
-    if (multipassIdx != -1)
-        m_nvencMultipassCombo->setCurrentIndex(multipassIdx);
-    m_nvencProfileCombo->setCurrentText(settings.value("nvencProfile", "high").toString());
-    m_nvencLookaheadCheckBox->setChecked(settings.value("nvencLookahead", false).toBool());
-    m_nvencPsychoVisualTuningCheckBox->setChecked(settings.value("nvencPsychoVisualTuning", true).toBool());
-    m_nvencGpuSpinBox->setValue(settings.value("nvencGpu", 0).toInt());
-    m_nvencMaxBFramesSpinBox->setValue(settings.value("nvencMaxBFrames", 2).toInt());
-
-    int qsvPresetIdx = m_qsvPresetCombo->findData(settings.value("qsvPreset", "balanced").toString());
-    if (qsvPresetIdx != -1)
-        m_qsvPresetCombo->setCurrentIndex(qsvPresetIdx);
-    m_qsvProfileCombo->setCurrentText(settings.value("qsvProfile", "high").toString());
-    m_qsvLowPowerCheckBox->setChecked(settings.value("qsvLowPower", false).toBool());
-
-    int amfUsageIdx = m_amfUsageCombo->findData(settings.value("amfUsage", "quality").toString());
-    if (amfUsageIdx != -1)
-        m_amfUsageCombo->setCurrentIndex(amfUsageIdx);
-    m_amfProfileCombo->setCurrentText(settings.value("amfProfile", "high").toString());
-    m_amfBramesSpinBox->setValue(settings.value("amf_bframes", 2).toInt());
-    m_amfOptionsEdit->setText(settings.value("amf_opts", "").toString());
-
-    m_audioVolumeSlider->setValue(settings.value("audioVolume", 100).toInt());
-    m_audioEnabledCheckBox->setChecked(settings.value("audioEnabled", true).toBool());
-    m_showAudioLevelsCheckBox->setChecked(settings.value("showAudioLevels", false).toBool());
-
-    m_micEnabledCheckBox->setChecked(settings.value("micEnabled", false).toBool());
-    m_micVolumeSlider->setValue(settings.value("micVolume", 100).toInt());
-    m_showMicLevelsCheckBox->setChecked(settings.value("showMicLevels", false).toBool());
-
-    m_soundEnabledCheckBox->setChecked(settings.value("notificationSoundEnabled", true).toBool());
-    m_trayNotificationsCheckBox->setChecked(settings.value("trayNotificationsEnabled", true).toBool());
-
-    // Now that loading is complete, unblock all signals
-    m_resolutionCombo->blockSignals(false);
-    m_fpsCombo->blockSignals(false);
-    m_autoStartCheckBox->blockSignals(false);
-    m_minimizeToTrayCheckBox->blockSignals(false);
-    m_startClippingAutomaticallyCheckBox->blockSignals(false); // <-- ADDED
-    m_clipLengthCombo->blockSignals(false);
-    m_rateControlCombo->blockSignals(false);
-    m_bitrateSpinBox->blockSignals(false);
-    m_crfSpinBox->blockSignals(false);
-    m_keyframeIntervalSpinBox->blockSignals(false);
-    m_x264PresetCombo->blockSignals(false);
-    m_x264ProfileCombo->blockSignals(false);
-    m_x264TuneCombo->blockSignals(false);
-    m_x264OptionsEdit->blockSignals(false);
-    m_nvencPresetCombo->blockSignals(false);
-    m_nvencTuningCombo->blockSignals(false);
-    m_nvencMultipassCombo->blockSignals(false);
-    m_nvencProfileCombo->blockSignals(false);
-    m_nvencLookaheadCheckBox->blockSignals(false);
-    m_nvencPsychoVisualTuningCheckBox->blockSignals(false);
-    m_nvencGpuSpinBox->blockSignals(false);
-    m_nvencMaxBFramesSpinBox->blockSignals(false);
-    m_qsvPresetCombo->blockSignals(false);
-    m_qsvProfileCombo->blockSignals(false);
-    m_qsvLowPowerCheckBox->blockSignals(false);
-    m_amfUsageCombo->blockSignals(false);
-    m_amfProfileCombo->blockSignals(false);
-    m_amfBramesSpinBox->blockSignals(false);
-    m_amfOptionsEdit->blockSignals(false);
-    m_audioVolumeSlider->blockSignals(false);
-    m_audioEnabledCheckBox->blockSignals(false);
-    m_showAudioLevelsCheckBox->blockSignals(false);
-    m_micEnabledCheckBox->blockSignals(false);
-    m_micVolumeSlider->blockSignals(false);
-    m_showMicLevelsCheckBox->blockSignals(false);
-    m_soundEnabledCheckBox->blockSignals(false);
-    m_trayNotificationsCheckBox->blockSignals(false);
+        const int index = combo->findData(QString::fromStdString(value));
+        if (index != -1)
+            combo->setCurrentIndex(index);
+    };
+    selectData(m_nvencPresetCombo, encoding.nvencPreset);
+    selectData(m_nvencTuningCombo, encoding.nvencTuning);
+    selectData(m_nvencMultipassCombo, encoding.nvencMultipass);
+    m_nvencProfileCombo->setCurrentText(QString::fromStdString(encoding.nvencProfile));
+    m_nvencLookaheadCheckBox->setChecked(encoding.nvencLookahead);
+    m_nvencPsychoVisualTuningCheckBox->setChecked(encoding.nvencPsychoVisualTuning);
+    m_nvencGpuSpinBox->setValue(encoding.nvencGpu);
+    m_nvencMaxBFramesSpinBox->setValue(encoding.nvencMaxBFrames);
+
+    selectData(m_qsvPresetCombo, encoding.qsvPreset);
+    m_qsvProfileCombo->setCurrentText(QString::fromStdString(encoding.qsvProfile));
+    m_qsvLowPowerCheckBox->setChecked(encoding.qsvLowPower);
+
+    selectData(m_amfUsageCombo, encoding.amfUsage);
+    m_amfProfileCombo->setCurrentText(QString::fromStdString(encoding.amfProfile));
+    m_amfBramesSpinBox->setValue(encoding.amf_bframes);
+    m_amfOptionsEdit->setText(QString::fromStdString(encoding.amf_opts));
+
+    m_audioVolumeSlider->setValue(qRound(settings.audio.volume * 100.0f));
+    m_preferredAudioDeviceId = QString::fromStdString(settings.audio.deviceId);
+    m_audioEnabledCheckBox->setChecked(settings.audio.enabled);
+    m_showAudioLevelsCheckBox->setChecked(settings.showAudioLevels);
+    m_normalizeLoudnessCheckBox->setChecked(settings.normalizeLoudness);
+    m_targetLoudnessSpinBox->setValue(settings.targetLoudness);
+    m_audioReplayCheckBox->setChecked(settings.audioReplay);
+    m_audioReplayMinutesSpinBox->setValue(settings.audioReplayMinutes);
+
+    const MicrophoneSettings &microphone = settings.microphone;
+    m_micEnabledCheckBox->setChecked(microphone.enabled);
+    m_micVolumeSlider->setValue(qRound(microphone.volume * 100.0f));
+    m_preferredMicDeviceId = QString::fromStdString(microphone.deviceId);
+    m_showMicLevelsCheckBox->setChecked(settings.showMicLevels);
+    selectData(m_noiseSuppressionCombo, microphone.noiseSuppression ? microphone.noiseSuppressionMethod : std::string("off"));
+    m_noiseGateCheckBox->setChecked(microphone.noiseGate);
+    m_noiseGateOpenSpinBox->setValue(qRound(microphone.noiseGateThreshold));
+    m_noiseGateCloseSpinBox->setValue(qRound(microphone.noiseGateCloseThreshold));
+    m_noiseGateHoldSpinBox->setValue(qRound(microphone.noiseGateHoldTime));
+    m_noiseGateReleaseSpinBox->setValue(qRound(microphone.noiseGateReleaseTime));
+
+    m_soundEnabledCheckBox->setChecked(settings.notificationSound);
+    m_trayNotificationsCheckBox->setChecked(settings.trayNotifications);
+
+    blockers.clear();
 
     // After unblocking, manually call functions that need to update the UI state
     onRateControlChanged();
     onShowAudioLevelsChanged(m_showAudioLevelsCheckBox->isChecked());
     onShowMicLevelsChanged(m_showMicLevelsCheckBox->isChecked());
-    m_keybindSettings.clipSave = QKeySequence(settings.value("keybind_clip", "F9").toString());
-    m_keybindSettings.clippingModeToggle = QKeySequence(settings.value("keybind_clipping", "F10").toString());
+    onLoudnessNormalizationChanged();
+    onAudioReplayChanged();
+    for (QSpinBox *spinBox : {m_noiseGateOpenSpinBox, m_noiseGateCloseSpinBox, m_noiseGateHoldSpinBox, m_noiseGateReleaseSpinBox})
+        spinBox->setEnabled(m_noiseGateCheckBox->isChecked());
+    m_keybindSettings.clipSave = QKeySequence(settings.clipKeybind);
+    m_keybindSettings.clippingModeToggle = QKeySequence(settings.clippingKeybind);
     onKeybindsChanged(m_keybindSettings);
 
     // Re-connect signals that were disconnected in the constructor or setupUI
     connect(m_autoStartCheckBox, &QCheckBox::toggled, this, &MainWindow::onAutoStartChanged);
     connect(m_startClippingAutomaticallyCheckBox, &QCheckBox::toggled, this, &MainWindow::onStartClippingAutomaticallyChanged); // <-- ADDED
     connect(m_minimizeToTrayCheckBox, &QCheckBox::toggled, this, &MainWindow::saveSettings);
+    connect(m_unloadWindowInTrayCheckBox, &QCheckBox::toggled, this, &MainWindow::saveSettings);
 }
 
+// Called from most change handlers, often many times a second while a slider
+// is dragged. It only updates the in-memory store; unchanged values are
+// dropped there and the disk write happens later, on the store's thread.
+// While the window is unloaded m_settings is all there is.
 void MainWindow::saveSettings()
 {
-    qDebug() << "--- Saving settings ---";
-    QSettings settings(QSettings::IniFormat, QSettings::UserScope, "GameClipRecorder", "Settings"); // Use consistent organization name
-
-    settings.setValue("outputFolder", m_outputFolder);
+    if (m_uiLoaded)
+        m_settings = settingsFromUi();
+    m_settings.clipKeybind = m_keybindSettings.clipSave.toString();
+    m_settings.clippingKeybind = m_keybindSettings.clippingModeToggle.toString();
+    m_settings.save();
+}
 
+AppSettings MainWindow::settingsFromUi() const
+{
+    AppSettings settings;
+    settings.outputFolder = m_outputFolder;
     // Save games from the actual list widget, not from m_gameExes
-    settings.beginWriteArray("gameExes");
-    qDebug() << "Saving" << m_gameList->count() << "games.";
     for (int i = 0; i < m_gameList->count(); ++i)
     {
-        settings.setArrayIndex(i);
-        settings.setValue("exe", m_gameList->item(i)->text());
+        settings.gameExes.append(m_gameList->item(i)->text());
     }
-    settings.endArray();
-
-    if (m_autoStartCheckBox)
-        settings.setValue("autoStart", m_autoStartCheckBox->isChecked());
-    if (m_minimizeToTrayCheckBox)
-        settings.setValue("minimizeToTray", m_minimizeToTrayCheckBox->isChecked());
-    if (m_startClippingAutomaticallyCheckBox)
-        settings.setValue("startClippingAutomatically", m_startClippingAutomaticallyCheckBox->isChecked()); // <-- ADDED
-
-    settings.setValue("videoResolution", m_resolutionCombo->currentText());
-    settings.setValue("videoFps", m_fpsCombo->currentText().toInt());
+    settings.clipLengthSeconds = clipLengthFromUi();
+    settings.saveBurstWindowSeconds = m_saveBurstWindowSpinBox->value();
+    settings.autoStart = m_autoStartCheckBox->isChecked();
+    settings.minimizeToTray = m_minimizeToTrayCheckBox->isChecked();
+    settings.startClippingAutomatically = m_startClippingAutomaticallyCheckBox->isChecked();
+    settings.unloadWindowInTray = m_unloadWindowInTrayCheckBox->isChecked();
+
+    const QStringList resolution = m_resolutionCombo->currentText().split('x');
+    settings.capture.width = resolution.value(0).toInt();
+    settings.capture.height = resolution.value(1).toInt();
+    settings.capture.fps = m_fpsCombo->currentText().toInt();
+
+    // Until OBS is up the combo is empty; keep what was picked before
+    settings.encoderType = m_encoderCombo->currentIndex() >= 0
+                               ? m_encoderCombo->currentData().toMap()["type"].toInt()
+                               : m_preferredEncoderType;
+    settings.encoding = encodingSettingsFromUi();
+
+    settings.audio = audioSettingsFromUi();
+    settings.audio.deviceId = m_preferredAudioDeviceId.toStdString();
+    settings.showAudioLevels = m_showAudioLevelsCheckBox->isChecked();
+    settings.normalizeLoudness = m_normalizeLoudnessCheckBox->isChecked();
+    settings.targetLoudness = m_targetLoudnessSpinBox->value();
+    settings.audioReplay = m_audioReplayCheckBox->isChecked();
+    settings.audioReplayMinutes = m_audioReplayMinutesSpinBox->value();
+
+    settings.microphone = microphoneSettingsFromUi();
+    settings.microphone.deviceId = m_preferredMicDeviceId.toStdString();
+    settings.showMicLevels = m_showMicLevelsCheckBox->isChecked();
+
+    settings.notificationSound = m_soundEnabledCheckBox->isChecked();
+    settings.trayNotifications = m_trayNotificationsCheckBox->isChecked();
+    return settings;
+}
 
-    settings.setValue("clipLength", m_clipLengthCombo->currentText());
-    qDebug() << "Saving clipLength:" << m_clipLengthCombo->currentText();
+int MainWindow::clipLengthFromUi() const
+{
+    // "60s"
+    return m_clipLengthCombo->currentText().chopped(1).toInt();
+}
 
+EncodingSettings MainWindow::encodingSettingsFromUi() const
+{
+    EncodingSettings settings;
     if (m_encoderCombo->currentIndex() >= 0)
-    {
-        settings.setValue("encoderType", m_encoderCombo->currentData().toMap()["type"].toInt());
-    }
-    settings.setValue("use_cbr", m_rateControlCombo->currentIndex() == 0);
-    settings.setValue("bitrate", m_bitrateSpinBox->value());
-    settings.setValue("crf", m_crfSpinBox->value());
-    settings.setValue("keyint_sec", m_keyframeIntervalSpinBox->value());
+        settings.encoder = static_cast<EncoderType>(m_encoderCombo->currentData().toMap()["type"].toInt());
+    settings.use_cbr = (m_rateControlCombo->currentIndex() == 0);
+    settings.bitrate = m_bitrateSpinBox->value();
+    settings.crf = m_crfSpinBox->value();
+    settings.keyint_sec = m_keyframeIntervalSpinBox->value();
 
     // x264
-    settings.setValue("x264Preset", m_x264PresetCombo->currentText());
-    settings.setValue("x264Profile", m_x264ProfileCombo->currentText());
-    settings.setValue("x264Tune", m_x264TuneCombo->currentText());
-    settings.setValue("x264opts", m_x264OptionsEdit->text());
+    settings.x264Preset = m_x264PresetCombo->currentText().toStdString();
+    settings.x264Profile = m_x264ProfileCombo->currentText().toStdString();
+    settings.x264Tune = m_x264TuneCombo->currentText().toStdString();
+    settings.x264opts = m_x264OptionsEdit->text().toStdString();
 
     // NVENC
     if (m_nvencPresetCombo->currentIndex() >= 0)
-        settings.setValue("nvencPreset", m_nvencPresetCombo->currentData().toString());
+        settings.nvencPreset = m_nvencPresetCombo->currentData().toString().toStdString();
     if (m_nvencTuningCombo->currentIndex() >= 0)
-        settings.setValue("nvencTuning", m_nvencTuningCombo->currentData().toString());
+        settings.nvencTuning = m_nvencTuningCombo->currentData().toString().toStdString();
     if (m_nvencMultipassCombo->currentIndex() >= 0)
-        settings.setValue("nvencMultipass", m_nvencMultipassCombo->currentData().toString());
-    settings.setValue("nvencProfile", m_nvencProfileCombo->currentText());
-    settings.setValue("nvencLookahead", m_nvencLookaheadCheckBox->isChecked());
-    settings.setValue("nvencPsychoVisualTuning", m_nvencPsychoVisualTuningCheckBox->isChecked());
-    settings.setValue("nvencGpu", m_nvencGpuSpinBox->value());
-    settings.setValue("nvencMaxBFrames", m_nvencMaxBFramesSpinBox->value());
+        settings.nvencMultipass = m_nvencMultipassCombo->currentData().toString().toStdString();
+    settings.nvencProfile = m_nvencProfileCombo->currentText().toStdString();
+    settings.nvencLookahead = m_nvencLookaheadCheckBox->isChecked();
+    settings.nvencPsychoVisualTuning = m_nvencPsychoVisualTuningCheckBox->isChecked();
+    settings.nvencGpu = m_nvencGpuSpinBox->value();
+    settings.nvencMaxBFrames = m_nvencMaxBFramesSpinBox->value();
 
     // QSV
     if (m_qsvPresetCombo->currentIndex() >= 0)
-        settings.setValue("qsvPreset", m_qsvPresetCombo->currentData().toString());
-    settings.setValue("qsvProfile", m_qsvProfileCombo->currentText());
-    settings.setValue("qsvLowPower", m_qsvLowPowerCheckBox->isChecked());
+        settings.qsvPreset = m_qsvPresetCombo->currentData().toString().toStdString();
+    settings.qsvProfile = m_qsvProfileCombo->currentText().toStdString();
+    settings.qsvLowPower = m_qsvLowPowerCheckBox->isChecked();
 
     // AMF
     if (m_amfUsageCombo->currentIndex() >= 0)
-        settings.setValue("amfUsage", m_amfUsageCombo->currentData().toString());
-    settings.setValue("amfProfile", m_amfProfileCombo->currentText());
-    settings.setValue("amf_bframes", m_amfBramesSpinBox->value());
-    settings.setValue("amf_opts", m_amfOptionsEdit->text());
-
-    settings.setValue("audioVolume", m_audioVolumeSlider->value());
-    settings.setValue("audioEnabled", m_audioEnabledCheckBox->isChecked());
-    settings.setValue("showAudioLevels", m_showAudioLevelsCheckBox->isChecked());
-    if (m_audioDeviceCombo)
-        settings.setValue("audioDeviceID", m_audioDeviceCombo->currentData().toString());
-    settings.setValue("micEnabled", m_micEnabledCheckBox->isChecked());
-    settings.setValue("micVolume", m_micVolumeSlider->value());
-    settings.setValue("showMicLevels", m_showMicLevelsCheckBox->isChecked());
-    if (m_micDeviceCombo)
-        settings.setValue("micDeviceID", m_micDeviceCombo->currentData().toString());
-    settings.setValue("notificationSoundEnabled", m_soundEnabledCheckBox->isChecked());
-    settings.setValue("trayNotificationsEnabled", m_trayNotificationsCheckBox->isChecked());
-
-    // Save keybinds here too for consistency
-    settings.setValue("keybind_clip", m_keybindSettings.clipSave.toString());
-    settings.setValue("keybind_clipping", m_keybindSettings.clippingModeToggle.toString());
-
-    // Force sync to disk
-    settings.sync();
-
-    qDebug() << "Settings synced to disk. Status:" << settings.status();
+        settings.amfUsage = m_amfUsageCombo->currentData().toString().toStdString();
+    settings.amfProfile = m_amfProfileCombo->currentText().toStdString();
+    settings.amf_bframes = m_amfBramesSpinBox->value();
+    settings.amf_opts = m_amfOptionsEdit->text().toStdString();
+    return settings;
+}
+
+AudioSettings MainWindow::audioSettingsFromUi() const
+{
+    AudioSettings settings;
+    settings.enabled = m_audioEnabledCheckBox->isChecked();
+    settings.volume = m_audioVolumeSlider->value() / 100.0f;
+    settings.deviceId = m_audioDeviceCombo->currentIndex() >= 0
+                            ? m_audioDeviceCombo->currentData().toString().toStdString()
+                            : "default";
+    return settings;
+}
+
+MicrophoneSettings MainWindow::microphoneSettingsFromUi() const
+{
+    MicrophoneSettings settings;
+    settings.enabled = m_micEnabledCheckBox->isChecked();
+    settings.volume = m_micVolumeSlider->value() / 100.0f;
+    const QString suppression = m_noiseSuppressionCombo->currentData().toString();
+    settings.noiseSuppression = suppression != "off";
+    if (settings.noiseSuppression)
+        settings.noiseSuppressionMethod = suppression.toStdString();
+    settings.noiseGate = m_noiseGateCheckBox->isChecked();
+    settings.noiseGateThreshold = static_cast<float>(m_noiseGateOpenSpinBox->value());
+    settings.noiseGateCloseThreshold = static_cast<float>(m_noiseGateCloseSpinBox->value());
+    settings.noiseGateHoldTime = static_cast<float>(m_noiseGateHoldSpinBox->value());
+    settings.noiseGateReleaseTime = static_cast<float>(m_noiseGateReleaseSpinBox->value());
+    settings.deviceId = m_micDeviceCombo->currentIndex() >= 0
+                            ? m_micDeviceCombo->currentData().toString().toStdString()
+                            : "default";
+    return settings;
+}
+
+// The widgets while they exist, the model otherwise
+AudioSettings MainWindow::currentAudioSettings() const
+{
+    if (m_uiLoaded)
+        return audioSettingsFromUi();
+    AudioSettings settings = m_settings.audio;
+    settings.deviceId = availableDeviceId(m_audioDevices, m_preferredAudioDeviceId).toStdString();
+    return settings;
+}
+
+MicrophoneSettings MainWindow::currentMicrophoneSettings() const
+{
+    if (m_uiLoaded)
+        return microphoneSettingsFromUi();
+    MicrophoneSettings settings = m_settings.microphone;
+    settings.deviceId = availableDeviceId(m_microphoneDevices, m_preferredMicDeviceId).toStdString();
+    return settings;
 }
 
 void MainWindow::startProcessMonitor()
@@ -1030,7 +1174,7 @@ void MainWindow::stopProcessMonitor()
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
-    if (m_minimizeToTrayCheckBox->isChecked() && m_trayIcon && m_trayIcon->isVisible())
+    if (m_settings.minimizeToTray && m_trayIcon && m_trayIcon->isVisible())
     {
         hide();
         event->ignore();
@@ -1045,6 +1189,60 @@ void MainWindow::closeEvent(QCloseEvent *event)
 void MainWindow::changeEvent(QEvent *event)
 {
     QMainWindow::changeEvent(event);
+    if (event->type() == QEvent::WindowStateChange)
+        updateIdleState();
+}
+
+void MainWindow::showEvent(QShowEvent *event)
+{
+    QMainWindow::showEvent(event);
+    updateIdleState();
+}
+
+void MainWindow::hideEvent(QHideEvent *event)
+{
+    QMainWindow::hideEvent(event);
+    updateIdleState();
+    // Not from inside the event: the widgets are still being hidden
+    if (m_settings.unloadWindowInTray && isHidden())
+        QMetaObject::invokeMethod(this, &MainWindow::unloadUi, Qt::QueuedConnection);
+}
+
+// With nothing on screen, the UI stops waking the process: the frame clock
+// stops and the level callbacks on the OBS audio thread are removed. Hotkeys,
+// the process monitor and saves keep working.
+void MainWindow::updateIdleState()
+{
+    const bool idle = isHidden() || isMinimized();
+    if (idle == m_idle)
+        return;
+    m_idle = idle;
+
+    FrameClock::instance().setSuspended(idle);
+    if (idle)
+    {
+        detachLevelSources();
+    }
+    else
+    {
+        setupAudioVolmeter();
+        setupMicrophoneVolmeter();
+    }
+    LOG_INFO("UI %1", idle ? QString("idle: frame clock stopped, level meters detached") : QString("active"));
+    emit idleChanged(idle);
+}
+
+void MainWindow::detachLevelSources()
+{
+    // The volmeters are created on first attach, which needs libobs up
+    if (!m_capture->IsInitialized())
+        return;
+    m_meterBank.detach(m_desktopMeter);
+    m_meterBank.detach(m_microphoneMeter);
+    m_audioSpectrum.detach();
+    m_microphoneSpectrum.detach();
+    m_audioLoudness.detach();
+    m_microphoneLoudness.detach();
 }
 
 void MainWindow::setSettingsLocked(bool locked)
@@ -1054,6 +1252,7 @@ void MainWindow::setSettingsLocked(bool locked)
 
     // Main Controls
     m_clipLengthCombo->setDisabled(locked);
+    m_saveBurstWindowSpinBox->setDisabled(locked);
 
     // General Settings Tab
     m_outputPathEdit->setDisabled(locked);
@@ -1074,17 +1273,17 @@ void MainWindow::setSettingsLocked(bool locked)
     m_advancedQsvGroup->setDisabled(locked);
     m_advancedAmfGroup->setDisabled(locked);
 
-    // Audio Settings Tab
+    // Audio Settings Tab. Devices switch live, so they stay unlocked.
     m_audioEnabledCheckBox->setDisabled(locked);
-    m_audioDeviceCombo->setDisabled(locked);
-    m_refreshAudioButton->setDisabled(locked);
     m_micEnabledCheckBox->setDisabled(locked);
-    m_micDeviceCombo->setDisabled(locked);
-    m_refreshMicButton->setDisabled(locked);
 }
 
 void MainWindow::updateUiForState()
 {
+    // Shown from m_clippingState once the window is built again
+    if (!m_uiLoaded)
+        return;
+
     switch (m_clippingState)
     {
     case DISABLED:
@@ -1135,10 +1334,12 @@ void MainWindow::toggleClippingMode()
     {
         m_clippingState = DISABLED;
         stopProcessMonitor();
-        m_capture->StopClippingMode(); // Stops buffer if active
         m_gameDetected = false;
         m_currentDetectedGame.clear();
-        m_capture->ClearCapture();
+        m_obs->post([](GameCapture &capture)
+                    {
+            capture.StopClippingMode(); // Stops buffer if active
+            capture.ClearCapture(); });
     }
     updateUiForState();
 }
@@ -1155,42 +1356,60 @@ void MainWindow::onClippingModeChanged(bool active)
 
 void MainWindow::onProcessStarted(const QString &exeName)
 {
+    TRACE_SCOPE("MainWindow::onProcessStarted");
     // Only act if we are waiting for a game and haven't found one yet.
-    if (m_clippingState == AWAITING_GAME && m_gameExes.contains(exeName))
+    if (m_clippingState == AWAITING_GAME && !m_gameDetected && m_gameExes.contains(exeName))
     {
         m_gameDetected = true;
         m_currentDetectedGame = exeName;
 
-        m_statusLabel->setText(QString("Starting buffer for %1...").arg(exeName));
-        m_capture->SetGameCapture(exeName.toStdString());
-
-        if (m_capture->StartClippingMode())
-        {
-            m_clippingState = ACTIVE;
-        }
-        else
-        {
-            QMessageBox::critical(this, "Error", "Failed to start clipping buffer!");
-            // Revert state if starting the buffer failed
-            m_gameDetected = false;
-            m_currentDetectedGame.clear();
-            m_capture->ClearCapture();
-        }
-        updateUiForState(); // Update UI to ACTIVE or back to AWAITING_GAME on failure
+        if (m_uiLoaded)
+            m_statusLabel->setText(QString("Starting buffer for %1...").arg(exeName));
+        const std::string exe = exeName.toStdString();
+        m_obs->submit([exe](GameCapture &capture)
+                      {
+            capture.SetGameCapture(exe);
+            if (capture.StartClippingMode())
+                return true;
+            capture.ClearCapture();
+            return false; })
+            .then(this, [this, exeName](bool started)
+                  {
+            // Clipping was turned off or the game exited meanwhile; the
+            // commands queued for that have already undone this start.
+            if (m_clippingState != AWAITING_GAME || m_currentDetectedGame != exeName)
+                return;
+
+            if (started)
+            {
+                m_clippingState = ACTIVE;
+            }
+            else
+            {
+                QMessageBox::critical(this, "Error", "Failed to start clipping buffer!");
+                // Revert state if starting the buffer failed
+                m_gameDetected = false;
+                m_currentDetectedGame.clear();
+            }
+            updateUiForState(); // Update UI to ACTIVE or back to AWAITING_GAME on failure
+        });
     }
 }
 
 void MainWindow::onProcessStopped(const QString &exeName)
 {
-    // Only act if clipping is active and the correct game has closed.
-    if (m_clippingState == ACTIVE && exeName.compare(m_currentDetectedGame, Qt::CaseInsensitive) == 0)
+    TRACE_SCOPE("MainWindow::onProcessStopped");
+    // Only act if clipping is active (or starting) and the correct game has closed.
+    if ((m_clippingState == ACTIVE || m_gameDetected) && exeName.compare(m_currentDetectedGame, Qt::CaseInsensitive) == 0)
     {
         m_clippingState = AWAITING_GAME;
         m_gameDetected = false;
         m_currentDetectedGame.clear();
 
-        m_capture->StopClippingMode();
-        m_capture->ClearCapture();
+        m_obs->post([](GameCapture &capture)
+                    {
+            capture.StopClippingMode();
+            capture.ClearCapture(); });
 
         updateUiForState(); // Update UI to reflect we are waiting again.
     }
@@ -1198,11 +1417,38 @@ void MainWindow::onProcessStopped(const QString &exeName)
 
 void MainWindow::saveClip()
 {
-    // Disable the button immediately to prevent spamming
-    m_clipButton->setEnabled(false);
+    // Without a video buffer the hotkey saves the audio-only one
+    if (m_clippingState != ACTIVE && m_capture->IsAudioReplayActive())
+    {
+        saveAudioReplay();
+        return;
+    }
+
+    // Disable the button immediately to prevent spamming. With a burst
+    // window it stays up: further presses extend the pending clip.
+    if (m_uiLoaded && m_settings.saveBurstWindowSeconds == 0)
+        m_clipButton->setEnabled(false);
+
+    const int duration = m_settings.clipLengthSeconds;
+    m_obs->submit([duration](GameCapture &capture)
+                  { return capture.SaveInstantReplay(duration, ""); })
+        .then(this, [this](bool saving)
+              {
+        // When saving, recordingFinished re-enables it
+        if (!saving && m_uiLoaded)
+            m_clipButton->setEnabled(m_clippingState == ACTIVE); });
+}
 
-    int duration = m_clipLengthCombo->currentText().remove('s').toInt();
-    m_capture->SaveInstantReplay(duration, "");
+void MainWindow::saveAudioReplay()
+{
+    if (m_uiLoaded)
+        m_saveAudioReplayButton->setEnabled(false);
+    m_obs->submit([](GameCapture &capture)
+                  { return capture.SaveAudioReplay(); })
+        .then(this, [this](bool saving)
+              {
+        if (!saving && m_uiLoaded)
+            m_saveAudioReplayButton->setEnabled(m_capture->IsAudioReplayActive()); });
 }
 
 void MainWindow::addGameExe()
@@ -1219,7 +1465,8 @@ void MainWindow::addGameExe()
 
             // Proactively create directory for the new game
             QString gameName = QFileInfo(exeName).baseName();
-            m_capture->EnsureDirectoryForGameName(gameName);
+            m_obs->post([gameName](GameCapture &capture)
+                        { capture.EnsureDirectoryForGameName(gameName); });
 
             saveSettings();
         }
@@ -1246,7 +1493,8 @@ void MainWindow::browseOutputFolder()
     {
         m_outputFolder = folder;
         m_outputPathEdit->setText(folder);
-        m_capture->SetOutputFolder(folder);
+        m_obs->post([folder](GameCapture &capture)
+                    { capture.SetOutputFolder(folder); });
         saveSettings();
     }
 }
@@ -1269,11 +1517,65 @@ void MainWindow::showKeybindSettings()
 
 void MainWindow::showFromTray()
 {
+    loadUi();
     show();
     raise();
     activateWindow();
 }
 
+// Tray-only mode: the widget tree goes while the window is hidden, leaving
+// the tray, the hotkeys, the process monitor and the capture. Everything it
+// showed is in m_settings, and loadUi() builds it again from there.
+void MainWindow::unloadUi()
+{
+    if (!m_uiLoaded || !isHidden())
+        return;
+
+    const QString before = memoryUsage();
+    saveSettings();
+    m_uiLoaded = false;
+    delete takeCentralWidget();
+    m_audioVisualizer = nullptr;
+    m_microphoneVisualizer = nullptr;
+    m_meterGroup = nullptr;
+    m_meterPanel = nullptr;
+    // Built again on demand
+    if (m_keybindDialog && !m_keybindDialog->isVisible())
+    {
+        delete m_keybindDialog;
+        m_keybindDialog = nullptr;
+    }
+    if (m_logDialog && !m_logDialog->isVisible())
+    {
+        delete m_logDialog;
+        m_logDialog = nullptr;
+    }
+    LOG_INFO("Window unloaded: %1 before, %2 after", before, memoryUsage());
+}
+
+void MainWindow::loadUi()
+{
+    if (m_uiLoaded)
+        return;
+
+    const QString before = memoryUsage();
+    setupUI();
+    m_uiLoaded = true;
+    // The handlers called while loading overwrite m_settings from the widgets
+    const AppSettings settings = m_settings;
+    loadSettings(settings);
+    onAudioDevicesReceived(m_audioDevices);
+    onMicrophoneDevicesReceived(m_microphoneDevices);
+    if (m_capture->IsInitialized())
+    {
+        refreshEncoders();
+        onEncodingSettingsChanged();
+    }
+    m_saveAudioReplayButton->setEnabled(m_capture->IsAudioReplayActive());
+    updateUiForState();
+    LOG_INFO("Window loaded: %1 before, %2 after", before, memoryUsage());
+}
+
 void MainWindow::exitApplication()
 {
     if (m_trayIcon)
@@ -1283,10 +1585,18 @@ void MainWindow::exitApplication()
 
 void MainWindow::onClipLengthChanged()
 {
-    qDebug() << "onClipLengthChanged triggered.";
-    QString durationText = m_clipLengthCombo->currentText();
-    int duration = durationText.left(durationText.length() - 1).toInt();
-    m_capture->SetBufferDuration(duration);
+    const int duration = clipLengthFromUi();
+    m_obs->post([duration](GameCapture &capture)
+                { capture.SetBufferDuration(duration); });
+    saveSettings();
+}
+
+void MainWindow::onSaveBurstWindowChanged()
+{
+    // Like the clip length, applied when the buffer next starts
+    const int seconds = m_saveBurstWindowSpinBox->value();
+    m_obs->post([seconds](GameCapture &capture)
+                { capture.SetSaveBurstWindow(seconds); });
     saveSettings();
 }
 
@@ -1332,46 +1642,8 @@ void MainWindow::onEncodingSettingsChanged()
         m_crfSpinBox->setToolTip("Lower is better quality. 20-25 is a sane range.");
     }
 
-    EncodingSettings settings;
-    settings.encoder = static_cast<EncoderType>(data["type"].toInt());
-    settings.use_cbr = (m_rateControlCombo->currentIndex() == 0);
-    settings.bitrate = m_bitrateSpinBox->value();
-    settings.crf = m_crfSpinBox->value();
-    settings.keyint_sec = m_keyframeIntervalSpinBox->value();
-
-    // x264
-    settings.x264Preset = m_x264PresetCombo->currentText().toStdString();
-    settings.x264Profile = m_x264ProfileCombo->currentText().toStdString();
-    settings.x264Tune = m_x264TuneCombo->currentText().toStdString();
-    settings.x264opts = m_x264OptionsEdit->text().toStdString();
-
-    // NVENC
-    if (m_nvencPresetCombo->currentIndex() >= 0)
-        settings.nvencPreset = m_nvencPresetCombo->currentData().toString().toStdString();
-    if (m_nvencTuningCombo->currentIndex() >= 0)
-        settings.nvencTuning = m_nvencTuningCombo->currentData().toString().toStdString();
-    if (m_nvencMultipassCombo->currentIndex() >= 0)
-        settings.nvencMultipass = m_nvencMultipassCombo->currentData().toString().toStdString();
-    settings.nvencProfile = m_nvencProfileCombo->currentText().toStdString();
-    settings.nvencLookahead = m_nvencLookaheadCheckBox->isChecked();
-    settings.nvencPsychoVisualTuning = m_nvencPsychoVisualTuningCheckBox->isChecked();
-    settings.nvencGpu = m_nvencGpuSpinBox->value();
-    settings.nvencMaxBFrames = m_nvencMaxBFramesSpinBox->value();
-
-    // QSV
-    if (m_qsvPresetCombo->currentIndex() >= 0)
-        settings.qsvPreset = m_qsvPresetCombo->currentData().toString().toStdString();
-    settings.qsvProfile = m_qsvProfileCombo->currentText().toStdString();
-    settings.qsvLowPower = m_qsvLowPowerCheckBox->isChecked();
-
-    // AMF
-    if (m_amfUsageCombo->currentIndex() >= 0)
-        settings.amfUsage = m_amfUsageCombo->currentData().toString().toStdString();
-    settings.amfProfile = m_amfProfileCombo->currentText().toStdString();
-    settings.amf_bframes = m_amfBramesSpinBox->value();
-    settings.amf_opts = m_amfOptionsEdit->text().toStdString();
-
-    m_capture->UpdateEncodingSettings(settings);
+    m_obs->post([settings = encodingSettingsFromUi()](GameCapture &capture)
+                { capture.UpdateEncodingSettings(settings); });
     saveSettings();
 }
 
@@ -1389,13 +1661,10 @@ void MainWindow::onAudioSettingsChanged()
 {
     if (!m_capture || !m_capture->IsInitialized())
         return;
-    AudioSettings settings;
-    settings.enabled = m_audioEnabledCheckBox->isChecked();
-    settings.volume = m_audioVolumeSlider->value() / 100.0f;
-    settings.deviceId = m_audioDeviceCombo->currentIndex() >= 0
-                            ? m_audioDeviceCombo->currentData().toString().toStdString()
-                            : "default";
-    m_capture->UpdateAudioSettings(settings);
+    const AudioSettings settings = currentAudioSettings();
+    m_activeAudioDeviceId = QString::fromStdString(settings.deviceId);
+    m_obs->post([settings](GameCapture &capture)
+                { capture.UpdateAudioSettings(settings); });
 
     static QString lastDeviceId;
     if (QString::fromStdString(settings.deviceId) != lastDeviceId)
@@ -1410,13 +1679,10 @@ void MainWindow::onMicrophoneSettingsChanged()
 {
     if (!m_capture || !m_capture->IsInitialized())
         return;
-    MicrophoneSettings settings;
-    settings.enabled = m_micEnabledCheckBox->isChecked();
-    settings.volume = m_micVolumeSlider->value() / 100.0f;
-    settings.deviceId = m_micDeviceCombo->currentIndex() >= 0
-                            ? m_micDeviceCombo->currentData().toString().toStdString()
-                            : "default";
-    m_capture->UpdateMicrophoneSettings(settings);
+    const MicrophoneSettings settings = currentMicrophoneSettings();
+    m_activeMicDeviceId = QString::fromStdString(settings.deviceId);
+    m_obs->post([settings](GameCapture &capture)
+                { capture.UpdateMicrophoneSettings(settings); });
 
     static QString lastMicDeviceId;
     if (QString::fromStdString(settings.deviceId) != lastMicDeviceId)
@@ -1445,6 +1711,8 @@ void MainWindow::onKeybindsChanged(const KeybindSettings &settings)
         m_globalHotkey->unregisterAllHotkeys();
         m_globalHotkey->registerHotkey(HOTKEY_SAVE_CLIP, settings.clipSave);
         m_globalHotkey->registerHotkey(HOTKEY_TOGGLE_CLIPPING, settings.clippingModeToggle);
+        if (Trace::isEnabled())
+            m_globalHotkey->registerHotkey(HOTKEY_EXPORT_TRACE, TRACE_EXPORT_SEQUENCE);
     }
     // Save settings immediately when keybinds change
     saveSettings();
@@ -1487,21 +1755,14 @@ void MainWindow::onShowAudioLevelsChanged(bool enabled)
     if (enabled)
     {
         setupAudioVolmeter();
-        if (!m_visualizerUpdateTimer->isActive())
-            m_visualizerUpdateTimer->start(200); // Start timer if not running
     }
     else
     {
-        if (m_audioVolmeter)
-        {
-            obs_volmeter_attach_source(m_audioVolmeter, nullptr);
-        }
-        // Stop timer only if the other visualizer is also disabled
-        if (!m_showMicLevelsCheckBox->isChecked() && m_visualizerUpdateTimer->isActive())
-        {
-            m_visualizerUpdateTimer->stop();
-        }
+        m_meterBank.detach(m_desktopMeter);
+        m_audioSpectrum.detach();
+        m_audioLoudness.detach();
     }
+    updateMeterPanelVisibility();
     saveSettings();
 }
 
@@ -1511,29 +1772,58 @@ void MainWindow::onShowMicLevelsChanged(bool enabled)
     if (enabled)
     {
         setupMicrophoneVolmeter();
-        if (!m_visualizerUpdateTimer->isActive())
-            m_visualizerUpdateTimer->start(200); // Start timer if not running
     }
     else
     {
-        if (m_microphoneVolmeter)
-        {
-            obs_volmeter_attach_source(m_microphoneVolmeter, nullptr);
-        }
-        // Stop timer only if the other visualizer is also disabled
-        if (!m_showAudioLevelsCheckBox->isChecked() && m_visualizerUpdateTimer->isActive())
-        {
-            m_visualizerUpdateTimer->stop();
-        }
+        m_meterBank.detach(m_microphoneMeter);
+        m_microphoneSpectrum.detach();
+        m_microphoneLoudness.detach();
     }
+    updateMeterPanelVisibility();
+    saveSettings();
+}
+
+void MainWindow::updateMeterPanelVisibility()
+{
+    m_meterGroup->setVisible(m_showAudioLevelsCheckBox->isChecked() || m_showMicLevelsCheckBox->isChecked());
+}
+
+void MainWindow::onLoudnessNormalizationChanged()
+{
+    const bool enabled = m_normalizeLoudnessCheckBox->isChecked();
+    m_targetLoudnessSpinBox->setEnabled(enabled);
+    const double target = m_targetLoudnessSpinBox->value();
+    m_obs->post([enabled, target](GameCapture &capture)
+                { capture.SetLoudnessNormalization(enabled, target); });
     saveSettings();
 }
 
+void MainWindow::onAudioReplayChanged()
+{
+    saveSettings();
+    const bool enabled = m_settings.audioReplay;
+    if (m_uiLoaded)
+        m_audioReplayMinutesSpinBox->setEnabled(enabled);
+    if (m_capture->IsInitialized())
+    {
+        const int retentionSeconds = m_settings.audioReplayMinutes * 60;
+        m_obs->submit([enabled, retentionSeconds](GameCapture &capture)
+                      { return capture.SetAudioReplayBuffer(enabled, retentionSeconds); })
+            .then(this, [this](bool ok)
+                  {
+            if (!ok)
+                qWarning() << "Failed to start the audio-only replay buffer";
+            if (m_uiLoaded)
+                m_saveAudioReplayButton->setEnabled(m_capture->IsAudioReplayActive()); });
+    }
+}
+
 void MainWindow::refreshEncoders()
 {
     m_encoderCombo->blockSignals(true);
     m_encoderCombo->clear();
 
+    // Filled in by Initialize() and not changed after, so reading it here is safe
     auto encoders = m_capture->GetAvailableEncoders();
     for (const auto &encoder : encoders)
     {
@@ -1543,16 +1833,14 @@ void MainWindow::refreshEncoders()
         m_encoderCombo->addItem(QString::fromStdString(encoder.name), data);
     }
 
-    QSettings settings(QSettings::IniFormat, QSettings::UserScope, "GameClipRecorder", "Settings"); // Use consistent organization name
-    int savedEncoderType = settings.value("encoderType", -1).toInt();
     int indexToSelect = -1;
 
     // Try to find the user's previously saved encoder
-    if (savedEncoderType != -1)
+    if (m_preferredEncoderType != -1)
     {
         for (int i = 0; i < m_encoderCombo->count(); ++i)
         {
-            if (m_encoderCombo->itemData(i).toMap()["type"].toInt() == savedEncoderType)
+            if (m_encoderCombo->itemData(i).toMap()["type"].toInt() == m_preferredEncoderType)
             {
                 indexToSelect = i;
                 break;
@@ -1607,96 +1895,54 @@ void MainWindow::onGlobalHotkeyPressed(int id)
         saveClip();
         break;
     case HOTKEY_TOGGLE_CLIPPING:
-        m_clippingModeButton->click(); // Simulate a click to use the same logic
+        toggleClippingMode();
+        break;
+    case HOTKEY_EXPORT_TRACE:
+        exportTrace();
         break;
     }
 }
 
-void MainWindow::refreshAudioDevices()
+// Called with the watcher's cached list whenever a device comes or goes.
+// A vanished device falls back to "default" and is switched back to, live,
+// when it returns; the clip buffer keeps running either way. The lists are
+// kept for when the window is built again.
+void MainWindow::onAudioDevicesReceived(const QList<QPair<QString, QString>> &devices)
 {
-    QThread *thread = new QThread;
-    AudioDeviceFetcher *worker = new AudioDeviceFetcher();
-    worker->moveToThread(thread);
-
-    // Connect signals for results and automatic cleanup
-    connect(thread, &QThread::started, worker, &AudioDeviceFetcher::fetchOutputDevices);
-    connect(worker, &AudioDeviceFetcher::outputDevicesFetched, this, &MainWindow::onAudioDevicesReceived);
-    connect(worker, &AudioDeviceFetcher::outputDevicesFetched, thread, &QThread::quit);
-    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-    thread->start();
+    m_audioDevices = devices;
+    const QString deviceId = availableDeviceId(devices, m_preferredAudioDeviceId);
+    if (deviceId != m_preferredAudioDeviceId)
+        LOG_INFO("Audio device %1 is unavailable, using the default until it returns", m_preferredAudioDeviceId);
+    if (m_uiLoaded)
+        fillDeviceCombo(m_audioDeviceCombo, devices, deviceId);
+    if (deviceId != m_activeAudioDeviceId)
+        onAudioSettingsChanged();
 }
 
-void MainWindow::refreshMicrophoneDevices()
+void MainWindow::onMicrophoneDevicesReceived(const QList<QPair<QString, QString>> &devices)
 {
-    QThread *thread = new QThread;
-    AudioDeviceFetcher *worker = new AudioDeviceFetcher();
-    worker->moveToThread(thread);
-
-    // Connect signals for results and automatic cleanup
-    connect(thread, &QThread::started, worker, &AudioDeviceFetcher::fetchInputDevices);
-    connect(worker, &AudioDeviceFetcher::inputDevicesFetched, this, &MainWindow::onMicrophoneDevicesReceived);
-    connect(worker, &AudioDeviceFetcher::inputDevicesFetched, thread, &QThread::quit);
-    connect(thread, &QThread::finished, worker, &QObject::deleteLater);
-    connect(thread, &QThread::finished, thread, &QObject::deleteLater);
-
-    thread->start();
+    m_microphoneDevices = devices;
+    const QString deviceId = availableDeviceId(devices, m_preferredMicDeviceId);
+    if (deviceId != m_preferredMicDeviceId)
+        LOG_INFO("Microphone %1 is unavailable, using the default until it returns", m_preferredMicDeviceId);
+    if (m_uiLoaded)
+        fillDeviceCombo(m_micDeviceCombo, devices, deviceId);
+    if (deviceId != m_activeMicDeviceId)
+        onMicrophoneSettingsChanged();
 }
 
-void MainWindow::onAudioDevicesReceived(const QList<QPair<QString, QString>> &devices)
+void MainWindow::onAudioDeviceChanged()
 {
-    QString currentId = m_audioDeviceCombo->currentData().toString();
-    m_audioDeviceCombo->blockSignals(true);
-    m_audioDeviceCombo->clear();
-    for (const auto &device : devices)
-    {
-        m_audioDeviceCombo->addItem(device.second, device.first);
-    }
-    int index = m_audioDeviceCombo->findData(currentId);
-    if (index == -1)
-    {
-        QSettings settings("GameClipRecorder", "Settings");
-        QString savedId = settings.value("audioDeviceID", "default").toString();
-        index = m_audioDeviceCombo->findData(savedId);
-    }
-    if (index != -1)
-        m_audioDeviceCombo->setCurrentIndex(index);
-    m_audioDeviceCombo->blockSignals(false);
-    if (m_audioDeviceCombo->currentData().toString() != currentId)
-    {
-        onAudioSettingsChanged();
-    }
+    m_preferredAudioDeviceId = m_audioDeviceCombo->currentData().toString();
+    onAudioSettingsChanged();
 }
 
-void MainWindow::onMicrophoneDevicesReceived(const QList<QPair<QString, QString>> &devices)
+void MainWindow::onMicrophoneDeviceChanged()
 {
-    QString currentId = m_micDeviceCombo->currentData().toString();
-    m_micDeviceCombo->blockSignals(true);
-    m_micDeviceCombo->clear();
-    for (const auto &device : devices)
-    {
-        m_micDeviceCombo->addItem(device.second, device.first);
-    }
-    int index = m_micDeviceCombo->findData(currentId);
-    if (index == -1)
-    {
-        QSettings settings("GameClipRecorder", "Settings");
-        QString savedId = settings.value("micDeviceID", "default").toString();
-        index = m_micDeviceCombo->findData(savedId);
-    }
-    if (index != -1)
-        m_micDeviceCombo->setCurrentIndex(index);
-    m_micDeviceCombo->blockSignals(false);
-    if (m_micDeviceCombo->currentData().toString() != currentId)
-    {
-        onMicrophoneSettingsChanged();
-    }
+    m_preferredMicDeviceId = m_micDeviceCombo->currentData().toString();
+    onMicrophoneSettingsChanged();
 }
 
-void MainWindow::onAudioDeviceChanged() { onAudioSettingsChanged(); }
-void MainWindow::onMicrophoneDeviceChanged() { onMicrophoneSettingsChanged(); }
-
 void MainWindow::setupAutoStart()
 {
     QSettings settings("HKEY_CURRENT_USER\\SOFTWARE\\Microsoft\\Windows\\CurrentVersion\\Run", QSettings::NativeFormat);
@@ -1740,57 +1986,71 @@ void MainWindow::playNotificationSound()
 
 void MainWindow::setupAudioVolmeter()
 {
-    if (!m_capture || !m_capture->IsInitialized() || !m_showAudioLevelsCheckBox->isChecked())
+    if (m_idle || !m_uiLoaded || !m_capture->IsInitialized() || !m_showAudioLevelsCheckBox->isChecked())
         return;
 
-    // Create volmeter only once and reuse it
-    if (!m_audioVolmeter)
-    {
-        m_audioVolmeter = obs_volmeter_create(OBS_FADER_LOG);
-        obs_volmeter_add_callback(m_audioVolmeter, [](void *data, const float *, const float *peak, const float *)
-                                  {
-            auto* win = static_cast<MainWindow*>(data);
-            if (win && peak) win->m_currentAudioLevel = powf(10.0f, peak[0] / 20.0f); }, this);
-    }
-
-    obs_source_t *source = m_capture->GetDesktopAudioSource();
-    obs_volmeter_attach_source(m_audioVolmeter, source);
+    // The reference keeps the source alive until the meters hold their own
+    m_obs->submit([](GameCapture &capture)
+                  { return OBSSource(capture.GetDesktopAudioSource()); })
+        .then(this, [this](OBSSource source)
+              {
+        if (m_idle || !m_uiLoaded || !m_showAudioLevelsCheckBox->isChecked())
+            return;
+        m_meterBank.attach(m_desktopMeter, source);
+        m_audioSpectrum.attach(source);
+        m_audioLoudness.attach(source); });
 }
 
 void MainWindow::setupMicrophoneVolmeter()
 {
-    if (!m_capture || !m_capture->IsInitialized() || !m_showMicLevelsCheckBox->isChecked())
+    if (m_idle || !m_uiLoaded || !m_capture->IsInitialized() || !m_showMicLevelsCheckBox->isChecked())
         return;
 
-    // Create volmeter only once and reuse it
-    if (!m_microphoneVolmeter)
-    {
-        m_microphoneVolmeter = obs_volmeter_create(OBS_FADER_LOG);
-        obs_volmeter_add_callback(m_microphoneVolmeter, [](void *data, const float *, const float *peak, const float *)
-                                  {
-            auto* win = static_cast<MainWindow*>(data);
-            if (win && peak) win->m_currentMicrophoneLevel = powf(10.0f, peak[0] / 20.0f); }, this);
-    }
-
-    obs_source_t *source = m_capture->GetMicrophoneSource();
-    obs_volmeter_attach_source(m_microphoneVolmeter, source);
+    m_obs->submit([](GameCapture &capture)
+                  { return OBSSource(capture.GetMicrophoneSource()); })
+        .then(this, [this](OBSSource source)
+              {
+        if (m_idle || !m_uiLoaded || !m_showMicLevelsCheckBox->isChecked())
+            return;
+        m_meterBank.attach(m_microphoneMeter, source);
+        m_microphoneSpectrum.attach(source);
+        m_microphoneLoudness.attach(source); });
 }
 
-void MainWindow::updateVisualizers()
+void MainWindow::onTracingToggled(bool enabled)
 {
-    // This single slot updates both visualizers if they are visible.
-    if (m_audioVisualizer && m_showAudioLevelsCheckBox->isChecked())
+    Trace::setEnabled(enabled);
+    m_exportTraceAction->setEnabled(enabled);
+
+    // The export hotkey is global so a slow save can be captured while the game has focus.
+    if (m_globalHotkey)
     {
-        m_audioVisualizer->updateAudioLevel(m_audioEnabledCheckBox->isChecked() ? getAudioLevel() : 0.0f);
+        if (enabled)
+            m_globalHotkey->registerHotkey(HOTKEY_EXPORT_TRACE, TRACE_EXPORT_SEQUENCE);
+        else
+            m_globalHotkey->unregisterHotkey(HOTKEY_EXPORT_TRACE);
     }
-    if (m_microphoneVisualizer && m_showMicLevelsCheckBox->isChecked())
+    qDebug() << "Performance tracing" << (enabled ? "enabled" : "disabled");
+}
+
+void MainWindow::exportTrace()
+{
+    if (!Trace::isEnabled())
+        return;
+
+    QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QString path = dir + "/trace-" + QDateTime::currentDateTime().toString("yyyyMMdd-hhmmss") + ".json";
+    int count = Trace::exportChromeJson(path, 60);
+    if (count < 0)
     {
-        m_microphoneVisualizer->updateAudioLevel(m_micEnabledCheckBox->isChecked() ? getMicrophoneLevel() : 0.0f);
+        qWarning() << "Failed to write trace to" << path;
+        return;
     }
-}
 
-float MainWindow::getAudioLevel() { return m_currentAudioLevel; }
-float MainWindow::getMicrophoneLevel() { return m_currentMicrophoneLevel; }
+    qDebug() << "Exported" << count << "trace events to" << path;
+    if (m_trayIcon)
+        m_trayIcon->showMessage("Trace exported", QFileInfo(path).fileName(), QSystemTrayIcon::Information, 3000);
+}
 
 void MainWindow::showLogs()
 {
@@ -22,39 +22,50 @@
 #include <QSet>
 #include <QThread>
 #include <QElapsedTimer>
+#include <atomic>
 
 #include "GameCapture.h"
+#include "AppSettings.h"
+#include "ObsControlThread.h"
 #include "KeybindDialog.h"
 #include "GlobalHotkey.h"
-#include "AudioDeviceFetcher.h"
+#include "AudioDeviceWatcher.h"
 #include "ProcessMonitor.h"
 #include "AudioVisualizer.h"
+#include "SpectrumAnalyzer.h"
+#include "LoudnessMeter.h"
+#include "MeterBank.h"
 
 class LogDialog;
-
-// Forward declare obs_volmeter
-struct obs_volmeter;
-typedef struct obs_volmeter obs_volmeter_t;
+class MeterPanel;
 
 class MainWindow : public QMainWindow
 {
     Q_OBJECT
 
 public:
-    MainWindow(GameCapture *capture, QWidget *parent = nullptr);
+    MainWindow(ObsControlThread *obs, const AppSettings &settings, QWidget *parent = nullptr);
     ~MainWindow();
 
     void postInitRefresh();
+    // Hidden to the tray or minimized: no UI timers, no level callbacks
+    bool isIdle() const { return m_idle; }
+
+signals:
+    void idleChanged(bool idle);
 
 protected:
     void closeEvent(QCloseEvent *event) override;
     void changeEvent(QEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
 
 private:
     enum HotkeyID
     {
         HOTKEY_SAVE_CLIP = 1,
         HOTKEY_TOGGLE_CLIPPING,
+        HOTKEY_EXPORT_TRACE,
     };
 
     enum ClippingState
@@ -70,14 +81,26 @@ private:
     void setupTrayIcon();
     void setupGlobalHotkeys();
     void applyStyles();
-    void loadSettings();
+    void loadSettings(const AppSettings &settings);
     void saveSettings();
+    AppSettings settingsFromUi() const;
+    int clipLengthFromUi() const;
+    EncodingSettings encodingSettingsFromUi() const;
+    AudioSettings audioSettingsFromUi() const;
+    MicrophoneSettings microphoneSettingsFromUi() const;
+    AudioSettings currentAudioSettings() const;
+    MicrophoneSettings currentMicrophoneSettings() const;
     void startProcessMonitor();
     void stopProcessMonitor();
     void setupAutoStart();
     void removeAutoStart();
     void setupAudioVolmeter();
     void setupMicrophoneVolmeter();
+    void detachLevelSources();
+    void updateIdleState();
+    void loadUi();
+    void unloadUi();
+    void updateMeterPanelVisibility();
     void playNotificationSound();
     void setSettingsLocked(bool locked);
     void updateUiForState();
@@ -94,6 +117,9 @@ private:
     QGroupBox *createAdvancedAmfSettings();
 
     // Core Components
+    // Commands for the capture go through m_obs; m_capture is only used
+    // directly for its signals and thread-safe getters.
+    ObsControlThread *m_obs;
     GameCapture *m_capture;
     QSystemTrayIcon *m_trayIcon;
     ProcessMonitor *m_processMonitor;
@@ -101,12 +127,27 @@ private:
     GlobalHotkey *m_globalHotkey;
     KeybindDialog *m_keybindDialog;
     KeybindSettings m_keybindSettings;
+    AudioDeviceWatcher *m_deviceWatcher;
 
     // State
     ClippingState m_clippingState;
     bool m_gameDetected;
+    bool m_idle = false;
+    bool m_uiLoaded = false; // False while the widgets are freed in tray-only mode
+    // What the widgets show, and all there is while they're freed
+    AppSettings m_settings;
     QString m_currentDetectedGame;
     QString m_outputFolder;
+    // What the user picked; the combos fall back to "default" while it's unplugged
+    QString m_preferredAudioDeviceId = "default";
+    QString m_preferredMicDeviceId = "default";
+    // What the capture uses, which is "default" while the pick is unplugged
+    QString m_activeAudioDeviceId;
+    QString m_activeMicDeviceId;
+    QList<QPair<QString, QString>> m_audioDevices;
+    QList<QPair<QString, QString>> m_microphoneDevices;
+    // Selected once the encoders are known, if it's among them
+    int m_preferredEncoderType = -1;
     QSet<QString> m_gameExes;
 
     // UI Elements
@@ -116,6 +157,7 @@ private:
     QPushButton *m_clippingModeButton;
     QPushButton *m_clipButton;
     QComboBox *m_clipLengthCombo;
+    QSpinBox *m_saveBurstWindowSpinBox;
 
     // Status Display
     QLabel *m_clippingModeStatus;
@@ -130,6 +172,7 @@ private:
     QCheckBox *m_autoStartCheckBox;
     QCheckBox *m_minimizeToTrayCheckBox;
     QCheckBox *m_startClippingAutomaticallyCheckBox;
+    QCheckBox *m_unloadWindowInTrayCheckBox;
     QComboBox *m_resolutionCombo;
     QComboBox *m_fpsCombo;
 
@@ -181,6 +224,13 @@ private:
     QLabel *m_volumeLabel;
     AudioVisualizer *m_audioVisualizer;
     QCheckBox *m_showAudioLevelsCheckBox;
+    QCheckBox *m_normalizeLoudnessCheckBox;
+    QDoubleSpinBox *m_targetLoudnessSpinBox;
+
+    // Audio-Only Buffer
+    QCheckBox *m_audioReplayCheckBox;
+    QSpinBox *m_audioReplayMinutesSpinBox;
+    QPushButton *m_saveAudioReplayButton;
 
     // Microphone Settings
     QCheckBox *m_micEnabledCheckBox;
@@ -188,6 +238,12 @@ private:
     QPushButton *m_refreshMicButton;
     QSlider *m_micVolumeSlider;
     QLabel *m_micVolumeLabel;
+    QComboBox *m_noiseSuppressionCombo;
+    QCheckBox *m_noiseGateCheckBox;
+    QSpinBox *m_noiseGateOpenSpinBox;
+    QSpinBox *m_noiseGateCloseSpinBox;
+    QSpinBox *m_noiseGateHoldSpinBox;
+    QSpinBox *m_noiseGateReleaseSpinBox;
     AudioVisualizer *m_microphoneVisualizer;
     QCheckBox *m_showMicLevelsCheckBox;
 
@@ -200,20 +256,29 @@ private:
     QAction *m_keybindAction;
     QMenu* m_helpMenu;
     QAction* m_showLogsAction;
+    QAction* m_traceEnabledAction;
+    QAction* m_exportTraceAction;
     LogDialog* m_logDialog;
 
 
     // Audio Level Monitoring
-    QTimer *m_visualizerUpdateTimer;
-    obs_volmeter_t *m_audioVolmeter;
-    obs_volmeter_t *m_microphoneVolmeter;
-    float m_currentAudioLevel;
-    float m_currentMicrophoneLevel;
+    // Per-channel levels, written by volmeter callbacks on the OBS audio
+    // thread and read by the visualizers and the meter panel
+    MeterBank m_meterBank;
+    int m_desktopMeter;
+    int m_microphoneMeter;
+    QGroupBox *m_meterGroup;
+    MeterPanel *m_meterPanel;
+    SpectrumAnalyzer m_audioSpectrum;
+    SpectrumAnalyzer m_microphoneSpectrum;
+    LoudnessMeter m_audioLoudness;
+    LoudnessMeter m_microphoneLoudness;
 
 private slots:
     // UI Actions
     void toggleClippingMode();
     void saveClip();
+    void saveAudioReplay();
     void addGameExe();
     void removeGameExe();
     void browseOutputFolder();
@@ -221,9 +286,12 @@ private slots:
     void showFromTray();
     void exitApplication();
     void showLogs();
+    void onTracingToggled(bool enabled);
+    void exportTrace();
 
     // Settings Changes
     void onClipLengthChanged();
+    void onSaveBurstWindowChanged();
     void onEncodingSettingsChanged();
     void onRateControlChanged();
     void onAudioSettingsChanged();
@@ -235,6 +303,8 @@ private slots:
     void onStartClippingAutomaticallyChanged(bool checked);
     void onShowAudioLevelsChanged(bool enabled);
     void onShowMicLevelsChanged(bool enabled);
+    void onLoudnessNormalizationChanged();
+    void onAudioReplayChanged();
 
     // GameCapture Signals
     void onClippingModeChanged(bool active);
@@ -247,16 +317,9 @@ private slots:
     void onProcessStarted(const QString &exeName);
     void onProcessStopped(const QString &exeName);
 
-    // Audio Device Fetching
-    void refreshAudioDevices();
-    void refreshMicrophoneDevices();
+    // Audio Devices
     void onAudioDevicesReceived(const QList<QPair<QString, QString>> &devices);
     void onMicrophoneDevicesReceived(const QList<QPair<QString, QString>> &devices);
     void onAudioDeviceChanged();
     void onMicrophoneDeviceChanged();
-
-    // Audio Level Updates
-    void updateVisualizers();
-    float getAudioLevel();
-    float getMicrophoneLevel();
 };
\ No newline at end of file
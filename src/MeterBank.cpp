@@ -0,0 +1,85 @@
+#include "MeterBank.h"
+#include <obs.h>
+#include <algorithm>
+#include <cmath>
+
+MeterBank::~MeterBank()
+{
+    for (auto &meter : m_meters) {
+        if (meter->volmeter) {
+            obs_volmeter_destroy(meter->volmeter);
+        }
+    }
+}
+
+int MeterBank::addMeter(const QString &name)
+{
+    auto meter = std::make_unique<Meter>();
+    meter->name = name;
+    reset(*meter);
+    m_meters.push_back(std::move(meter));
+    return meterCount() - 1;
+}
+
+void MeterBank::attach(int meter, obs_source_t *source)
+{
+    Meter &m = *m_meters[meter];
+    if (!m.volmeter) {
+        // Created lazily: needs libobs to be up
+        m.volmeter = obs_volmeter_create(OBS_FADER_LOG);
+        obs_volmeter_add_callback(m.volmeter, &MeterBank::volmeterCallback, &m);
+    }
+    obs_volmeter_attach_source(m.volmeter, source);
+    // Detaching (or a source going away) stops the callbacks; clear the
+    // last values so the meter doesn't freeze at them.
+    reset(m);
+    if (source) {
+        m.channels.store(std::min(obs_volmeter_get_nr_channels(m.volmeter), kMaxChannels), std::memory_order_relaxed);
+    }
+}
+
+void MeterBank::detach(int meter)
+{
+    attach(meter, nullptr);
+}
+
+void MeterBank::volmeterCallback(void *param, const float magnitude[], const float peak[], const float[])
+{
+    Meter &meter = *static_cast<Meter *>(param);
+    // May differ from attach time after an audio reset
+    const int channels = std::min(meter.channels.load(std::memory_order_relaxed), kMaxChannels);
+    for (int c = 0; c < channels; ++c) {
+        // -inf for digital silence
+        meter.peakDb[c].store(std::max(peak[c], kSilenceDb), std::memory_order_relaxed);
+        meter.rmsDb[c].store(std::max(magnitude[c], kSilenceDb), std::memory_order_relaxed);
+    }
+}
+
+void MeterBank::reset(Meter &meter)
+{
+    meter.channels.store(0, std::memory_order_relaxed);
+    for (int c = 0; c < kMaxChannels; ++c) {
+        meter.peakDb[c].store(kSilenceDb, std::memory_order_relaxed);
+        meter.rmsDb[c].store(kSilenceDb, std::memory_order_relaxed);
+    }
+}
+
+MeterBank::Level MeterBank::level(int meter, int channel) const
+{
+    const Meter &m = *m_meters[meter];
+    Level level;
+    if (channel < channelCount(meter)) {
+        level.peakDb = m.peakDb[channel].load(std::memory_order_relaxed);
+        level.rmsDb = m.rmsDb[channel].load(std::memory_order_relaxed);
+    }
+    return level;
+}
+
+float MeterBank::peakAmplitude(int meter) const
+{
+    float loudest = kSilenceDb;
+    for (int c = 0; c < channelCount(meter); ++c) {
+        loudest = std::max(loudest, m_meters[meter]->peakDb[c].load(std::memory_order_relaxed));
+    }
+    return loudest <= kSilenceDb ? 0.0f : std::pow(10.0f, loudest / 20.0f);
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <QString>
+
+struct obs_source;
+typedef struct obs_source obs_source_t;
+struct obs_volmeter;
+typedef struct obs_volmeter obs_volmeter_t;
+
+// Per-channel levels for any number of OBS sources. Each meter wraps an
+// obs_volmeter whose callback (OBS audio thread) stores every channel's
+// peak and RMS into atomics; the GUI reads them whenever it draws a frame,
+// so however often OBS reports, the UI sees at most one batch per frame.
+class MeterBank
+{
+public:
+    static constexpr int kMaxChannels = 8;
+    static constexpr float kSilenceDb = -96.0f;
+
+    struct Level
+    {
+        float peakDb = kSilenceDb;
+        float rmsDb = kSilenceDb;
+    };
+
+    MeterBank() = default;
+    ~MeterBank();
+    MeterBank(const MeterBank &) = delete;
+    MeterBank &operator=(const MeterBank &) = delete;
+
+    // GUI thread. Returns the new meter's index.
+    int addMeter(const QString &name);
+    void attach(int meter, obs_source_t *source);
+    void detach(int meter);
+
+    // Any thread
+    int meterCount() const { return static_cast<int>(m_meters.size()); }
+    QString name(int meter) const { return m_meters[meter]->name; }
+    int channelCount(int meter) const { return m_meters[meter]->channels.load(std::memory_order_relaxed); }
+    Level level(int meter, int channel) const;
+    // Loudest channel's peak as a 0..1 amplitude
+    float peakAmplitude(int meter) const;
+
+private:
+    struct Meter
+    {
+        QString name;
+        obs_volmeter_t *volmeter = nullptr;
+        std::atomic<int> channels{0}; // 0 while detached
+        std::array<std::atomic<float>, kMaxChannels> peakDb;
+        std::array<std::atomic<float>, kMaxChannels> rmsDb;
+    };
+
+    static void volmeterCallback(void *param, const float magnitude[], const float peak[], const float inputPeak[]);
+    static void reset(Meter &meter);
+
+    std::vector<std::unique_ptr<Meter>> m_meters;
+};
@@ -0,0 +1,222 @@
+#include "MeterPanel.h"
+#include "Trace.h"
+#include <QPainter>
+#include <QPaintEvent>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+constexpr int kMargin = 4;
+constexpr int kBarHeight = 6;
+constexpr int kBarGap = 2;
+constexpr int kMeterGap = 6;
+}
+
+MeterPanel::MeterPanel(const MeterBank *bank, QWidget *parent)
+    : QWidget(parent),
+      m_bank(bank)
+{
+    setMinimumWidth(200);
+    setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Fixed);
+
+    setAutoFillBackground(true);
+    QPalette palette = this->palette();
+    palette.setColor(QPalette::Window, QColor(42, 42, 43));
+    setPalette(palette);
+
+    m_clock.start();
+    relayout();
+}
+
+MeterPanel::~MeterPanel()
+{
+    FrameClock::instance().unsubscribe(this);
+}
+
+void MeterPanel::showEvent(QShowEvent *event)
+{
+    FrameClock::instance().subscribe(this);
+    m_lastFrameMs = m_clock.elapsed();
+    QWidget::showEvent(event);
+}
+
+void MeterPanel::hideEvent(QHideEvent *event)
+{
+    FrameClock::instance().unsubscribe(this);
+    QWidget::hideEvent(event);
+}
+
+void MeterPanel::resizeEvent(QResizeEvent *event)
+{
+    const int left = kMargin;
+    const int right = width() - kMargin;
+    m_gradient = QLinearGradient(left, 0, right, 0);
+    // Same zones as the OBS mixer: green up to -20 dB, yellow to -9, red above
+    const qreal yellow = (-20.0 - kMinDb) / -kMinDb;
+    const qreal red = (-9.0 - kMinDb) / -kMinDb;
+    m_gradient.setColorAt(0.0, QColor(76, 255, 76));
+    m_gradient.setColorAt(yellow, QColor(76, 255, 76));
+    m_gradient.setColorAt(yellow + 0.001, QColor(255, 255, 76));
+    m_gradient.setColorAt(red, QColor(255, 255, 76));
+    m_gradient.setColorAt(red + 0.001, QColor(255, 76, 76));
+    m_gradient.setColorAt(1.0, QColor(255, 76, 76));
+
+    for (Meter &meter : m_meters) {
+        meter.shownReadout.clear();
+        for (Channel &channel : meter.channel) {
+            channel.shownRms = channel.shownPeak = channel.shownHold = 0;
+        }
+    }
+    QWidget::resizeEvent(event);
+}
+
+QSize MeterPanel::sizeHint() const
+{
+    const int bottom = m_meters.empty() ? kMargin : meterTop(static_cast<int>(m_meters.size())) - kMeterGap + kMargin;
+    return QSize(300, bottom);
+}
+
+void MeterPanel::relayout()
+{
+    m_meters.resize(m_bank->meterCount());
+    for (int i = 0; i < m_bank->meterCount(); ++i) {
+        m_meters[i].channels = m_bank->channelCount(i);
+    }
+    updateGeometry();
+    update();
+}
+
+int MeterPanel::meterTop(int meter) const
+{
+    // A detached meter still gets its header and one (empty) bar
+    int y = kMargin;
+    for (int i = 0; i < meter; ++i) {
+        const int bars = std::max(1, m_meters[i].channels);
+        y += fontMetrics().height() + bars * (kBarHeight + kBarGap) + kMeterGap;
+    }
+    return y;
+}
+
+QRect MeterPanel::headerRect(int meter) const
+{
+    return QRect(kMargin, meterTop(meter), width() - 2 * kMargin, fontMetrics().height());
+}
+
+QRect MeterPanel::barRect(int meter, int channel) const
+{
+    const int y = meterTop(meter) + fontMetrics().height() + channel * (kBarHeight + kBarGap);
+    return QRect(kMargin, y, width() - 2 * kMargin, kBarHeight);
+}
+
+int MeterPanel::dbToPixels(float db, int width) const
+{
+    if (db <= kMinDb) {
+        return 0;
+    }
+    return static_cast<int>(std::lround(std::min(1.0f, (db - kMinDb) / -kMinDb) * width));
+}
+
+bool MeterPanel::advanceFrame()
+{
+    // Channel counts change when a source is (re)attached
+    for (int i = 0; i < m_bank->meterCount(); ++i) {
+        if (i >= static_cast<int>(m_meters.size()) || m_meters[i].channels != m_bank->channelCount(i)) {
+            relayout();
+            return true;
+        }
+    }
+
+    const qint64 nowMs = m_clock.elapsed();
+    const float fallDb = kPeakFallDbPerSec * (nowMs - m_lastFrameMs) / 1000.0f;
+    m_lastFrameMs = nowMs;
+
+    const int barWidth = width() - 2 * kMargin;
+    QRegion dirty;
+    for (int i = 0; i < static_cast<int>(m_meters.size()); ++i) {
+        Meter &meter = m_meters[i];
+        float loudestHold = MeterBank::kSilenceDb;
+
+        for (int c = 0; c < meter.channels; ++c) {
+            Channel &channel = meter.channel[c];
+            const MeterBank::Level level = m_bank->level(i, c);
+
+            channel.rmsDb = level.rmsDb;
+            channel.peakDb = std::max(level.peakDb, channel.peakDb - fallDb);
+            if (level.peakDb >= channel.holdDb || nowMs - channel.holdSetMs > kHoldMs) {
+                channel.holdDb = std::max(level.peakDb, channel.peakDb);
+                channel.holdSetMs = nowMs;
+            }
+            loudestHold = std::max(loudestHold, channel.holdDb);
+
+            const int rms = dbToPixels(channel.rmsDb, barWidth);
+            const int peak = dbToPixels(channel.peakDb, barWidth);
+            const int hold = dbToPixels(channel.holdDb, barWidth);
+            if (rms != channel.shownRms || peak != channel.shownPeak || hold != channel.shownHold) {
+                channel.shownRms = rms;
+                channel.shownPeak = peak;
+                channel.shownHold = hold;
+                dirty += barRect(i, c);
+            }
+        }
+
+        const QString readout = meter.channels == 0 ? QString("-")
+                                : loudestHold <= kMinDb ? QString("-inf dB")
+                                                        : QString("%1 dB").arg(loudestHold, 0, 'f', 1);
+        if (readout != meter.shownReadout) {
+            meter.shownReadout = readout;
+            dirty += headerRect(i);
+        }
+    }
+
+    if (dirty.isEmpty()) {
+        return false;
+    }
+    update(dirty);
+    return true;
+}
+
+void MeterPanel::paintEvent(QPaintEvent *event)
+{
+    TRACE_SCOPE("MeterPanel::paintEvent");
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing, false);
+    painter.fillRect(event->rect(), QColor(42, 42, 43));
+
+    const QColor peakShade(0, 0, 0, 110); // Darkens the peak-only part of a bar
+    for (int i = 0; i < static_cast<int>(m_meters.size()); ++i) {
+        const Meter &meter = m_meters[i];
+
+        const QRect header = headerRect(i);
+        if (event->rect().intersects(header)) {
+            painter.setPen(QColor(200, 200, 200));
+            painter.drawText(header, Qt::AlignLeft | Qt::AlignVCenter, m_bank->name(i));
+            painter.setPen(QColor(255, 255, 255));
+            painter.drawText(header, Qt::AlignRight | Qt::AlignVCenter, meter.shownReadout);
+        }
+
+        for (int c = 0; c < std::max(1, meter.channels); ++c) {
+            const QRect bar = barRect(i, c);
+            if (!event->rect().intersects(bar)) {
+                continue;
+            }
+            painter.fillRect(bar, QColor(60, 60, 61));
+            if (c >= meter.channels) {
+                continue;
+            }
+
+            const Channel &channel = meter.channel[c];
+            if (channel.shownPeak > 0) {
+                const QRect peak(bar.left(), bar.top(), channel.shownPeak, bar.height());
+                painter.fillRect(peak, m_gradient);
+                if (channel.shownRms < channel.shownPeak) {
+                    painter.fillRect(peak.adjusted(channel.shownRms, 0, 0, 0), peakShade);
+                }
+            }
+            if (channel.shownHold > 0) {
+                const int x = bar.left() + std::min(channel.shownHold, bar.width() - 2);
+                painter.fillRect(QRect(x, bar.top(), 2, bar.height()), QColor(255, 255, 255));
+            }
+        }
+    }
+}
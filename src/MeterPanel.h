@@ -0,0 +1,65 @@
+#pragma once
+
+#include <QWidget>
+#include <QElapsedTimer>
+#include <QLinearGradient>
+#include <array>
+#include <vector>
+#include "FrameClock.h"
+#include "MeterBank.h"
+
+// Every meter of a MeterBank in one widget: a header line per source and a
+// horizontal bar per channel showing RMS, peak and peak hold. All meters are
+// sampled together once per frame and drawn in a single paint pass; only the
+// bars that moved are repainted.
+class MeterPanel : public QWidget, private FrameClock::Client
+{
+    Q_OBJECT
+
+public:
+    explicit MeterPanel(const MeterBank *bank, QWidget *parent = nullptr);
+    ~MeterPanel();
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+    QSize sizeHint() const override;
+
+private:
+    static constexpr float kMinDb = -60.0f;
+    static constexpr float kPeakFallDbPerSec = 20.0f;
+    static constexpr qint64 kHoldMs = 1500;
+
+    struct Channel
+    {
+        float rmsDb = MeterBank::kSilenceDb;
+        float peakDb = MeterBank::kSilenceDb; // With fall-off
+        float holdDb = MeterBank::kSilenceDb;
+        qint64 holdSetMs = 0;
+        // What the last paint showed, in pixels
+        int shownRms = 0;
+        int shownPeak = 0;
+        int shownHold = 0;
+    };
+    struct Meter
+    {
+        int channels = 0;
+        std::array<Channel, MeterBank::kMaxChannels> channel;
+        QString shownReadout;
+    };
+
+    bool advanceFrame() override;
+    void relayout();
+    int meterTop(int meter) const;
+    QRect headerRect(int meter) const;
+    QRect barRect(int meter, int channel) const;
+    int dbToPixels(float db, int width) const;
+
+    const MeterBank *m_bank;
+    std::vector<Meter> m_meters;
+    QElapsedTimer m_clock;
+    qint64 m_lastFrameMs = 0;
+    QLinearGradient m_gradient; // Full-scale bar colours, rebuilt on resize
+};
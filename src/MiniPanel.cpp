@@ -0,0 +1,385 @@
+// nuklear comes ahead of the Qt headers: one of its structs has a member
+// named slots, which Qt defines away as a keyword.
+#include <GLFW/glfw3.h>
+
+#define NK_IMPLEMENTATION
+#define NK_INCLUDE_FIXED_TYPES
+#define NK_INCLUDE_FONT_BAKING
+#define NK_INCLUDE_DEFAULT_FONT
+#define NK_INCLUDE_DEFAULT_ALLOCATOR
+#define NK_INCLUDE_VERTEX_BUFFER_OUTPUT
+#define NK_INCLUDE_STANDARD_VARARGS
+#define NK_BUTTON_TRIGGER_ON_RELEASE
+#include <nuklear.h>
+
+#define NK_GLFW_GL2_IMPLEMENTATION
+#include <nuklear_glfw_gl2.h>
+
+#include "MiniPanel.h"
+#include "AppSettings.h"
+#include "GameCapture.h"
+#include "Logger.h"
+#include "ObsControlThread.h"
+#include "ProcessMonitor.h"
+#include <QFileInfo>
+#include <QThread>
+#include <cstring>
+
+namespace
+{
+    constexpr int kWindowWidth = 340;
+    constexpr int kWindowHeight = 104;
+
+    void logGlfwError(int code, const char *description)
+    {
+        LOG_WARN("GLFW error 0x%1: %2", QString::number(code, 16), QString::fromUtf8(description));
+    }
+}
+
+MiniPanel::MiniPanel(ObsControlThread *obs, const AppSettings &settings, bool headless, QObject *parent)
+    : QObject(parent),
+      m_obs(obs),
+      m_headless(headless),
+      m_clipLengthSeconds(settings.clipLengthSeconds),
+      m_lastSaveLine("Last save: none")
+{
+    for (const QString &exe : settings.gameExes)
+        m_gameExes.insert(exe);
+
+    GameCapture *capture = m_obs->capture();
+    connect(capture, &GameCapture::clippingModeChanged, this, &MiniPanel::updateStatus);
+    connect(capture, &GameCapture::recordingStarted, this, [this]()
+            {
+        m_saving = true;
+        requestFrame(); });
+    connect(capture, &GameCapture::recordingFinished, this, &MiniPanel::onRecordingFinished);
+
+    connect(&m_pollTimer, &QTimer::timeout, this, &MiniPanel::poll);
+    updateStatus();
+}
+
+MiniPanel::~MiniPanel()
+{
+    stopProcessMonitor();
+    if (!m_window)
+        return;
+
+    if (m_headless)
+    {
+        // nk_glfw3_shutdown would delete the font texture, and there's no
+        // GL context to delete it from
+        nk_font_atlas_clear(&glfw.atlas);
+        nk_free(&glfw.ctx);
+        nk_buffer_free(&glfw.ogl.cmds);
+        std::memset(&glfw, 0, sizeof(glfw));
+    }
+    else
+    {
+        nk_glfw3_shutdown();
+    }
+    glfwDestroyWindow(m_window);
+    glfwTerminate();
+}
+
+bool MiniPanel::open()
+{
+    glfwSetErrorCallback(logGlfwError);
+    if (m_headless)
+        glfwInitHint(GLFW_PLATFORM, GLFW_PLATFORM_NULL);
+    if (!glfwInit())
+        return false;
+
+    glfwWindowHint(GLFW_RESIZABLE, GLFW_FALSE);
+    if (m_headless)
+        glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
+    m_window = glfwCreateWindow(kWindowWidth, kWindowHeight, "OBS Replay Companion", nullptr, nullptr);
+    if (!m_window)
+    {
+        glfwTerminate();
+        return false;
+    }
+    glfwSetWindowUserPointer(m_window, this);
+    glfwSetWindowRefreshCallback(m_window, &MiniPanel::onWindowRefresh);
+
+    m_nk = nk_glfw3_init(m_window, NK_GLFW3_INSTALL_CALLBACKS);
+    if (m_headless)
+    {
+        // Same atlas as nk_glfw3_font_stash_end, minus the texture upload
+        int width = 0;
+        int height = 0;
+        nk_font_atlas_init_default(&glfw.atlas);
+        nk_font_atlas_begin(&glfw.atlas);
+        nk_font_atlas_bake(&glfw.atlas, &width, &height, NK_FONT_ATLAS_ALPHA8);
+        nk_font_atlas_end(&glfw.atlas, nk_handle_id(0), &glfw.ogl.null);
+        if (glfw.atlas.default_font)
+            nk_style_set_font(m_nk, &glfw.atlas.default_font->handle);
+    }
+    else
+    {
+        glfwMakeContextCurrent(m_window);
+        // Frames are paced by the poll timer; waiting for vsync would block
+        // the event loop
+        glfwSwapInterval(0);
+        struct nk_font_atlas *atlas = nullptr;
+        nk_glfw3_font_stash_begin(&atlas);
+        nk_glfw3_font_stash_end();
+    }
+
+    // The null window never gets events, so there's nothing to poll
+    if (!m_headless)
+        m_pollTimer.start(kIdlePollMs);
+
+    LOG_INFO("Mini panel open (%1)", m_headless ? QString("headless") : QString("windowed"));
+    requestFrame();
+    return true;
+}
+
+void MiniPanel::start(bool startClipping)
+{
+    updateStatus();
+    if (startClipping)
+        toggleClippingMode();
+}
+
+void MiniPanel::toggleClippingMode()
+{
+    if (!m_obs->capture()->IsInitialized())
+    {
+        LOG_WARN("OBS is not initialized yet, ignoring the clipping toggle");
+        return;
+    }
+
+    if (m_clippingState == DISABLED)
+    {
+        m_clippingState = AWAITING_GAME;
+        startProcessMonitor();
+    }
+    else
+    {
+        m_clippingState = DISABLED;
+        stopProcessMonitor();
+        m_gameDetected = false;
+        m_currentDetectedGame.clear();
+        m_obs->post([](GameCapture &capture)
+                    {
+            capture.StopClippingMode();
+            capture.ClearCapture(); });
+    }
+    updateStatus();
+}
+
+void MiniPanel::saveClip()
+{
+    // While saving, a request still inside the burst window extends the
+    // pending clip; any other is turned down by the capture
+    if (m_clippingState != ACTIVE)
+        return;
+
+    m_saving = true;
+    requestFrame();
+    const int duration = m_clipLengthSeconds;
+    m_obs->submit([duration](GameCapture &capture)
+                  { return capture.SaveInstantReplay(duration, ""); })
+        .then(this, [this](bool saving)
+              {
+        // When saving, recordingFinished clears it
+        if (saving)
+            return;
+        m_saving = m_obs->capture()->IsRecording();
+        requestFrame(); });
+}
+
+void MiniPanel::onProcessStarted(const QString &exeName)
+{
+    if (m_clippingState != AWAITING_GAME || m_gameDetected || !m_gameExes.contains(exeName))
+        return;
+
+    m_gameDetected = true;
+    m_currentDetectedGame = exeName;
+    updateStatus();
+
+    const std::string exe = exeName.toStdString();
+    m_obs->submit([exe](GameCapture &capture)
+                  {
+        capture.SetGameCapture(exe);
+        if (capture.StartClippingMode())
+            return true;
+        capture.ClearCapture();
+        return false; })
+        .then(this, [this, exeName](bool started)
+              {
+        // Clipping was turned off or the game exited meanwhile
+        if (m_clippingState != AWAITING_GAME || m_currentDetectedGame != exeName)
+            return;
+
+        if (started)
+        {
+            m_clippingState = ACTIVE;
+        }
+        else
+        {
+            LOG_WARN("Failed to start the clipping buffer for %1", exeName);
+            m_gameDetected = false;
+            m_currentDetectedGame.clear();
+        }
+        updateStatus(); });
+}
+
+void MiniPanel::onProcessStopped(const QString &exeName)
+{
+    if ((m_clippingState != ACTIVE && !m_gameDetected) || exeName.compare(m_currentDetectedGame, Qt::CaseInsensitive) != 0)
+        return;
+
+    m_clippingState = AWAITING_GAME;
+    m_gameDetected = false;
+    m_currentDetectedGame.clear();
+    m_obs->post([](GameCapture &capture)
+                {
+        capture.StopClippingMode();
+        capture.ClearCapture(); });
+    updateStatus();
+}
+
+void MiniPanel::onRecordingFinished(bool success, const QString &filename)
+{
+    m_saving = false;
+    m_lastSaveLine = success ? "Last save: " + QFileInfo(filename).fileName().toUtf8() : QByteArray("Last save: failed");
+    requestFrame();
+}
+
+void MiniPanel::startProcessMonitor()
+{
+    if (m_processMonitorThread)
+        return;
+
+    m_processMonitorThread = new QThread;
+    m_processMonitor = new ProcessMonitor();
+    m_processMonitor->moveToThread(m_processMonitorThread);
+    connect(m_processMonitor, &ProcessMonitor::processStarted, this, &MiniPanel::onProcessStarted);
+    connect(m_processMonitor, &ProcessMonitor::processStopped, this, &MiniPanel::onProcessStopped);
+    connect(m_processMonitorThread, &QThread::started, m_processMonitor, &ProcessMonitor::startMonitoring);
+    connect(m_processMonitorThread, &QThread::finished, m_processMonitor, &QObject::deleteLater);
+    connect(m_processMonitorThread, &QThread::finished, m_processMonitorThread, &QObject::deleteLater);
+    m_processMonitorThread->start();
+}
+
+void MiniPanel::stopProcessMonitor()
+{
+    if (!m_processMonitorThread)
+        return;
+
+    m_processMonitorThread->quit();
+    m_processMonitorThread = nullptr;
+    m_processMonitor = nullptr;
+}
+
+void MiniPanel::updateStatus()
+{
+    QString status;
+    switch (m_clippingState)
+    {
+    case DISABLED:
+        status = "Clipping off";
+        break;
+    case AWAITING_GAME:
+        status = m_gameDetected ? QString("Starting buffer for %1...").arg(m_currentDetectedGame)
+                                : QString("Waiting for a game");
+        break;
+    case ACTIVE:
+        status = m_obs->capture()->IsClippingModeActive()
+                     ? QString("Buffering %1 (last %2 s)").arg(m_currentDetectedGame).arg(m_clipLengthSeconds)
+                     : QString("Buffer stopped (%1)").arg(m_currentDetectedGame);
+        break;
+    }
+    m_statusLine = status.toUtf8();
+    requestFrame();
+}
+
+void MiniPanel::requestFrame()
+{
+    m_dirty = true;
+    if (m_framePending || !m_window)
+        return;
+    m_framePending = true;
+    QMetaObject::invokeMethod(this, &MiniPanel::frame, Qt::QueuedConnection);
+}
+
+void MiniPanel::poll()
+{
+    glfwPollEvents();
+    if (glfwWindowShouldClose(m_window))
+    {
+        m_pollTimer.stop();
+        emit closed();
+        return;
+    }
+
+    const bool interactive = glfwGetWindowAttrib(m_window, GLFW_FOCUSED) || glfwGetWindowAttrib(m_window, GLFW_HOVERED);
+    const int interval = interactive ? kActivePollMs : kIdlePollMs;
+    if (m_pollTimer.interval() != interval)
+        m_pollTimer.setInterval(interval);
+
+    // nuklear only sees input (and hover) when a frame runs
+    if (interactive || m_dirty)
+        frame();
+}
+
+void MiniPanel::frame()
+{
+    m_framePending = false;
+    // Stays dirty until it can be drawn again
+    if (!m_window || glfwGetWindowAttrib(m_window, GLFW_ICONIFIED))
+        return;
+    m_dirty = false;
+
+    nk_glfw3_new_frame();
+    layout();
+    ++m_framesDrawn;
+
+    if (m_headless)
+    {
+        nk_clear(m_nk);
+        return;
+    }
+
+    int width = 0;
+    int height = 0;
+    glfwGetFramebufferSize(m_window, &width, &height);
+    glViewport(0, 0, width, height);
+    glClearColor(0.12f, 0.12f, 0.12f, 1.0f);
+    glClear(GL_COLOR_BUFFER_BIT);
+    nk_glfw3_render(NK_ANTI_ALIASING_ON);
+    glfwSwapBuffers(m_window);
+}
+
+void MiniPanel::layout()
+{
+    int width = 0;
+    int height = 0;
+    glfwGetWindowSize(m_window, &width, &height);
+
+    bool toggle = false;
+    bool save = false;
+    if (nk_begin(m_nk, "MiniPanel", nk_rect(0, 0, float(width), float(height)), NK_WINDOW_NO_SCROLLBAR))
+    {
+        nk_layout_row_dynamic(m_nk, 20, 1);
+        nk_label(m_nk, m_statusLine.constData(), NK_TEXT_LEFT);
+        nk_label(m_nk, m_lastSaveLine.constData(), NK_TEXT_LEFT);
+
+        nk_layout_row_dynamic(m_nk, 30, 2);
+        toggle = nk_button_label(m_nk, isClippingEnabled() ? "Stop clipping" : "Start clipping");
+        save = nk_button_label(m_nk, m_saving ? "Saving..." : "Save clip");
+    }
+    nk_end(m_nk);
+
+    // Acted on once the frame is laid out; both only queue work
+    if (toggle)
+        toggleClippingMode();
+    if (save)
+        saveClip();
+}
+
+void MiniPanel::onWindowRefresh(GLFWwindow *window)
+{
+    static_cast<MiniPanel *>(glfwGetWindowUserPointer(window))->requestFrame();
+}
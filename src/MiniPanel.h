@@ -0,0 +1,102 @@
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QSet>
+#include <QString>
+#include <QTimer>
+
+class ObsControlThread;
+class ProcessMonitor;
+class QThread;
+struct AppSettings;
+struct GLFWwindow;
+struct nk_context;
+
+// The --mini alternative to MainWindow: buffer state, the last saved clip and
+// Clipping / Save buttons, drawn with nuklear on a single GLFW window. No Qt
+// Widgets, so the process only runs a QCoreApplication. Game detection drives
+// the buffer the same way the main window does.
+//
+// Headless (--headless) uses GLFW's null platform: no display and no GL
+// context. Frames are still laid out, with input from the null window, and
+// then discarded, so the panel and its state machine run unattended.
+class MiniPanel : public QObject
+{
+    Q_OBJECT
+
+public:
+    MiniPanel(ObsControlThread *obs, const AppSettings &settings, bool headless, QObject *parent = nullptr);
+    ~MiniPanel();
+
+    // Creates the window. False if GLFW or the GL context can't be set up.
+    bool open();
+    // Once OBS is initialized
+    void start(bool startClipping);
+
+    bool isClippingEnabled() const { return m_clippingState != DISABLED; }
+    // One line each, as shown in the panel
+    QString statusText() const { return QString::fromUtf8(m_statusLine); }
+    QString lastSaveText() const { return QString::fromUtf8(m_lastSaveLine); }
+    // Laid out, and drawn unless headless
+    int framesDrawn() const { return m_framesDrawn; }
+
+public slots:
+    void toggleClippingMode();
+    void saveClip();
+
+signals:
+    // The window was closed
+    void closed();
+
+private slots:
+    void onProcessStarted(const QString &exeName);
+    void onProcessStopped(const QString &exeName);
+    void onRecordingFinished(bool success, const QString &filename);
+
+private:
+    enum ClippingState
+    {
+        DISABLED,
+        AWAITING_GAME,
+        ACTIVE
+    };
+
+    void startProcessMonitor();
+    void stopProcessMonitor();
+    void updateStatus();
+    void requestFrame();
+    void poll();
+    void frame();
+    void layout();
+
+    static void onWindowRefresh(GLFWwindow *window);
+
+    // Rendering is on demand: input is polled at the fast rate only while
+    // the window is focused or under the cursor.
+    static constexpr int kActivePollMs = 33;
+    static constexpr int kIdlePollMs = 250;
+
+    ObsControlThread *m_obs;
+    bool m_headless;
+    QSet<QString> m_gameExes;
+    int m_clipLengthSeconds;
+
+    GLFWwindow *m_window = nullptr;
+    nk_context *m_nk = nullptr;
+    QTimer m_pollTimer;
+    bool m_framePending = false;
+    bool m_dirty = true;
+    int m_framesDrawn = 0;
+
+    ClippingState m_clippingState = DISABLED;
+    bool m_gameDetected = false;
+    QString m_currentDetectedGame;
+    bool m_saving = false;
+    ProcessMonitor *m_processMonitor = nullptr;
+    QThread *m_processMonitorThread = nullptr;
+
+    // Kept as UTF-8 so a frame doesn't convert or allocate
+    QByteArray m_statusLine;
+    QByteArray m_lastSaveLine;
+};
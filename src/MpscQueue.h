@@ -0,0 +1,92 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+// Unbounded lock-free multi-producer / single-consumer queue (Vyukov's intrusive
+// node design). push() is wait-free and safe from any thread; pop() must only
+// ever be called from one consumer thread at a time.
+template <typename T>
+class MpscQueue
+{
+public:
+    MpscQueue() : m_head(&m_stub), m_tail(&m_stub)
+    {
+        m_stub.next.store(nullptr, std::memory_order_relaxed);
+    }
+
+    ~MpscQueue()
+    {
+        T value;
+        while (pop(value)) {
+        }
+    }
+
+    MpscQueue(const MpscQueue&) = delete;
+    MpscQueue& operator=(const MpscQueue&) = delete;
+
+    void push(T value)
+    {
+        pushNode(new Node(std::move(value)));
+    }
+
+    // Returns false if the queue is empty or a producer is half-way through a
+    // push; in the latter case the element becomes visible on the next call.
+    bool pop(T& out)
+    {
+        Node* tail = m_tail;
+        Node* next = tail->next.load(std::memory_order_acquire);
+
+        if (tail == &m_stub) {
+            if (!next) {
+                return false;
+            }
+            m_tail = next;
+            tail = next;
+            next = next->next.load(std::memory_order_acquire);
+        }
+
+        if (next) {
+            m_tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+
+        if (tail != m_head.load(std::memory_order_acquire)) {
+            return false;
+        }
+
+        // Only one node left: re-insert the stub so the last real node can be released.
+        pushNode(&m_stub);
+        next = tail->next.load(std::memory_order_acquire);
+        if (next) {
+            m_tail = next;
+            out = std::move(tail->value);
+            delete tail;
+            return true;
+        }
+        return false;
+    }
+
+private:
+    struct Node
+    {
+        Node() = default;
+        explicit Node(T&& v) : value(std::move(v)) {}
+
+        std::atomic<Node*> next{nullptr};
+        T value{};
+    };
+
+    void pushNode(Node* node)
+    {
+        node->next.store(nullptr, std::memory_order_relaxed);
+        Node* prev = m_head.exchange(node, std::memory_order_acq_rel);
+        prev->next.store(node, std::memory_order_release);
+    }
+
+    Node m_stub;
+    std::atomic<Node*> m_head; // producers
+    Node* m_tail;              // consumer only
+};
@@ -0,0 +1,277 @@
+#include "NoiseSuppressionCalibrator.h"
+#include "Logger.h"
+#include <obs.h>
+#include <QtConcurrent/QtConcurrent>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
+
+namespace
+{
+constexpr const char *kSourceId = "obsrc_calibration_source";
+constexpr int kBlockMs = 10;
+constexpr int kWarmupMs = 500;      // Fed in real time, so a new method (and NVIDIA's model) can settle
+constexpr int kMeasureBlocks = 500; // 5 s of audio, fed as fast as it goes through
+
+quint64 nowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+const char *sourceName(void *)
+{
+    return "Calibration Source";
+}
+
+void *sourceCreate(obs_data_t *, obs_source_t *source)
+{
+    return source;
+}
+
+void sourceDestroy(void *)
+{
+}
+
+void registerSource()
+{
+    static bool registered = false;
+    if (registered)
+        return;
+
+    // Audio is only ever pushed into it with obs_source_output_audio(), which
+    // runs the filter chain on the calling thread
+    obs_source_info info = {};
+    info.id = kSourceId;
+    info.type = OBS_SOURCE_TYPE_INPUT;
+    info.output_flags = OBS_SOURCE_AUDIO | OBS_SOURCE_CAP_DISABLED;
+    info.get_name = sourceName;
+    info.create = sourceCreate;
+    info.destroy = sourceDestroy;
+    obs_register_source(&info);
+    registered = true;
+}
+
+int qualityRank(const QString &method)
+{
+    if (method == "nvafx_denoiser")
+        return 0;
+    if (method == "rnnoise")
+        return 1;
+    return 2; // speex
+}
+
+// Planar float blocks of a 220 Hz tone under white noise, with one block's
+// samples the same on every channel
+class SyntheticAudio
+{
+public:
+    SyntheticAudio(uint32_t sampleRate, speaker_layout speakers)
+        : m_sampleRate(sampleRate), m_speakers(speakers),
+          m_frames(sampleRate * kBlockMs / 1000), m_samples(m_frames)
+    {
+    }
+
+    uint32_t frames() const { return m_frames; }
+
+    void push(obs_source_t *source)
+    {
+        for (uint32_t i = 0; i < m_frames; ++i, ++m_position)
+        {
+            m_noise = m_noise * 1664525u + 1013904223u;
+            const float noise = static_cast<float>(m_noise >> 8) / 16777216.0f - 0.5f;
+            const float tone = static_cast<float>(std::sin(2.0 * std::numbers::pi * 220.0 * m_position / m_sampleRate));
+            m_samples[i] = 0.3f * tone + 0.1f * noise;
+        }
+
+        obs_source_audio audio = {};
+        const int channels = get_audio_channels(m_speakers);
+        for (int channel = 0; channel < channels && channel < MAX_AV_PLANES; ++channel)
+            audio.data[channel] = reinterpret_cast<const uint8_t *>(m_samples.data());
+        audio.frames = m_frames;
+        audio.speakers = m_speakers;
+        audio.format = AUDIO_FORMAT_FLOAT_PLANAR;
+        audio.samples_per_sec = m_sampleRate;
+        audio.timestamp = nowNs();
+        obs_source_output_audio(source, &audio);
+    }
+
+private:
+    uint32_t m_sampleRate;
+    speaker_layout m_speakers;
+    uint32_t m_frames;
+    std::vector<float> m_samples;
+    uint64_t m_position = 0;
+    uint32_t m_noise = 1;
+};
+} // namespace
+
+NoiseSuppressionCalibrator::NoiseSuppressionCalibrator(QObject *parent)
+    : QObject(parent)
+{
+}
+
+NoiseSuppressionCalibrator::~NoiseSuppressionCalibrator()
+{
+    cancel();
+}
+
+QStringList NoiseSuppressionCalibrator::availableMethods()
+{
+    QStringList methods;
+    obs_properties_t *properties = obs_get_source_properties("noise_suppress_filter");
+    if (!properties)
+        return methods;
+
+    // Unavailable methods (e.g. NVIDIA's without a supported GPU) are listed but disabled
+    if (obs_property_t *method = obs_properties_get(properties, "method"))
+    {
+        const size_t count = obs_property_list_item_count(method);
+        for (size_t i = 0; i < count; ++i)
+        {
+            if (!obs_property_list_item_disabled(method, i))
+                methods.append(QString::fromUtf8(obs_property_list_item_string(method, i)));
+        }
+    }
+    obs_properties_destroy(properties);
+
+    std::stable_sort(methods.begin(), methods.end(), [](const QString &a, const QString &b)
+                     { return qualityRank(a) < qualityRank(b); });
+    return methods;
+}
+
+bool NoiseSuppressionCalibrator::start()
+{
+    cancel();
+
+    const QStringList methods = availableMethods();
+    if (methods.isEmpty())
+        return false;
+
+    registerSource();
+    LOG_INFO("Calibrating noise suppression: %1", methods.join(", "));
+    m_cancelled = false;
+    m_watcher = new QFutureWatcher<std::vector<Result>>(this);
+    connect(m_watcher, &QFutureWatcher<std::vector<Result>>::finished, this, [this]()
+            {
+        const std::vector<Result> results = m_watcher->result();
+        m_watcher->deleteLater();
+        m_watcher = nullptr;
+        complete(results); });
+    m_watcher->setFuture(QtConcurrent::run([this, methods]()
+                                           { return benchmark(methods, m_cancelled); }));
+    return true;
+}
+
+void NoiseSuppressionCalibrator::cancel()
+{
+    if (!m_watcher)
+        return;
+
+    m_cancelled = true;
+    m_watcher->disconnect(this);
+    m_watcher->waitForFinished();
+    m_watcher->deleteLater();
+    m_watcher = nullptr;
+}
+
+// Worker thread. The first result is the baseline (no filter), then one per method.
+std::vector<NoiseSuppressionCalibrator::Result> NoiseSuppressionCalibrator::benchmark(const QStringList &methods, const std::atomic<bool> &cancelled)
+{
+    std::vector<Result> results;
+    obs_audio_info info = {};
+    if (!obs_get_audio_info(&info))
+        return results;
+
+    obs_source_t *source = obs_source_create_private(kSourceId, "Calibration Source", nullptr);
+    if (!source)
+        return results;
+
+    SyntheticAudio audio(info.samples_per_sec, info.speakers);
+    const double blockNs = audio.frames() * 1e9 / info.samples_per_sec;
+
+    for (int step = 0; step <= methods.size() && !cancelled; ++step)
+    {
+        Result result;
+        obs_source_t *filter = nullptr;
+        if (step > 0)
+        {
+            result.method = methods.at(step - 1);
+            obs_data_t *settings = obs_data_create();
+            obs_data_set_string(settings, "method", result.method.toUtf8().constData());
+            filter = obs_source_create_private("noise_suppress_filter", "Calibration Suppression", settings);
+            obs_data_release(settings);
+            if (!filter)
+            {
+                results.push_back(result);
+                continue;
+            }
+            obs_source_filter_add(source, filter);
+        }
+
+        for (int elapsedMs = 0; elapsedMs < kWarmupMs && !cancelled; elapsedMs += kBlockMs)
+        {
+            audio.push(source);
+            std::this_thread::sleep_for(std::chrono::milliseconds(kBlockMs));
+        }
+
+        quint64 spentNs = 0;
+        int blocks = 0;
+        for (; blocks < kMeasureBlocks && !cancelled; ++blocks)
+        {
+            const quint64 before = nowNs();
+            audio.push(source);
+            spentNs += nowNs() - before;
+        }
+        if (blocks == kMeasureBlocks)
+            result.cpuShare = spentNs / (blocks * blockNs);
+
+        if (filter)
+        {
+            obs_source_filter_remove(source, filter);
+            obs_source_release(filter);
+        }
+        results.push_back(result);
+    }
+
+    obs_source_release(source);
+    return results;
+}
+
+void NoiseSuppressionCalibrator::complete(const std::vector<Result> &measured)
+{
+    if (measured.empty())
+    {
+        LOG_WARN("Noise suppression calibration couldn't run");
+        emit finished(QString());
+        return;
+    }
+
+    // The rest are in quality order
+    const double baselineShare = std::max(0.0, measured.front().cpuShare);
+    QString chosen;
+    const Result *cheapest = nullptr;
+    std::vector<Result> results(measured.begin() + 1, measured.end());
+    for (Result &result : results)
+    {
+        if (result.cpuShare < 0.0)
+        {
+            LOG_INFO("Noise suppression %1: couldn't be measured", result.method);
+            continue;
+        }
+        result.cpuShare = std::max(0.0, result.cpuShare - baselineShare);
+        LOG_INFO("Noise suppression %1: %2% of a core", result.method, result.cpuShare * 100.0);
+        if (chosen.isEmpty() && result.cpuShare <= kCpuBudget)
+            chosen = result.method;
+        if (!cheapest || result.cpuShare < cheapest->cpuShare)
+            cheapest = &result;
+    }
+    if (chosen.isEmpty() && cheapest)
+        chosen = cheapest->method;
+
+    LOG_INFO("Noise suppression calibrated, using %1", chosen.isEmpty() ? QString("default") : chosen);
+    emit finished(chosen);
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QFutureWatcher>
+#include <QObject>
+#include <QString>
+#include <QStringList>
+#include <atomic>
+#include <vector>
+
+// Picks a noise_suppress_filter method by measuring what each one actually
+// costs. The benchmark runs on a worker thread against a private source fed
+// synthetic audio (a tone under noise): each available method gets its own
+// private filter on that source, and the time spent pushing audio through it
+// is compared with a baseline without one. The microphone and its filter are
+// never touched, so calibration can run while the buffer records. The
+// best-sounding method whose cost stays within the CPU budget wins, or the
+// cheapest if none does.
+class NoiseSuppressionCalibrator : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Share of one core the suppression filter may use
+    static constexpr double kCpuBudget = 0.02;
+
+    explicit NoiseSuppressionCalibrator(QObject *parent = nullptr);
+    ~NoiseSuppressionCalibrator();
+
+    // Methods the loaded obs-filters module offers, best quality first
+    static QStringList availableMethods();
+
+    // OBS control thread, with OBS audio initialized
+    bool start();
+    // Waits for the worker to notice, which takes at most one block
+    void cancel();
+    bool isRunning() const { return m_watcher != nullptr; }
+
+signals:
+    // Not emitted when cancelled. method is empty if nothing could be measured.
+    void finished(const QString &method);
+
+private:
+    struct Result
+    {
+        QString method;
+        double cpuShare = -1.0; // Of one core, < 0 if it couldn't be measured
+    };
+
+    static std::vector<Result> benchmark(const QStringList &methods, const std::atomic<bool> &cancelled);
+    void complete(const std::vector<Result> &results);
+
+    QFutureWatcher<std::vector<Result>> *m_watcher = nullptr;
+    std::atomic<bool> m_cancelled{false};
+};
@@ -0,0 +1,40 @@
+#include "ObsControlThread.h"
+#include "GameCapture.h"
+#include "Logger.h"
+#include <QCoreApplication>
+#include <windows.h>
+#include <objbase.h>
+
+ObsControlThread::ObsControlThread(GameCapture *capture, QObject *parent)
+    : QObject(parent),
+      m_capture(capture)
+{
+    m_thread.setObjectName("ObsControl");
+
+    // Some plugins enumerate devices through COM on the calling thread, as
+    // they would on OBS's own UI thread
+    connect(&m_thread, &QThread::started, m_capture, [this]()
+            {
+        const HRESULT hr = CoInitializeEx(NULL, COINIT_APARTMENTTHREADED);
+        m_comInitialized = SUCCEEDED(hr);
+        if (FAILED(hr))
+            LOG_WARN("OBS control thread: CoInitializeEx failed (0x%1)", QString::number(static_cast<quint32>(hr), 16)); }, Qt::DirectConnection);
+
+    m_capture->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+ObsControlThread::~ObsControlThread()
+{
+    QThread *home = thread();
+    submit([this, home](GameCapture &capture)
+           {
+        capture.Shutdown();
+        if (m_comInitialized)
+            CoUninitialize();
+        capture.moveToThread(home); })
+        .waitForFinished();
+
+    m_thread.quit();
+    m_thread.wait();
+}
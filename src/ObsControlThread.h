@@ -0,0 +1,62 @@
+#pragma once
+
+#include <QFuture>
+#include <QObject>
+#include <QPromise>
+#include <QThread>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+class GameCapture;
+
+// The one thread that talks to libobs. GameCapture lives on it, so its
+// timers, OBS signal hand-offs and every obs_* call it makes run there, and
+// starting the buffer or resetting video never stalls the UI. Other threads
+// don't call GameCapture directly: they submit commands, which run one at a
+// time in submission order, and get a QFuture for the result. GameCapture's
+// own signals reach the UI as queued connections.
+class ObsControlThread : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Moves the capture to the new thread, which owns it from then on
+    explicit ObsControlThread(GameCapture *capture, QObject *parent = nullptr);
+    // Shuts the capture down on its thread, then hands it back to the
+    // thread that created it for deletion
+    ~ObsControlThread();
+
+    // For connecting to its signals and its thread-safe getters
+    GameCapture *capture() const { return m_capture; }
+
+    template <typename Command>
+    auto submit(Command command) -> QFuture<std::invoke_result_t<Command, GameCapture &>>
+    {
+        using Result = std::invoke_result_t<Command, GameCapture &>;
+        auto promise = std::make_shared<QPromise<Result>>();
+        QFuture<Result> future = promise->future();
+        promise->start();
+        QMetaObject::invokeMethod(m_capture, [capture = m_capture, promise, command = std::move(command)]() mutable
+                                  {
+            if constexpr (std::is_void_v<Result>)
+                command(*capture);
+            else
+                promise->addResult(command(*capture));
+            promise->finish(); }, Qt::QueuedConnection);
+        return future;
+    }
+
+    // A command nobody waits for
+    template <typename Command>
+    void post(Command command)
+    {
+        QMetaObject::invokeMethod(m_capture, [capture = m_capture, command = std::move(command)]() mutable
+                                  { command(*capture); }, Qt::QueuedConnection);
+    }
+
+private:
+    QThread m_thread;
+    GameCapture *m_capture;
+    bool m_comInitialized = false; // Only touched on m_thread
+};
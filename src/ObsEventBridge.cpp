@@ -0,0 +1,89 @@
+#include "ObsEventBridge.h"
+#include "Logger.h"
+#include <cstring>
+
+bool ObsEventBridge::m_statsLogging = false;
+
+void ObsEventBridge::setStatsLogging(bool enabled)
+{
+    m_statsLogging = enabled;
+}
+
+ObsEventBridge::ObsEventBridge(QObject *parent)
+    : QObject(parent)
+{
+    m_statsWindow.start();
+}
+
+quint64 ObsEventBridge::addReceiver(Receiver receiver)
+{
+    const quint64 id = m_nextReceiver++;
+    m_receivers.emplace(id, std::move(receiver));
+    return id;
+}
+
+void ObsEventBridge::removeReceiver(quint64 receiver)
+{
+    m_receivers.erase(receiver);
+}
+
+bool ObsEventBridge::post(quint64 receiver, const char *text)
+{
+    Event event;
+    event.receiver = receiver;
+    event.truncated = false;
+    event.text[0] = '\0';
+    if (text)
+    {
+        const size_t length = std::strlen(text);
+        if (length < sizeof(event.text))
+            std::memcpy(event.text, text, length + 1);
+        else
+            event.truncated = true;
+    }
+
+    if (!m_ring.tryPush(event))
+    {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        LOG_WARN_LIMITED(5000, "OBS event bridge full, dropping an event");
+        return false;
+    }
+    m_posted.fetch_add(1, std::memory_order_relaxed);
+
+    // Already woken: the pending drain picks this one up too
+    if (!m_wakePending.exchange(true, std::memory_order_acq_rel))
+    {
+        m_wakes.fetch_add(1, std::memory_order_relaxed);
+        QMetaObject::invokeMethod(this, &ObsEventBridge::drain, Qt::QueuedConnection);
+    }
+    return true;
+}
+
+void ObsEventBridge::drain()
+{
+    // Cleared first: anything pushed from here on wakes us again
+    m_wakePending.store(false, std::memory_order_release);
+
+    Event event;
+    while (m_ring.tryPop(event))
+    {
+        ++m_delivered;
+        const auto it = m_receivers.find(event.receiver);
+        if (it != m_receivers.end())
+            it->second(event);
+    }
+
+    if (m_statsLogging && m_statsWindow.elapsed() >= kStatsIntervalMs)
+        logStats();
+}
+
+void ObsEventBridge::logStats()
+{
+    const double seconds = m_statsWindow.restart() / 1000.0;
+    const quint64 posted = m_posted.exchange(0, std::memory_order_relaxed);
+    const quint64 wakes = m_wakes.exchange(0, std::memory_order_relaxed);
+    const quint64 dropped = m_dropped.exchange(0, std::memory_order_relaxed);
+    LOG_INFO("OBS event bridge: %1 events/s, %2 wake-ups (allocations)/s, %3 delivered, %4 dropped",
+              posted / seconds, wakes / seconds, m_delivered, dropped);
+    m_delivered = 0;
+}
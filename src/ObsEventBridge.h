@@ -0,0 +1,66 @@
+#pragma once
+
+#include "EventRing.h"
+#include <QElapsedTimer>
+#include <QObject>
+#include <atomic>
+#include <functional>
+#include <unordered_map>
+
+// Carries events from OBS's callback threads (output signals and the like)
+// to the thread this object lives on. Events go into a preallocated ring, so
+// a callback never allocates; only the first event after a drain posts a
+// wake-up to the event loop, and everything queued by then is handed out in
+// one pass. Continuous data such as audio levels doesn't come through here:
+// MeterBank keeps the latest value per channel for the UI to read per frame.
+class ObsEventBridge : public QObject
+{
+    Q_OBJECT
+
+public:
+    // UTF-8, including the terminator. Longer text arrives empty and flagged.
+    static constexpr int kTextSize = 1024;
+
+    struct Event
+    {
+        quint64 receiver;
+        bool truncated;
+        char text[kTextSize];
+    };
+    using Receiver = std::function<void(const Event &event)>;
+
+    explicit ObsEventBridge(QObject *parent = nullptr);
+
+    // Logs the steady-state cost once a minute, at info level so release
+    // builds keep it. Off by default; set before the bridge is created.
+    static void setStatsLogging(bool enabled);
+
+    // This object's thread. Events for a removed receiver are dropped.
+    quint64 addReceiver(Receiver receiver);
+    void removeReceiver(quint64 receiver);
+
+    // Any thread. Returns false if the ring is full.
+    bool post(quint64 receiver, const char *text = nullptr);
+
+private:
+    void drain();
+    void logStats();
+
+    static constexpr int kCapacity = 64;
+    static constexpr qint64 kStatsIntervalMs = 60000;
+
+    EventRing<Event, kCapacity> m_ring;
+    static bool m_statsLogging;
+
+    std::atomic<bool> m_wakePending{false};
+    std::unordered_map<quint64, Receiver> m_receivers;
+    quint64 m_nextReceiver = 1;
+
+    // Steady-state cost, logged once per interval when enabled. A wake-up is
+    // one queued call, which is the only allocation on the way.
+    std::atomic<quint64> m_posted{0};
+    std::atomic<quint64> m_dropped{0};
+    std::atomic<quint64> m_wakes{0};
+    quint64 m_delivered = 0;
+    QElapsedTimer m_statsWindow;
+};
@@ -0,0 +1,97 @@
+#include "ObsTask.h"
+#include "ObsEventBridge.h"
+#include <QTimer>
+#include <obs.h>
+#include <callback/signal.h>
+#include <algorithm>
+
+using ObsTaskDetail::WaitState;
+
+void CancelScope::add(const std::shared_ptr<WaitState> &state)
+{
+    m_waits.erase(std::remove_if(m_waits.begin(), m_waits.end(), [](const std::weak_ptr<WaitState> &wait)
+                                 {
+                                     const auto state = wait.lock();
+                                     return !state || state->result.has_value(); }),
+                  m_waits.end());
+    m_waits.push_back(state);
+}
+
+void CancelScope::cancel()
+{
+    // Resumed tasks may register new waits; those aren't cancelled
+    const auto waits = std::move(m_waits);
+    m_waits.clear();
+    for (const std::weak_ptr<WaitState> &wait : waits)
+    {
+        if (const auto state = wait.lock())
+            state->finish(WaitResult::Cancelled);
+    }
+}
+
+OutputSignal::OutputSignal(ObsEventBridge *events, obs_output_t *output, const char *signal, int timeoutMs,
+                           CancelScope *scope, ArgumentReader argument)
+    : m_events(events),
+      m_output(output),
+      m_signal(signal),
+      m_argumentReader(argument),
+      m_state(std::make_shared<WaitState>())
+{
+    m_state->started.start();
+    signal_handler_t *handler = output ? obs_output_get_signal_handler(output) : nullptr;
+    if (!handler)
+    {
+        m_output = nullptr;
+        m_state->finish(WaitResult::Cancelled);
+        return;
+    }
+    std::weak_ptr<WaitState> state = m_state;
+    m_receiver = m_events->addReceiver([state](const ObsEventBridge::Event &event)
+                                       {
+        const auto waiting = state.lock();
+        if (!waiting || waiting->result)
+            return;
+        // A path too long for an event arrives empty; callers handle a missing argument
+        waiting->argument = QString::fromUtf8(event.text);
+        waiting->finish(WaitResult::Completed); });
+    signal_handler_connect(handler, m_signal, &OutputSignal::callback, this);
+
+    QTimer::singleShot(timeoutMs, m_events, [state]()
+                       {
+        if (const auto waiting = state.lock())
+            waiting->finish(WaitResult::TimedOut); });
+    if (scope)
+        scope->add(m_state);
+}
+
+OutputSignal::~OutputSignal()
+{
+    // Once this returns the callback is neither running nor called again,
+    // and an event it already posted is dropped
+    if (m_output)
+    {
+        signal_handler_disconnect(obs_output_get_signal_handler(m_output), m_signal, &OutputSignal::callback, this);
+        m_events->removeReceiver(m_receiver);
+    }
+}
+
+void OutputSignal::callback(void *data, calldata_t *params)
+{
+    // Emitting thread: read what's needed and hand over to the bridge's thread
+    const OutputSignal *self = static_cast<const OutputSignal *>(data);
+    const char *argument = self->m_argumentReader && params ? self->m_argumentReader(params) : nullptr;
+    self->m_events->post(self->m_receiver, argument);
+}
+
+Delay::Delay(QObject *context, int ms, CancelScope *scope)
+    : m_state(std::make_shared<WaitState>())
+{
+    m_state->started.start();
+    std::weak_ptr<WaitState> state = m_state;
+    QTimer::singleShot(ms, context, [state]()
+                       {
+        if (const auto waiting = state.lock())
+            waiting->finish(WaitResult::Completed); });
+    if (scope)
+        scope->add(m_state);
+}
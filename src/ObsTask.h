@@ -0,0 +1,216 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QString>
+#include <coroutine>
+#include <exception>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+struct obs_output;
+struct calldata;
+typedef struct obs_output obs_output_t;
+typedef struct calldata calldata_t;
+class ObsEventBridge;
+
+// Coroutines for GameCapture's multi-step OBS operations: stop an output and
+// wait for it, start it again, wait for a save. A Task runs on the OBS
+// control thread as soon as it's called, up to its first co_await, and every
+// awaitable here resumes it through that thread's event loop, so nothing
+// blocks while it waits and no locking is needed.
+//
+// A Task can be co_awaited by another task or simply dropped, in which case
+// it runs to completion on its own.
+template <typename T = void>
+class Task;
+
+// How a wait ended
+enum class WaitResult
+{
+    Completed,
+    TimedOut,
+    Cancelled
+};
+
+namespace ObsTaskDetail
+{
+struct WaitState
+{
+    std::coroutine_handle<> waiting;
+    std::optional<WaitResult> result;
+    QString argument;
+    QElapsedTimer started;
+    qint64 waitedMs = 0;
+
+    // Only the first call counts
+    void finish(WaitResult how)
+    {
+        if (result)
+            return;
+        result = how;
+        waitedMs = started.elapsed();
+        if (waiting)
+            std::exchange(waiting, {}).resume();
+    }
+};
+
+struct PromiseBase
+{
+    std::coroutine_handle<> continuation;
+    std::exception_ptr exception;
+    bool detached = false; // The Task was dropped before finishing
+
+    std::suspend_never initial_suspend() noexcept { return {}; }
+    void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+    struct FinalAwaiter
+    {
+        bool await_ready() const noexcept { return false; }
+        template <typename Promise>
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) noexcept
+        {
+            PromiseBase &promise = handle.promise();
+            if (promise.detached)
+            {
+                // Nobody will read the result; an exception would be lost
+                if (promise.exception)
+                    std::terminate();
+                handle.destroy();
+                return std::noop_coroutine();
+            }
+            return promise.continuation ? promise.continuation : std::noop_coroutine();
+        }
+        void await_resume() const noexcept {}
+    };
+    FinalAwaiter final_suspend() noexcept { return {}; }
+};
+
+template <typename T>
+struct Promise : PromiseBase
+{
+    std::optional<T> value;
+
+    void return_value(T result) { value = std::move(result); }
+    T result()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+        return std::move(*value);
+    }
+};
+
+template <>
+struct Promise<void> : PromiseBase
+{
+    void return_void() {}
+    void result()
+    {
+        if (exception)
+            std::rethrow_exception(exception);
+    }
+};
+} // namespace ObsTaskDetail
+
+template <typename T>
+class Task
+{
+public:
+    struct promise_type : ObsTaskDetail::Promise<T>
+    {
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+    Task(Task &&other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+    Task(const Task &) = delete;
+    Task &operator=(const Task &) = delete;
+    Task &operator=(Task &&) = delete;
+    ~Task()
+    {
+        if (!m_handle)
+            return;
+        if (m_handle.done())
+            m_handle.destroy();
+        else
+            m_handle.promise().detached = true; // It frees itself when done
+    }
+
+    bool isDone() const { return !m_handle || m_handle.done(); }
+
+    bool await_ready() const noexcept { return m_handle.done(); }
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept { m_handle.promise().continuation = awaiting; }
+    T await_resume() { return m_handle.promise().result(); }
+
+private:
+    explicit Task(std::coroutine_handle<promise_type> handle) : m_handle(handle) {}
+
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+// Ends every wait registered with it, right away and in order, with
+// WaitResult::Cancelled. Used to abandon whatever a clipping session still
+// has pending when the session ends.
+class CancelScope
+{
+public:
+    void cancel();
+
+private:
+    friend class OutputSignal;
+    friend class Delay;
+    void add(const std::shared_ptr<ObsTaskDetail::WaitState> &state);
+
+    std::vector<std::weak_ptr<ObsTaskDetail::WaitState>> m_waits;
+};
+
+// Waits for a libobs signal on an output ("stop", "saved", ...), for at most
+// timeoutMs. Construct it before whatever makes the output emit, then
+// co_await it. The output must outlive it. The signal is delivered through
+// events, so the task resumes on the bridge's thread.
+class OutputSignal
+{
+public:
+    // argument picks what to keep from the signal's calldata, read on the
+    // emitting thread; it's returned by argument() once the wait completed
+    using ArgumentReader = const char *(*)(calldata_t *data);
+
+    OutputSignal(ObsEventBridge *events, obs_output_t *output, const char *signal, int timeoutMs,
+                 CancelScope *scope = nullptr, ArgumentReader argument = nullptr);
+    ~OutputSignal();
+    OutputSignal(const OutputSignal &) = delete;
+    OutputSignal &operator=(const OutputSignal &) = delete;
+
+    bool await_ready() const noexcept { return m_state->result.has_value(); }
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept { m_state->waiting = awaiting; }
+    WaitResult await_resume() const noexcept { return *m_state->result; }
+
+    QString argument() const { return m_state->argument; }
+    // From construction to the end of the wait
+    qint64 elapsedMs() const { return m_state->waitedMs; }
+
+private:
+    static void callback(void *data, calldata_t *params);
+
+    ObsEventBridge *m_events;
+    quint64 m_receiver = 0;
+    obs_output_t *m_output;
+    const char *m_signal;
+    ArgumentReader m_argumentReader;
+    std::shared_ptr<ObsTaskDetail::WaitState> m_state;
+};
+
+// co_await Delay(this, 500) resumes after half a second on context's thread
+class Delay
+{
+public:
+    Delay(QObject *context, int ms, CancelScope *scope = nullptr);
+
+    bool await_ready() const noexcept { return m_state->result.has_value(); }
+    void await_suspend(std::coroutine_handle<> awaiting) noexcept { m_state->waiting = awaiting; }
+    WaitResult await_resume() const noexcept { return *m_state->result; }
+
+private:
+    std::shared_ptr<ObsTaskDetail::WaitState> m_state;
+};
@@ -1,4 +1,5 @@
 #include "ProcessMonitor.h"
+#include "Trace.h"
 #include <QDebug>
 #include <QThread>
 #include <Windows.h>
@@ -73,6 +74,7 @@ public:
     // This is the callback that WMI will call with event information.
     virtual HRESULT STDMETHODCALLTYPE Indicate(long lObjectCount, IWbemClassObject **apObjArray)
     {
+        TRACE_SCOPE("ProcessMonitor::Indicate");
         for (long i = 0; i < lObjectCount; i++)
         {
             IWbemClassObject *pObj = apObjArray[i];
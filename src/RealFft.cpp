@@ -0,0 +1,85 @@
+#include "RealFft.h"
+#include <cmath>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+
+// Plain complex multiply; std::complex's operator* carries NaN/Inf recovery
+// that keeps it out of line on some compilers.
+inline std::complex<float> mul(const std::complex<float> &a, const std::complex<float> &b)
+{
+    return std::complex<float>(a.real() * b.real() - a.imag() * b.imag(),
+                               a.real() * b.imag() + a.imag() * b.real());
+}
+
+inline float magnitude(const std::complex<float> &z)
+{
+    return std::sqrt(z.real() * z.real() + z.imag() * z.imag());
+}
+}
+
+RealFft::RealFft(int size)
+    : m_size(size),
+      m_half(size / 2),
+      m_bitReverse(size / 2),
+      m_twiddles(size / 4),
+      m_splitTwiddles(size / 2),
+      m_work(size / 2)
+{
+    int bits = 0;
+    while ((1 << bits) < m_half) {
+        ++bits;
+    }
+    for (int i = 0; i < m_half; ++i) {
+        int reversed = 0;
+        for (int b = 0; b < bits; ++b) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    for (int k = 0; k < m_half / 2; ++k) {
+        const double angle = -2.0 * kPi * k / m_half;
+        m_twiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+    for (int k = 0; k < m_half; ++k) {
+        const double angle = -2.0 * kPi * k / m_size;
+        m_splitTwiddles[k] = std::complex<float>(static_cast<float>(std::cos(angle)), static_cast<float>(std::sin(angle)));
+    }
+}
+
+void RealFft::magnitudes(const float *input, float *output)
+{
+    // Pack even/odd samples as real/imaginary parts, in bit-reversed order.
+    for (int i = 0; i < m_half; ++i) {
+        m_work[m_bitReverse[i]] = std::complex<float>(input[2 * i], input[2 * i + 1]);
+    }
+
+    // Iterative radix-2 butterflies. The inner loop runs over contiguous
+    // memory with a constant twiddle stride, which the compiler can vectorize.
+    for (int length = 2; length <= m_half; length <<= 1) {
+        const int halfLength = length >> 1;
+        const int stride = m_half / length;
+        for (int start = 0; start < m_half; start += length) {
+            std::complex<float> *a = &m_work[start];
+            std::complex<float> *b = a + halfLength;
+            for (int j = 0; j < halfLength; ++j) {
+                const std::complex<float> t = mul(b[j], m_twiddles[j * stride]);
+                b[j] = a[j] - t;
+                a[j] = a[j] + t;
+            }
+        }
+    }
+
+    // Split the packed result into the spectrum of the real input:
+    // X[k] = (Z[k] + Z*[N/2-k]) / 2 - i/2 * W^k * (Z[k] - Z*[N/2-k])
+    output[0] = std::abs(m_work[0].real() + m_work[0].imag());
+    for (int k = 1; k < m_half; ++k) {
+        const std::complex<float> z = m_work[k];
+        const std::complex<float> zc = std::conj(m_work[m_half - k]);
+        const std::complex<float> even = 0.5f * (z + zc);
+        const std::complex<float> diff = z - zc;
+        const std::complex<float> odd(0.5f * diff.imag(), -0.5f * diff.real()); // -i/2 * diff
+        output[k] = magnitude(even + mul(m_splitTwiddles[k], odd));
+    }
+}
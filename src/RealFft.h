@@ -0,0 +1,28 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+// Power-of-two real-input FFT. The N real samples are packed into an N/2-point
+// complex FFT (iterative radix-2, precomputed twiddles and bit reversal) and
+// split into the N/2 bins of the real spectrum afterwards, so it does half
+// the work of a complex transform of the same length. No allocation after
+// construction; one instance per thread.
+class RealFft
+{
+public:
+    explicit RealFft(int size);
+
+    int size() const { return m_size; }
+
+    // Magnitudes |X[k]| for k = 0 .. size/2 - 1. input holds size() samples.
+    void magnitudes(const float *input, float *output);
+
+private:
+    int m_size;
+    int m_half;
+    std::vector<int> m_bitReverse;                 // m_half entries
+    std::vector<std::complex<float>> m_twiddles;   // e^(-2πik/half), k < half/2
+    std::vector<std::complex<float>> m_splitTwiddles; // e^(-2πik/size), k < half
+    std::vector<std::complex<float>> m_work;
+};
@@ -0,0 +1,178 @@
+#include "SettingsStore.h"
+#include "Logger.h"
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QSettings>
+#include <filesystem>
+#include <iterator>
+#include <system_error>
+
+namespace {
+// Quiet period before a write. Covers a slider drag or a burst of
+// handlers all saving the same state.
+constexpr auto kWriteDelay = std::chrono::milliseconds(750);
+}
+
+SettingsStore &SettingsStore::instance()
+{
+    static SettingsStore store;
+    return store;
+}
+
+SettingsStore::SettingsStore()
+{
+    QSettings settings(QSettings::IniFormat, QSettings::UserScope, "GameClipRecorder", "Settings");
+    m_fileName = settings.fileName();
+    for (const QString &key : settings.allKeys()) {
+        m_values.insert(key, settings.value(key));
+    }
+    m_writer = std::thread(&SettingsStore::writerLoop, this);
+}
+
+SettingsStore::~SettingsStore()
+{
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stopping = true;
+    }
+    m_changed.notify_one();
+    // The writer commits anything still pending before it exits
+    m_writer.join();
+}
+
+QVariant SettingsStore::value(const QString &key, const QVariant &defaultValue) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    return m_values.value(key, defaultValue);
+}
+
+void SettingsStore::setValue(const QString &key, const QVariant &value)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    auto it = m_values.find(key);
+    if (it != m_values.end() && *it == value) {
+        return;
+    }
+    m_values.insert(key, value);
+    markDirtyLocked();
+}
+
+void SettingsStore::remove(const QString &key)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_values.remove(key) > 0) {
+        markDirtyLocked();
+    }
+}
+
+QStringList SettingsStore::stringArray(const QString &array, const QString &field) const
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    QStringList values;
+    const int size = m_values.value(array + "/size").toInt();
+    for (int i = 1; i <= size; ++i) {
+        values.append(m_values.value(QString("%1/%2/%3").arg(array).arg(i).arg(field)).toString());
+    }
+    return values;
+}
+
+void SettingsStore::setStringArray(const QString &array, const QString &field, const QStringList &values)
+{
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_values.value(array + "/size").toInt() == values.size()) {
+        bool same = true;
+        for (int i = 0; i < values.size() && same; ++i) {
+            same = m_values.value(QString("%1/%2/%3").arg(array).arg(i + 1).arg(field)).toString() == values[i];
+        }
+        if (same) {
+            return;
+        }
+    }
+
+    // Same layout as QSettings::beginWriteArray: 1-based, plus a size key
+    const QString prefix = array + "/";
+    for (auto it = m_values.begin(); it != m_values.end();) {
+        it = it.key().startsWith(prefix) ? m_values.erase(it) : std::next(it);
+    }
+    for (int i = 0; i < values.size(); ++i) {
+        m_values.insert(QString("%1/%2/%3").arg(array).arg(i + 1).arg(field), values[i]);
+    }
+    m_values.insert(array + "/size", static_cast<int>(values.size()));
+    markDirtyLocked();
+}
+
+void SettingsStore::markDirtyLocked()
+{
+    ++m_generation;
+    m_lastChange = std::chrono::steady_clock::now();
+    m_changed.notify_one();
+}
+
+void SettingsStore::flush()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    const quint64 target = m_generation;
+    // Skip the quiet period for what's pending now
+    m_lastChange = std::chrono::steady_clock::time_point();
+    m_changed.notify_one();
+    m_written.wait(lock, [&]() { return m_writtenGeneration >= target; });
+}
+
+void SettingsStore::writerLoop()
+{
+    std::unique_lock<std::mutex> lock(m_mutex);
+    for (;;) {
+        m_changed.wait(lock, [&]() { return m_stopping || m_generation != m_writtenGeneration; });
+        if (m_generation == m_writtenGeneration) {
+            break; // Stopping with nothing pending
+        }
+
+        // Let further changes pile up until things go quiet
+        while (!m_stopping && std::chrono::steady_clock::now() - m_lastChange < kWriteDelay) {
+            m_changed.wait_until(lock, m_lastChange + kWriteDelay);
+        }
+
+        const QVariantMap snapshot = m_values;
+        const quint64 generation = m_generation;
+        lock.unlock();
+        const bool ok = commit(snapshot);
+        lock.lock();
+
+        // A failed write isn't retried until the next change; the map still
+        // holds everything, so that write will include it.
+        if (!ok) {
+            LOG_WARN("Couldn't write settings to %1", m_fileName);
+        }
+        m_writtenGeneration = generation;
+        m_written.notify_all();
+    }
+}
+
+bool SettingsStore::commit(const QVariantMap &values) const
+{
+    QDir().mkpath(QFileInfo(m_fileName).absolutePath());
+    const QString tempName = m_fileName + ".tmp";
+    QFile::remove(tempName);
+    {
+        QSettings out(tempName, QSettings::IniFormat);
+        for (auto it = values.cbegin(); it != values.cend(); ++it) {
+            out.setValue(it.key(), it.value());
+        }
+        out.sync();
+        if (out.status() != QSettings::NoError) {
+            QFile::remove(tempName);
+            return false;
+        }
+    }
+
+    // Replaces the old file in one step (MoveFileEx with REPLACE_EXISTING on Windows)
+    std::error_code error;
+    std::filesystem::rename(std::filesystem::path(tempName.toStdWString()),
+                            std::filesystem::path(m_fileName.toStdWString()), error);
+    if (error) {
+        QFile::remove(tempName);
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+#include <QVariantMap>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+// The application's settings, held in memory. Reads never touch the disk;
+// a write only changes the in-memory map (and nothing at all if the value is
+// unchanged). A background thread commits the whole map once changes have
+// settled for a moment, to a temp file that then replaces the INI, so a
+// slider drag costs no I/O and a crash mid-write can't truncate the file.
+// The file is the same one QSettings(IniFormat, UserScope) uses, and keys
+// keep their QSettings names, including arrays ("gameExes/1/exe").
+class SettingsStore
+{
+public:
+    static SettingsStore &instance();
+
+    QVariant value(const QString &key, const QVariant &defaultValue = QVariant()) const;
+    void setValue(const QString &key, const QVariant &value);
+    void remove(const QString &key);
+
+    // QSettings-style arrays of one field each, e.g. gameExes/<n>/exe
+    QStringList stringArray(const QString &array, const QString &field) const;
+    void setStringArray(const QString &array, const QString &field, const QStringList &values);
+
+    // Blocks until every change so far is on disk
+    void flush();
+    QString fileName() const { return m_fileName; }
+
+private:
+    SettingsStore();
+    ~SettingsStore();
+    SettingsStore(const SettingsStore &) = delete;
+    SettingsStore &operator=(const SettingsStore &) = delete;
+
+    void markDirtyLocked();
+    void writerLoop();
+    bool commit(const QVariantMap &values) const;
+
+    QString m_fileName;
+
+    mutable std::mutex m_mutex;
+    std::condition_variable m_changed;
+    std::condition_variable m_written;
+    QVariantMap m_values;
+    quint64 m_generation = 0;        // Bumped on every change
+    quint64 m_writtenGeneration = 0; // Last generation committed (or given up on)
+    std::chrono::steady_clock::time_point m_lastChange;
+    bool m_stopping = false;
+    std::thread m_writer;
+};
@@ -0,0 +1,156 @@
+#include "SpectrumAnalyzer.h"
+#include <obs.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace {
+constexpr double kPi = 3.14159265358979323846;
+
+quint64 nowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+}
+
+SpectrumAnalyzer::SpectrumAnalyzer()
+    : m_fft(kFftSize),
+      m_window(kFftSize),
+      m_history(kFftSize, 0.0f),
+      m_frame(kFftSize),
+      m_magnitudes(kFftSize / 2)
+{
+    // Hann window, pre-scaled so a full-scale sine reads 0 dBFS: the window's
+    // coherent gain is 1/2 and a real sine splits its energy over +/- f.
+    for (int i = 0; i < kFftSize; ++i) {
+        const double hann = 0.5 - 0.5 * std::cos(2.0 * kPi * i / (kFftSize - 1));
+        m_window[i] = static_cast<float>(hann * 4.0 / kFftSize);
+    }
+    resetBands();
+}
+
+SpectrumAnalyzer::~SpectrumAnalyzer()
+{
+    detach();
+}
+
+void SpectrumAnalyzer::attach(obs_source_t *source)
+{
+    detach();
+    if (!source) {
+        return;
+    }
+
+    obs_audio_info info = {};
+    const double sampleRate = obs_get_audio_info(&info) ? info.samples_per_sec : 48000.0;
+    const size_t channels = obs_get_audio() ? audio_output_get_channels(obs_get_audio()) : 2;
+    m_channels = std::max<int>(1, static_cast<int>(channels));
+
+    // Log-spaced bands between kLowestHz and min(kHighestHz, Nyquist). Low
+    // bands narrower than one bin still get a bin of their own.
+    const double binHz = sampleRate / kFftSize;
+    const double highest = std::min<double>(kHighestHz, sampleRate / 2.0);
+    int previous = 0;
+    for (int b = 0; b <= kBandCount; ++b) {
+        const double hz = kLowestHz * std::pow(highest / kLowestHz, static_cast<double>(b) / kBandCount);
+        int bin = static_cast<int>(std::lround(hz / binHz));
+        bin = std::clamp(bin, b == 0 ? 1 : previous + 1, kFftSize / 2);
+        m_bandEdges[b] = bin;
+        previous = bin;
+    }
+
+    std::fill(m_history.begin(), m_history.end(), 0.0f);
+    m_historyPos = 0;
+    m_sinceAnalysis = 0;
+    resetBands();
+
+    m_weakSource = obs_source_get_weak_source(source);
+    obs_source_add_audio_capture_callback(source, &SpectrumAnalyzer::audioCallback, this);
+}
+
+void SpectrumAnalyzer::detach()
+{
+    if (!m_weakSource) {
+        return;
+    }
+
+    // The source may already be gone (e.g. recreated after a device change);
+    // its callbacks went with it in that case.
+    if (obs_source_t *source = obs_weak_source_get_source(m_weakSource)) {
+        // Takes the source's callback mutex, so no callback is running once this returns.
+        obs_source_remove_audio_capture_callback(source, &SpectrumAnalyzer::audioCallback, this);
+        obs_source_release(source);
+    }
+    obs_weak_source_release(m_weakSource);
+    m_weakSource = nullptr;
+    resetBands();
+}
+
+void SpectrumAnalyzer::audioCallback(void *param, obs_source_t *, const audio_data *audio, bool muted)
+{
+    static_cast<SpectrumAnalyzer *>(param)->process(audio, muted);
+}
+
+void SpectrumAnalyzer::process(const audio_data *audio, bool muted)
+{
+    if (!audio) {
+        return;
+    }
+
+    // OBS hands capture callbacks float planar audio; mix it down to mono.
+    const float scale = 1.0f / m_channels;
+    for (uint32_t i = 0; i < audio->frames; ++i) {
+        float sample = 0.0f;
+        if (!muted) {
+            for (int c = 0; c < m_channels; ++c) {
+                if (audio->data[c]) {
+                    sample += reinterpret_cast<const float *>(audio->data[c])[i];
+                }
+            }
+            sample *= scale;
+        }
+
+        m_history[m_historyPos] = sample;
+        m_historyPos = (m_historyPos + 1) % kFftSize;
+        if (++m_sinceAnalysis >= kHopSize) {
+            m_sinceAnalysis = 0;
+            analyze();
+        }
+    }
+}
+
+void SpectrumAnalyzer::analyze()
+{
+    // Oldest sample first
+    for (int i = 0; i < kFftSize; ++i) {
+        m_frame[i] = m_history[(m_historyPos + i) % kFftSize] * m_window[i];
+    }
+    m_fft.magnitudes(m_frame.data(), m_magnitudes.data());
+
+    for (int b = 0; b < kBandCount; ++b) {
+        float peak = 0.0f;
+        for (int k = m_bandEdges[b]; k < m_bandEdges[b + 1] && k < kFftSize / 2; ++k) {
+            peak = std::max(peak, m_magnitudes[k]);
+        }
+        const float db = peak > 0.0f ? 20.0f * std::log10(peak) : kMinDb;
+        const float level = std::clamp((db - kMinDb) / -kMinDb, 0.0f, 1.0f);
+        m_bands[b].store(level, std::memory_order_relaxed);
+    }
+    m_lastAnalysisNs.store(nowNs(), std::memory_order_relaxed);
+}
+
+bool SpectrumAnalyzer::isLive() const
+{
+    const quint64 last = m_lastAnalysisNs.load(std::memory_order_relaxed);
+    return last != 0 && nowNs() - last < kStaleAfterNs;
+}
+
+void SpectrumAnalyzer::resetBands()
+{
+    for (auto &band : m_bands) {
+        band.store(0.0f, std::memory_order_relaxed);
+    }
+    m_lastAnalysisNs.store(0, std::memory_order_relaxed);
+}
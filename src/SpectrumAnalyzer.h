@@ -0,0 +1,69 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <vector>
+#include <QtGlobal>
+#include "RealFft.h"
+
+struct obs_source;
+typedef struct obs_source obs_source_t;
+struct obs_weak_source;
+typedef struct obs_weak_source obs_weak_source_t;
+struct audio_data;
+
+// Live spectrum of an OBS source. Raw PCM arrives through an audio capture
+// callback on the OBS audio thread, which runs a Hann-windowed real FFT every
+// kHopSize samples and publishes log-spaced band levels through atomics; the
+// GUI only ever reads those.
+class SpectrumAnalyzer
+{
+public:
+    static constexpr int kBandCount = 20;
+
+    SpectrumAnalyzer();
+    ~SpectrumAnalyzer();
+    SpectrumAnalyzer(const SpectrumAnalyzer &) = delete;
+    SpectrumAnalyzer &operator=(const SpectrumAnalyzer &) = delete;
+
+    // GUI thread. Attaching to a new source detaches from the previous one.
+    void attach(obs_source_t *source);
+    void detach();
+    bool isAttached() const { return m_weakSource != nullptr; }
+
+    // False once no audio has been analyzed for a while, e.g. because the
+    // source was released behind our back. Safe from any thread.
+    bool isLive() const;
+
+    // 0.0 (-60 dBFS or quieter) to 1.0 (0 dBFS). Safe from any thread.
+    float band(int index) const { return m_bands[index].load(std::memory_order_relaxed); }
+
+private:
+    static constexpr int kFftSize = 1024;
+    static constexpr int kHopSize = kFftSize / 2;
+    static constexpr float kMinDb = -60.0f;
+    static constexpr float kLowestHz = 40.0f;
+    static constexpr float kHighestHz = 16000.0f;
+    static constexpr quint64 kStaleAfterNs = 250000000; // 250 ms
+
+    static void audioCallback(void *param, obs_source_t *source, const audio_data *audio, bool muted);
+    void process(const audio_data *audio, bool muted);
+    void analyze();
+    void resetBands();
+
+    obs_weak_source_t *m_weakSource = nullptr;
+
+    // Audio thread only while attached
+    RealFft m_fft;
+    std::vector<float> m_window;
+    std::vector<float> m_history; // Ring of the last kFftSize mono samples
+    std::vector<float> m_frame;
+    std::vector<float> m_magnitudes;
+    int m_historyPos = 0;
+    int m_sinceAnalysis = 0;
+    int m_channels = 2;
+    std::array<int, kBandCount + 1> m_bandEdges{}; // FFT bin boundaries
+
+    std::array<std::atomic<float>, kBandCount> m_bands;
+    std::atomic<quint64> m_lastAnalysisNs{0};
+};
@@ -0,0 +1,157 @@
+#include "Trace.h"
+#include <QByteArray>
+#include <QSaveFile>
+#include <algorithm>
+#include <array>
+#include <vector>
+
+namespace Trace
+{
+std::atomic<bool> g_enabled{false};
+
+namespace
+{
+enum class Phase : char
+{
+    Complete = 'X',
+    AsyncBegin = 'b',
+    AsyncEnd = 'e'
+};
+
+// Fixed ring, written lock-free from any thread. A slot's sequence is zeroed
+// before and set after the other fields, so the exporter can skip slots that
+// are mid-write or were overwritten while it was reading.
+struct Event
+{
+    std::atomic<quint64> sequence{0};
+    const char *name = nullptr;
+    quint64 startNs = 0;
+    quint64 durationNs = 0;
+    quint64 id = 0;
+    quint32 threadId = 0;
+    Phase phase = Phase::Complete;
+};
+
+constexpr size_t kCapacity = 1 << 16;
+std::array<Event, kCapacity> g_events;
+std::atomic<quint64> g_nextSequence{0};
+std::atomic<quint32> g_nextThreadId{1};
+
+quint32 currentThreadId()
+{
+    thread_local const quint32 id = g_nextThreadId.fetch_add(1, std::memory_order_relaxed);
+    return id;
+}
+
+void record(Phase phase, const char *name, quint64 startNs, quint64 durationNs, quint64 id)
+{
+    const quint64 sequence = g_nextSequence.fetch_add(1, std::memory_order_relaxed) + 1;
+    Event &event = g_events[(sequence - 1) % kCapacity];
+
+    event.sequence.store(0, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    event.name = name;
+    event.startNs = startNs;
+    event.durationNs = durationNs;
+    event.id = id;
+    event.threadId = currentThreadId();
+    event.phase = phase;
+    event.sequence.store(sequence, std::memory_order_release);
+}
+
+QByteArray jsonString(const char *text)
+{
+    QByteArray out = "\"";
+    for (const char *p = text; *p; ++p)
+    {
+        if (*p == '"' || *p == '\\')
+            out += '\\';
+        out += *p;
+    }
+    out += '"';
+    return out;
+}
+} // namespace
+
+void setEnabled(bool enabled)
+{
+    g_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+void completeEvent(const char *name, quint64 startNs, quint64 endNs)
+{
+    record(Phase::Complete, name, startNs, endNs - startNs, 0);
+}
+
+void asyncBegin(const char *name, quint64 id)
+{
+    if (isEnabled())
+        record(Phase::AsyncBegin, name, nowNs(), 0, id);
+}
+
+void asyncEnd(const char *name, quint64 id)
+{
+    if (isEnabled())
+        record(Phase::AsyncEnd, name, nowNs(), 0, id);
+}
+
+int exportChromeJson(const QString &path, int seconds)
+{
+    struct Snapshot
+    {
+        quint64 sequence;
+        const char *name;
+        quint64 startNs;
+        quint64 durationNs;
+        quint64 id;
+        quint32 threadId;
+        Phase phase;
+    };
+
+    const quint64 now = nowNs();
+    const quint64 windowNs = static_cast<quint64>(seconds) * 1000000000ULL;
+    const quint64 cutoff = now > windowNs ? now - windowNs : 0;
+
+    std::vector<Snapshot> events;
+    events.reserve(kCapacity);
+    for (const Event &event : g_events)
+    {
+        const quint64 before = event.sequence.load(std::memory_order_acquire);
+        if (before == 0)
+            continue;
+        Snapshot s{before, event.name, event.startNs, event.durationNs, event.id, event.threadId, event.phase};
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (event.sequence.load(std::memory_order_relaxed) != before || !s.name)
+            continue;
+        if (s.startNs + s.durationNs < cutoff)
+            continue;
+        events.push_back(s);
+    }
+    std::sort(events.begin(), events.end(), [](const Snapshot &a, const Snapshot &b)
+              { return a.sequence < b.sequence; });
+
+    QByteArray json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (const Snapshot &s : events)
+    {
+        if (!first)
+            json += ",\n";
+        first = false;
+
+        // Chrome wants microseconds
+        json += "{\"name\":" + jsonString(s.name) + ",\"cat\":\"companion\",\"ph\":\"" + static_cast<char>(s.phase) + "\"";
+        json += ",\"ts\":" + QByteArray::number(s.startNs / 1000.0, 'f', 3);
+        if (s.phase == Phase::Complete)
+            json += ",\"dur\":" + QByteArray::number(s.durationNs / 1000.0, 'f', 3);
+        else
+            json += ",\"id\":" + QByteArray::number(s.id);
+        json += ",\"pid\":1,\"tid\":" + QByteArray::number(s.threadId) + "}";
+    }
+    json += "\n]}\n";
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly) || file.write(json) != json.size() || !file.commit())
+        return -1;
+    return static_cast<int>(events.size());
+}
+} // namespace Trace
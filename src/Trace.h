@@ -0,0 +1,57 @@
+#pragma once
+
+#include <QString>
+#include <QtGlobal>
+#include <atomic>
+#include <chrono>
+
+// Span tracing for the companion's own activity, exported as Chrome
+// trace-event JSON (open in chrome://tracing or ui.perfetto.dev).
+// Off by default; a disabled TRACE_SCOPE costs one relaxed atomic load.
+namespace Trace
+{
+extern std::atomic<bool> g_enabled;
+
+inline bool isEnabled() { return g_enabled.load(std::memory_order_relaxed); }
+void setEnabled(bool enabled);
+
+inline quint64 nowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+// Event names are stored by pointer: pass string literals.
+void completeEvent(const char *name, quint64 startNs, quint64 endNs);
+
+// Spans that begin and end in different functions, e.g. a save request and
+// the "saved" callback. Matching pairs share name and id.
+void asyncBegin(const char *name, quint64 id);
+void asyncEnd(const char *name, quint64 id);
+
+// Writes the events of the last `seconds` seconds to path. Returns the number
+// of events written, or -1 if the file couldn't be written.
+int exportChromeJson(const QString &path, int seconds);
+
+class Scope
+{
+public:
+    explicit Scope(const char *name) : m_name(name), m_startNs(isEnabled() ? nowNs() : 0) {}
+    ~Scope()
+    {
+        if (m_startNs)
+            completeEvent(m_name, m_startNs, nowNs());
+    }
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+
+private:
+    const char *m_name;
+    quint64 m_startNs;
+};
+} // namespace Trace
+
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) Trace::Scope TRACE_CONCAT(traceScope_, __LINE__)(name)
@@ -0,0 +1,78 @@
+#include "WakeupCounter.h"
+#include "Logger.h"
+#include <QCoreApplication>
+#include <QStringList>
+#include <QTimerEvent>
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+WakeupCounter::WakeupCounter(QObject *parent)
+    : QObject(parent)
+{
+    QCoreApplication::instance()->installEventFilter(this);
+    m_reportTimer = startTimer(kReportIntervalMs);
+    m_window.start();
+}
+
+WakeupCounter::~WakeupCounter()
+{
+    report();
+}
+
+void WakeupCounter::setIdle(bool idle)
+{
+    if (idle == m_idle)
+        return;
+    // Close the window for the state that just ended
+    report();
+    m_idle = idle;
+}
+
+bool WakeupCounter::eventFilter(QObject *watched, QEvent *event)
+{
+    // Our own report timer isn't counted
+    if (watched != this)
+    {
+        if (event->type() == QEvent::Timer)
+        {
+            ++m_timerEvents;
+            ++m_timerReceivers[watched->metaObject()->className()];
+        }
+        else if (event->type() == QEvent::MetaCall)
+        {
+            ++m_queuedCalls;
+        }
+    }
+    return QObject::eventFilter(watched, event);
+}
+
+void WakeupCounter::timerEvent(QTimerEvent *event)
+{
+    if (event->timerId() == m_reportTimer)
+        report();
+}
+
+void WakeupCounter::report()
+{
+    const double seconds = m_window.restart() / 1000.0;
+    if (seconds <= 0.0)
+        return;
+
+    std::vector<std::pair<quint64, QByteArray>> receivers;
+    for (auto it = m_timerReceivers.cbegin(); it != m_timerReceivers.cend(); ++it)
+        receivers.emplace_back(it.value(), it.key());
+    std::sort(receivers.begin(), receivers.end(), [](const auto &a, const auto &b)
+              { return a.first > b.first; });
+    QStringList busiest;
+    for (size_t i = 0; i < std::min<size_t>(receivers.size(), 3); ++i)
+        busiest << QString("%1 %2/s").arg(QString::fromLatin1(receivers[i].second)).arg(receivers[i].first / seconds, 0, 'f', 1);
+
+    LOG_INFO("Wakeups (%1, %2 s): %3 timer events/s, %4 queued calls/s; busiest timers: %5",
+             m_idle ? QString("idle") : QString("active"), seconds, m_timerEvents / seconds, m_queuedCalls / seconds,
+             busiest.isEmpty() ? QString("none") : busiest.join(", "));
+
+    m_timerEvents = 0;
+    m_queuedCalls = 0;
+    m_timerReceivers.clear();
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QObject>
+
+// Measurement harness for idle mode (--measure-wakeups). Watches every event
+// delivered on the GUI thread and counts the ones that wake it on their own:
+// timer events and calls queued from other threads. Rates are logged every
+// ten seconds and whenever the window switches between active and idle, with
+// the objects that received the most timer events.
+class WakeupCounter : public QObject
+{
+    Q_OBJECT
+
+public:
+    // Installs itself on the application; the GUI thread only
+    explicit WakeupCounter(QObject *parent = nullptr);
+    ~WakeupCounter();
+
+public slots:
+    void setIdle(bool idle);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+    void timerEvent(QTimerEvent *event) override;
+
+private:
+    void report();
+
+    static constexpr int kReportIntervalMs = 10000;
+
+    bool m_idle = false;
+    int m_reportTimer = 0;
+    QElapsedTimer m_window;
+    quint64 m_timerEvents = 0;
+    quint64 m_queuedCalls = 0;
+    QHash<QByteArray, quint64> m_timerReceivers; // By class name
+};
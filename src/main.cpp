@@ -1,12 +1,19 @@
 #include <QtWidgets/QApplication>
 #include <QtWidgets/QMessageBox>
 #include <QStyleFactory>
-#include <QTimer>
 #include <QIcon>
+#include <QFileInfo>
 #include <memory>
 #include "MainWindow.h"
 #include "GameCapture.h"
+#include "AppSettings.h"
+#include "ObsControlThread.h"
 #include "Logger.h"
+#include "WakeupCounter.h"
+#include "ObsEventBridge.h"
+#ifdef OBSRC_MINI_UI
+#include "MiniPanel.h"
+#endif
 
 
 // This tells the linker to create a GUI application instead of a console one.
@@ -14,63 +21,202 @@
 #pragma comment(linker, "/SUBSYSTEM:WINDOWS /ENTRY:mainCRTStartup")
 #endif
 
+// Everything the capture needs comes from the stored settings, so it's ready
+// before (and regardless of) any window.
+static void configureCapture(GameCapture &capture, const AppSettings &settings)
+{
+    capture.SetSettings(settings.capture);
+    capture.SetOutputFolder(settings.outputFolder);
+    for (const QString &exe : settings.gameExes) {
+        capture.EnsureDirectoryForGameName(QFileInfo(exe).baseName());
+    }
+    capture.SetBufferDuration(settings.clipLengthSeconds);
+    capture.SetSaveBurstWindow(settings.saveBurstWindowSeconds);
+    capture.SetEncodingSettings(settings.encoding);
+    capture.SetAudioSettings(settings.audio);
+    capture.SetMicrophoneSettings(settings.microphone);
+    capture.SetLoudnessNormalization(settings.normalizeLoudness, settings.targetLoudness);
+}
+
+// Before the event loop runs: a message box with the full UI, the log with
+// the mini panel (there's no QApplication to show one)
+static void showFatalError(const QString &title, const QString &text)
+{
+    if (qobject_cast<QApplication *>(QCoreApplication::instance())) {
+        QMessageBox::critical(nullptr, title, text);
+    } else {
+        LOG_CRITICAL("%1: %2", title, text);
+    }
+}
+
+#ifdef OBSRC_MINI_UI
+// --mini: the nuklear panel instead of MainWindow. --smoke-test only opens
+// it, draws the first frame and closes it again, without initializing OBS.
+static int runMiniPanel(QCoreApplication &app, ObsControlThread &obs, const AppSettings &settings, bool headless, bool smokeTest)
+{
+    MiniPanel panel(&obs, settings, headless);
+    if (!panel.open()) {
+        showFatalError("Initialization Error", "Failed to create the mini panel window.");
+        return 1;
+    }
+    QObject::connect(&panel, &MiniPanel::closed, &app, &QCoreApplication::quit);
+
+    if (smokeTest) {
+        // Queued behind the frame open() asked for
+        QMetaObject::invokeMethod(&app, [&]() {
+            LOG_INFO("Smoke test: %1 frame(s) drawn", panel.framesDrawn());
+            app.exit(panel.framesDrawn() > 0 ? 0 : 1);
+        }, Qt::QueuedConnection);
+        return app.exec();
+    }
+
+    obs.submit([](GameCapture &capture) { return capture.Initialize(); })
+        .then(&panel, [&](bool initialized) {
+        if (!initialized) {
+            showFatalError("OBS Initialization Failed", "Failed to initialize the OBS core.");
+            app.exit(1);
+            return;
+        }
+        const bool autostarted = QCoreApplication::arguments().contains("--autostart");
+        panel.start(autostarted && settings.startClippingAutomatically);
+    });
+
+    return app.exec();
+}
+#endif
+
 int main(int argc, char *argv[])
 {
+    // The log format has to be chosen before the first message is logged.
+    bool measureWakeups = false;
+    bool mini = false;
+    bool headless = false;
+    bool smokeTest = false;
+    for (int i = 1; i < argc; ++i) {
+        if (qstrcmp(argv[i], "--binary-log") == 0) {
+            Logger::setBinaryMode(true);
+        } else if (qstrcmp(argv[i], "--measure-wakeups") == 0) {
+            measureWakeups = true;
+            ObsEventBridge::setStatsLogging(true);
+        } else if (qstrcmp(argv[i], "--mini") == 0) {
+            mini = true;
+        } else if (qstrcmp(argv[i], "--headless") == 0) {
+            headless = true;
+        } else if (qstrcmp(argv[i], "--smoke-test") == 0) {
+            smokeTest = true;
+        }
+    }
+
     // This redirects all qDebug, qWarning, etc. output to our Logger class.
     qInstallMessageHandler(messageHandler);
 
-    QApplication app(argc, argv);
+#ifndef OBSRC_MINI_UI
+    const bool miniUnavailable = mini;
+    mini = false;
+#endif
+
+    // The mini panel draws its own window, so it gets by without Qt's GUI
+    // stack: no platform plugin, style or fonts to load
+    std::unique_ptr<QCoreApplication> app;
+    if (mini) {
+        app = std::make_unique<QCoreApplication>(argc, argv);
+    } else {
+        app = std::make_unique<QApplication>(argc, argv);
+    }
 
-    app.setApplicationName("OBS Replay Companion");
-    app.setApplicationVersion("1.0");
-    app.setOrganizationName("Chirraaa");
-    app.setWindowIcon(QIcon(":/logo.ico"));
-    app.setQuitOnLastWindowClosed(false);
+    app->setApplicationName("OBS Replay Companion");
+    app->setApplicationVersion("1.0");
+    app->setOrganizationName("Chirraaa");
+    if (!mini) {
+        QApplication::setWindowIcon(QIcon(":/logo.ico"));
+        QApplication::setQuitOnLastWindowClosed(false);
 
-    // Apply a consistent modern style
-    app.setStyle(QStyleFactory::create("Fusion"));
+        // Apply a consistent modern style
+        QApplication::setStyle(QStyleFactory::create("Fusion"));
+    }
+
+#ifndef OBSRC_MINI_UI
+    // Only once the application exists: it owns the logger, whose
+    // destruction marks the shutdown as clean
+    if (miniUnavailable) {
+        LOG_WARN("Built without the mini panel (OBSRC_MINI_UI), starting the main window");
+    }
+#endif
+
+#ifdef OBSRC_MINI_UI
+    if (mini && smokeTest) {
+        // Draws one frame and exits. Default settings, and the capture is
+        // never configured or initialized, so the user's settings file and
+        // clip folders are neither read nor written.
+        GameCapture capture;
+        ObsControlThread obs(&capture);
+        return runMiniPanel(*app, obs, AppSettings{}, headless, smokeTest);
+    }
+#endif
+
+    // Logs how often the GUI thread wakes up, active vs. hidden/minimized
+    std::unique_ptr<WakeupCounter> wakeups;
+    if (measureWakeups) {
+        wakeups = std::make_unique<WakeupCounter>();
+    }
 
     std::unique_ptr<GameCapture> capture;
     try {
         capture = std::make_unique<GameCapture>();
     } catch (const std::exception& e) {
-        QMessageBox::critical(nullptr, "Initialization Error",
+        showFatalError("Initialization Error",
             QString("Failed to create GameCapture component: %1").arg(e.what()));
         return 1;
     }
 
+    const AppSettings settings = AppSettings::load();
+    configureCapture(*capture, settings);
+
+    // From here on the capture lives on its own thread and is only driven
+    // through commands. Declared after the capture so it's destroyed first.
+    ObsControlThread obs(capture.get());
+
+#ifdef OBSRC_MINI_UI
+    if (mini) {
+        return runMiniPanel(*app, obs, settings, headless, false);
+    }
+#endif
+
     std::unique_ptr<MainWindow> window;
     try {
-        window = std::make_unique<MainWindow>(capture.get());
+        window = std::make_unique<MainWindow>(&obs, settings);
         window->show();
     } catch (const std::exception& e) {
-        QMessageBox::critical(nullptr, "Initialization Error",
+        showFatalError("Initialization Error",
             QString("Failed to create the main window: %1").arg(e.what()));
         return 1;
     }
 
-    // Initialize OBS after the UI is stable to prevent blocking
-    QTimer::singleShot(1500, [&]() {
-        if (!capture->Initialize()) {
+    if (wakeups) {
+        wakeups->setIdle(window->isIdle());
+        QObject::connect(window.get(), &MainWindow::idleChanged, wakeups.get(), &WakeupCounter::setIdle);
+    }
+
+    // Runs on the control thread, so the window stays responsive meanwhile
+    obs.submit([](GameCapture &capture) { return capture.Initialize(); })
+        .then(window.get(), [&](bool initialized) {
+        if (!initialized) {
             QMessageBox::critical(nullptr, "OBS Initialization Failed",
                 "Failed to initialize the OBS core.\n\n"
                 "This may be due to a missing OBS Studio installation, "
                 "outdated graphics drivers, or another application using capture resources.\n\n"
                 "Please ensure OBS Studio is installed, update your drivers, "
                 "and restart the application.");
-            app.quit();
+            app->quit();
             return;
         }
         window->postInitRefresh();
     });
 
-    int result = app.exec();
-
-    // The capture object is already managed by unique_ptr,
-    // but explicit shutdown can be safer.
-    if (capture) {
-        capture->Shutdown();
-    }
+    int result = app->exec();
 
+    // The window goes first, then the control thread shuts the capture down
+    // on that thread before the unique_ptr deletes it.
+    window.reset();
     return result;
 }
\ No newline at end of file
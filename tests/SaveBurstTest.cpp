@@ -0,0 +1,185 @@
+// Drives merged (burst) saves that fail, and checks that every one ends in
+// recordingFinished(false, ...) instead of leaving the UI on "Saving clip...".
+//
+// Runs OBS's core with audio only. The replay buffer is stood in for by an
+// audio output without a "save" procedure, so the save request itself fails.
+
+#include "GameCapture.h"
+#include <obs.h>
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <cstdio>
+
+namespace
+{
+constexpr const char *kOutputId = "obsrc_test_buffer";
+
+int g_failures = 0;
+
+void check(bool condition, const char *what)
+{
+    std::printf("%s: %s\n", condition ? "PASS" : "FAIL", what);
+    if (!condition)
+        ++g_failures;
+}
+
+const char *outputName(void *)
+{
+    return "Test Buffer";
+}
+
+void *outputCreate(obs_data_t *, obs_output_t *output)
+{
+    return output;
+}
+
+void outputDestroy(void *)
+{
+}
+
+bool outputStart(void *data)
+{
+    return obs_output_begin_data_capture(static_cast<obs_output_t *>(data), 0);
+}
+
+void outputStop(void *data, uint64_t)
+{
+    obs_output_end_data_capture(static_cast<obs_output_t *>(data));
+}
+
+void outputRawAudio(void *, audio_data *)
+{
+}
+
+void registerOutput()
+{
+    obs_output_info info = {};
+    info.id = kOutputId;
+    info.flags = OBS_OUTPUT_AUDIO;
+    info.get_name = outputName;
+    info.create = outputCreate;
+    info.destroy = outputDestroy;
+    info.start = outputStart;
+    info.stop = outputStop;
+    info.raw_audio = outputRawAudio;
+    obs_register_output(&info);
+}
+
+struct SaveCounts
+{
+    int started = 0;
+    int finished = 0;
+    bool lastSuccess = true;
+};
+
+// Spins the event loop until a save finishes or timeoutMs passes
+void waitForFinished(const SaveCounts &saves, int timeoutMs)
+{
+    QElapsedTimer timer;
+    timer.start();
+    while (saves.finished == 0 && timer.elapsed() < timeoutMs)
+        QCoreApplication::processEvents(QEventLoop::AllEvents, 20);
+}
+} // namespace
+
+class SaveBurstTest
+{
+public:
+    // The window runs out and the save request fails
+    static void failedSave()
+    {
+        GameCapture capture;
+        SaveCounts saves;
+        attach(capture, saves);
+        capture.SetSaveBurstWindow(1);
+
+        check(capture.SaveInstantReplay(60), "first request starts a burst");
+        check(capture.SaveInstantReplay(60), "second request is merged into it");
+        waitForFinished(saves, 5000);
+
+        check(saves.started == 1, "failed save: recordingStarted once");
+        check(saves.finished == 1, "failed save: recordingFinished once");
+        check(!saves.lastSuccess, "failed save: reported as failed");
+        check(!capture.IsRecording(), "failed save: no longer recording");
+        detach(capture);
+    }
+
+    // Clipping stops (the session is cancelled) inside the window
+    static void cancelledSave()
+    {
+        GameCapture capture;
+        SaveCounts saves;
+        attach(capture, saves);
+        capture.SetSaveBurstWindow(5);
+
+        check(capture.SaveInstantReplay(60), "request starts a burst");
+        capture.m_sessionOperations.cancel();
+        waitForFinished(saves, 2000);
+
+        check(saves.finished == 1, "cancelled burst: recordingFinished once");
+        check(!saves.lastSuccess, "cancelled burst: reported as failed");
+        check(!capture.IsRecording(), "cancelled burst: no longer recording");
+        check(capture.SaveInstantReplay(60), "a new request is accepted afterwards");
+        saves.finished = 0;
+        capture.m_sessionOperations.cancel();
+        waitForFinished(saves, 2000);
+        detach(capture);
+    }
+
+private:
+    static void attach(GameCapture &capture, SaveCounts &saves)
+    {
+        QObject::connect(&capture, &GameCapture::recordingStarted, [&saves]()
+                         { ++saves.started; });
+        QObject::connect(&capture, &GameCapture::recordingFinished, [&saves](bool success, const QString &)
+                         {
+            ++saves.finished;
+            saves.lastSuccess = success; });
+
+        obs_output_t *output = obs_output_create(kOutputId, "test_buffer", nullptr, nullptr);
+        check(output && obs_output_start(output), "test buffer output starts");
+        capture.m_bufferOutput = output;
+        capture.m_clippingModeActive = true;
+        capture.m_bufferUptime.start();
+    }
+
+    // Hands the output back before the capture shuts down
+    static void detach(GameCapture &capture)
+    {
+        capture.m_clippingModeActive = false;
+        if (capture.m_bufferOutput)
+        {
+            obs_output_stop(capture.m_bufferOutput);
+            obs_output_release(capture.m_bufferOutput);
+            capture.m_bufferOutput = nullptr;
+        }
+    }
+};
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+
+    if (!obs_startup("en-US", nullptr, nullptr))
+    {
+        std::printf("FAIL: obs_startup\n");
+        return 1;
+    }
+    obs_audio_info audio = {};
+    audio.samples_per_sec = 48000;
+    audio.speakers = SPEAKERS_STEREO;
+    if (!obs_reset_audio(&audio))
+    {
+        std::printf("FAIL: obs_reset_audio\n");
+        obs_shutdown();
+        return 1;
+    }
+    registerOutput();
+
+    SaveBurstTest::failedSave();
+    SaveBurstTest::cancelledSave();
+
+    obs_shutdown();
+    std::printf("%d failure(s)\n", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,56 @@
+// Converts an app.binlog written with --binary-log back into the same text
+// lines app.log would have contained.
+//
+// Usage: OBSReplayCompanionLogDecode <app.binlog> [output.txt]
+
+#include "BinaryLog.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QTextStream>
+#include <cstdio>
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+
+    QTextStream err(stderr);
+    if (args.size() < 2) {
+        err << "Usage: " << args.value(0) << " <app.binlog> [output.txt]\n";
+        return 2;
+    }
+
+    QFile input(args.at(1));
+    if (!input.open(QIODevice::ReadOnly)) {
+        err << "Cannot open " << args.at(1) << ": " << input.errorString() << "\n";
+        return 1;
+    }
+    const QByteArray data = input.readAll();
+
+    QFile output;
+    if (args.size() > 2) {
+        output.setFileName(args.at(2));
+        if (!output.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            err << "Cannot open " << args.at(2) << ": " << output.errorString() << "\n";
+            return 1;
+        }
+    } else {
+        output.open(stdout, QIODevice::WriteOnly | QIODevice::Text);
+    }
+
+    QTextStream out(&output);
+    out.setEncoding(QStringConverter::Utf8);
+
+    QString error;
+    const bool ok = BinaryLog::decode(data, [&out](const BinaryLog::DecodedEntry &entry) {
+        out << BinaryLog::formatLine(entry.wallMs, entry.level, entry.text) << "\n";
+    }, &error);
+    out.flush();
+
+    if (!ok) {
+        // A crash can leave a half-written record at the end; everything before it was printed.
+        err << "Decode stopped: " << error << "\n";
+        return 1;
+    }
+    return 0;
+}
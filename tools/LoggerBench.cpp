@@ -0,0 +1,177 @@
+// Producer-side cost of a log call with several threads logging at once: the
+// old synchronous path (format, lock, write, flush per line) against the
+// queue the Logger pushes onto now (encode, MpscQueue push, writer wake-up).
+//
+// Neither path touches the app's log: the old one writes to a temp file, and
+// the queue is drained by a stand-in writer that only pops. The crash ring
+// append Logger::enqueue() also does is not included.
+//
+// Usage: OBSReplayCompanionLoggerBench [calls per thread] [max threads]
+// Defaults: 100000, 8. Thread counts above the core count measure
+// time-slicing, not contention, and are marked as such.
+
+#include "BinaryLog.h"
+#include "Logger.h"
+#include "MpscQueue.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QFile>
+#include <QMutex>
+#include <QStringList>
+#include <QTemporaryDir>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr int kBatchSize = 256; // Logger::kBatchSize
+
+// Runs call(thread, i) on each of `threads` threads, started together, and
+// returns the mean time per call as seen by the callers
+double perCallNs(int threads, int calls, const std::function<void(int, int)> &call)
+{
+    std::atomic<int> ready{0};
+    std::atomic<bool> go{false};
+    std::vector<quint64> elapsed(threads);
+    std::vector<std::thread> workers;
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            ready.fetch_add(1);
+            while (!go.load()) {
+                std::this_thread::yield();
+            }
+            const quint64 start = BinaryLog::monotonicNs();
+            for (int i = 0; i < calls; ++i) {
+                call(t, i);
+            }
+            elapsed[t] = BinaryLog::monotonicNs() - start;
+        });
+    }
+    while (ready.load() < threads) {
+        std::this_thread::yield();
+    }
+    go.store(true);
+    for (std::thread &worker : workers) {
+        worker.join();
+    }
+
+    quint64 total = 0;
+    for (quint64 ns : elapsed) {
+        total += ns;
+    }
+    return static_cast<double>(total) / (static_cast<double>(threads) * calls);
+}
+
+// The logger before the writer thread: every call formats the line, takes
+// the lock, writes and flushes
+double synchronousPath(int threads, int calls, const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        return -1.0;
+    }
+    QTextStream stream(&file);
+    QMutex mutex;
+    return perCallNs(threads, calls, [&](int thread, int i) {
+        const QString line = QString("%1 [%2] %3")
+                                 .arg(QDateTime::currentDateTime().toString("yyyy-MM-dd hh:mm:ss.zzz"))
+                                 .arg(QString("INFO"))
+                                 .arg(QString("Bench thread %1 call %2").arg(thread).arg(i));
+        QMutexLocker locker(&mutex);
+        stream << line << "\n";
+        stream.flush();
+    });
+}
+
+// What Logger::logFormatted() and enqueue() do on the calling thread, with a
+// writer that wakes the same way and drains without formatting
+double queuedPath(int threads, int calls)
+{
+    static const quint16 formatId = BinaryLog::registerFormat("Bench thread %1 call %2");
+
+    MpscQueue<LogRecord> queue;
+    std::atomic<int> pending{0};
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stop = false;
+
+    std::thread writer([&]() {
+        LogRecord record;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait(lock, [&]() { return stop || pending.load() > 0; });
+                if (stop && pending.load() == 0) {
+                    return;
+                }
+            }
+            int drained = 0;
+            while (queue.pop(record)) {
+                ++drained;
+            }
+            pending.fetch_sub(drained);
+        }
+    });
+
+    const double ns = perCallNs(threads, calls, [&](int thread, int i) {
+        LogRecord record;
+        record.type = QtInfoMsg;
+        record.monotonicNs = BinaryLog::monotonicNs();
+        record.formatId = formatId;
+        record.args = BinaryLog::encodeArgs(thread, i);
+        queue.push(std::move(record));
+
+        const int now = pending.fetch_add(1, std::memory_order_acq_rel) + 1;
+        if (now == 1) {
+            { std::lock_guard<std::mutex> lock(wakeMutex); }
+            wake.notify_one();
+        } else if (now == kBatchSize) {
+            wake.notify_one();
+        }
+    });
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stop = true;
+    }
+    wake.notify_one();
+    writer.join();
+    return ns;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const int calls = std::max(1000, args.value(1, "100000").toInt());
+    const int maxThreads = std::max(1, args.value(2, "8").toInt());
+    const int cores = static_cast<int>(std::thread::hardware_concurrency());
+
+    QTextStream out(stdout);
+    QTemporaryDir dir;
+    if (!dir.isValid()) {
+        out << "Couldn't create a temp directory\n";
+        return 1;
+    }
+    const QString fileName = dir.filePath("bench.log");
+
+    out << calls << " calls per thread, " << cores << " hardware thread(s). ns per call:\n";
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        const double synchronous = synchronousPath(threads, calls, fileName);
+        const double queued = queuedPath(threads, calls);
+        out << QString("  %1 thread(s)  synchronous %2  queued %3%4\n")
+                   .arg(threads, 2)
+                   .arg(synchronous, 8, 'f', 0)
+                   .arg(queued, 8, 'f', 0)
+                   .arg(QString(threads > cores ? "  (more threads than cores: not contention)" : ""));
+        out.flush();
+    }
+    return 0;
+}
@@ -0,0 +1,209 @@
+// Per-block cost of the microphone filters: libobs' noise_gate_filter against
+// each noise_suppress_filter method, on synthetic audio (a tone under noise).
+//
+// Each filter sits alone on a private source and is fed 10 ms blocks through
+// obs_source_output_audio(), which runs the filter chain on the calling
+// thread; a run without a filter is the baseline that gets subtracted.
+//
+// Usage: OBSReplayCompanionMicFilterBench [obs-filters module] [module data dir] [blocks]
+// Defaults: obs-plugins/64bit/obs-filters.dll, data/obs-plugins/obs-filters, 3000
+
+#include <obs.h>
+#include <obs-module.h>
+#include <QCoreApplication>
+#include <QList>
+#include <QStringList>
+#include <QTextStream>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <numbers>
+#include <thread>
+#include <vector>
+
+namespace {
+constexpr const char *kSourceId = "obsrc_bench_source";
+constexpr int kBlockMs = 10;
+constexpr int kWarmupMs = 500; // Real time, so a method (and NVIDIA's model) can settle
+
+quint64 nowNs()
+{
+    return static_cast<quint64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now().time_since_epoch())
+                                    .count());
+}
+
+void registerSource()
+{
+    obs_source_info info = {};
+    info.id = kSourceId;
+    info.type = OBS_SOURCE_TYPE_INPUT;
+    info.output_flags = OBS_SOURCE_AUDIO | OBS_SOURCE_CAP_DISABLED;
+    info.get_name = [](void *) { return "Bench Source"; };
+    info.create = [](obs_data_t *, obs_source_t *source) -> void * { return source; };
+    info.destroy = [](void *) {};
+    obs_register_source(&info);
+}
+
+struct Block {
+    std::vector<float> samples;
+    uint64_t position = 0;
+    uint32_t noise = 1;
+};
+
+void push(obs_source_t *source, Block &block, const obs_audio_info &info)
+{
+    const uint32_t frames = info.samples_per_sec * kBlockMs / 1000;
+    block.samples.resize(frames);
+    for (uint32_t i = 0; i < frames; ++i, ++block.position) {
+        block.noise = block.noise * 1664525u + 1013904223u;
+        const float noise = static_cast<float>(block.noise >> 8) / 16777216.0f - 0.5f;
+        const float tone = static_cast<float>(std::sin(2.0 * std::numbers::pi * 220.0 * block.position / info.samples_per_sec));
+        block.samples[i] = 0.3f * tone + 0.1f * noise;
+    }
+
+    obs_source_audio audio = {};
+    for (int channel = 0; channel < get_audio_channels(info.speakers) && channel < MAX_AV_PLANES; ++channel) {
+        audio.data[channel] = reinterpret_cast<const uint8_t *>(block.samples.data());
+    }
+    audio.frames = frames;
+    audio.speakers = info.speakers;
+    audio.format = AUDIO_FORMAT_FLOAT_PLANAR;
+    audio.samples_per_sec = info.samples_per_sec;
+    audio.timestamp = nowNs();
+    obs_source_output_audio(source, &audio);
+}
+
+// The methods this obs-filters build offers; NVIDIA's is listed but
+// disabled without a supported GPU
+QList<QByteArray> suppressionMethods()
+{
+    QList<QByteArray> methods;
+    obs_properties_t *properties = obs_get_source_properties("noise_suppress_filter");
+    if (!properties) {
+        return methods;
+    }
+    if (obs_property_t *method = obs_properties_get(properties, "method")) {
+        for (size_t i = 0; i < obs_property_list_item_count(method); ++i) {
+            if (!obs_property_list_item_disabled(method, i)) {
+                methods.append(obs_property_list_item_string(method, i));
+            }
+        }
+    }
+    obs_properties_destroy(properties);
+    return methods;
+}
+
+struct Timing {
+    double medianNs = 0.0;
+    double p95Ns = 0.0;
+    double meanNs = 0.0;
+};
+
+// filterId empty: no filter, the baseline
+Timing measure(obs_source_t *source, const char *filterId, const char *method, int blocks, const obs_audio_info &info)
+{
+    obs_source_t *filter = nullptr;
+    if (filterId) {
+        obs_data_t *settings = obs_data_create();
+        if (method) {
+            obs_data_set_string(settings, "method", method);
+        }
+        filter = obs_source_create_private(filterId, "Bench Filter", settings);
+        obs_data_release(settings);
+        if (!filter) {
+            return Timing{-1.0, -1.0, -1.0};
+        }
+        obs_source_filter_add(source, filter);
+    }
+
+    Block block;
+    for (int elapsedMs = 0; elapsedMs < kWarmupMs; elapsedMs += kBlockMs) {
+        push(source, block, info);
+        std::this_thread::sleep_for(std::chrono::milliseconds(kBlockMs));
+    }
+
+    std::vector<double> samples;
+    samples.reserve(blocks);
+    for (int i = 0; i < blocks; ++i) {
+        const quint64 before = nowNs();
+        push(source, block, info);
+        samples.push_back(static_cast<double>(nowNs() - before));
+    }
+
+    if (filter) {
+        obs_source_filter_remove(source, filter);
+        obs_source_release(filter);
+    }
+
+    std::sort(samples.begin(), samples.end());
+    Timing timing;
+    timing.medianNs = samples[samples.size() / 2];
+    timing.p95Ns = samples[samples.size() * 95 / 100];
+    for (double ns : samples) {
+        timing.meanNs += ns;
+    }
+    timing.meanNs /= samples.size();
+    return timing;
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    const QStringList args = app.arguments();
+    const QByteArray modulePath = args.value(1, "obs-plugins/64bit/obs-filters.dll").toUtf8();
+    const QByteArray dataPath = args.value(2, "data/obs-plugins/obs-filters").toUtf8();
+    const int blocks = std::max(100, args.value(3, "3000").toInt());
+
+    QTextStream out(stdout);
+    if (!obs_startup("en-US", nullptr, nullptr)) {
+        out << "obs_startup failed\n";
+        return 1;
+    }
+    obs_audio_info info = {};
+    info.samples_per_sec = 48000;
+    info.speakers = SPEAKERS_STEREO; // As OBS mixes, and the app sets it up
+    obs_module_t *module = nullptr;
+    if (!obs_reset_audio(&info) ||
+        obs_open_module(&module, modulePath.constData(), dataPath.constData()) != MODULE_SUCCESS ||
+        !obs_init_module(module)) {
+        out << "Couldn't load " << modulePath << "\n";
+        obs_shutdown();
+        return 1;
+    }
+    registerSource();
+
+    obs_source_t *source = obs_source_create_private(kSourceId, "Bench Source", nullptr);
+    const Timing baseline = measure(source, nullptr, nullptr, blocks, info);
+    const double blockNs = kBlockMs * 1e6;
+
+    out << blocks << " blocks of " << kBlockMs << " ms, stereo 48 kHz. Cost over the "
+        << QString::number(baseline.medianNs / 1000.0, 'f', 1) << " us baseline:\n";
+    auto report = [&](const QString &name, const Timing &timing) {
+        if (timing.medianNs < 0.0) {
+            out << QString("  %1 unavailable\n").arg(name, -28);
+            return;
+        }
+        const double median = std::max(0.0, timing.medianNs - baseline.medianNs);
+        const double p95 = std::max(0.0, timing.p95Ns - baseline.p95Ns);
+        const double mean = std::max(0.0, timing.meanNs - baseline.meanNs);
+        out << QString("  %1 median %2 us  p95 %3 us  mean %4 us  (%5% of a core)\n")
+                   .arg(name, -28)
+                   .arg(median / 1000.0, 8, 'f', 2)
+                   .arg(p95 / 1000.0, 8, 'f', 2)
+                   .arg(mean / 1000.0, 8, 'f', 2)
+                   .arg(mean / blockNs * 100.0, 0, 'f', 3);
+    };
+
+    report("noise_gate_filter", measure(source, "noise_gate_filter", nullptr, blocks, info));
+    for (const QByteArray &method : suppressionMethods()) {
+        report(QString("noise_suppress_filter %1").arg(QString::fromUtf8(method)),
+               measure(source, "noise_suppress_filter", method.constData(), blocks, info));
+    }
+    out.flush();
+
+    obs_source_release(source);
+    obs_shutdown();
+    return 0;
+}